@@ -0,0 +1,186 @@
+// ================================================================================
+// ================================================================================
+// - File:    bench_search.c
+// - Purpose: Compares the energy search layouts of xsec_t over a library
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "../include/library.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define QUERIES 4096
+#define REPEAT 8
+#define NUM_BUCKETS 5
+#define NUM_METHODS 3
+#define MIXED_QUERIES (1 << 22)
+
+static const size_t bucket_limit[NUM_BUCKETS] = {64, 256, 1024, 4096, (size_t)-1};
+static const char* bucket_name[NUM_BUCKETS] = {"< 64", "64 - 255", "256 - 1023",
+                                               "1024 - 4095", ">= 4096"};
+static const char* method_name[NUM_METHODS] = {"binary", "log bins", "eytzinger"};
+// ================================================================================
+// ================================================================================
+
+static double elapsed_ns(const struct timespec* start, const struct timespec* stop) {
+    return (double)(stop->tv_sec - start->tv_sec) * 1.0e9 +
+           (double)(stop->tv_nsec - start->tv_nsec);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Times QUERIES * REPEAT searches of one table and returns the time per search
+ */
+static double time_search(const xsec_t* xsec, const float* energies, size_t* checksum) {
+    struct timespec start, stop;
+    size_t index;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t i = 0; i < QUERIES; i++) {
+            find_xsec_interval(xsec, energies[i], &index);
+            *checksum += index;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    return elapsed_ns(&start, &stop) / (double)(QUERIES * REPEAT);
+}
+// ================================================================================
+// ================================================================================
+
+int main(int argc, const char* argv[]) {
+    const char* directory = argc > 1 ? argv[1] : "../../../../data/xsec/photoat-version.VIII.1";
+    xsec_library_t* library = load_xsec_directory(directory, 0);
+    if (!library || xsec_library_size(library) == 0) {
+        fprintf(stderr, "Unable to load %s\n", directory);
+        if (library) free_xsec_library(library);
+        return 1;
+    }
+    const libraryTable* tables = get_library_tables(library);
+    const size_t num_tables = xsec_library_size(library);
+
+    float* energies = malloc(QUERIES * sizeof(float));
+    if (!energies) {
+        free_xsec_library(library);
+        return 1;
+    }
+    xsec_t** views = calloc(NUM_METHODS * num_tables, sizeof(xsec_t*));
+    size_t* kept = malloc(num_tables * sizeof(size_t));
+    if (!views || !kept) {
+        free(views);
+        free(kept);
+        free(energies);
+        free_xsec_library(library);
+        return 1;
+    }
+    size_t num_kept = 0;
+    double total[NUM_BUCKETS][NUM_METHODS] = {{0.0}};
+    size_t count[NUM_BUCKETS] = {0};
+    size_t points[NUM_BUCKETS] = {0};
+    size_t checksum[NUM_METHODS] = {0};
+    srand(1);
+
+    for (size_t t = 0; t < num_tables; t++) {
+        const xsec_t* table = tables[t].xsec;
+        const size_t len = xsec_size(table);
+        const float* x = get_xsec_enArray(table);
+        // The logarithmic bins need a positive first energy
+        if (len < 2 || !(x[0] > 0.f) || !(x[len - 1] > x[0])) continue;
+
+        // Searches go through views, which own their own search structures
+        xsec_t** view = views + NUM_METHODS * num_kept;
+        for (int m = 0; m < NUM_METHODS; m++)
+            view[m] = init_xsec_view(get_xsec_xsArray(table), x, len);
+        if (!view[0] || !view[1] || !view[2] ||
+            !build_xsec_bins(view[1], len) || !build_xsec_tree(view[2])) {
+            for (int m = 0; m < NUM_METHODS; m++) {
+                if (view[m]) free_xsec(view[m]);
+                view[m] = NULL;
+            }
+            continue;
+        }
+        kept[num_kept++] = t;
+
+        // Energies spread evenly in log(E), as for a slowing down spectrum
+        const float low = logf(x[0]);
+        const float high = logf(x[len - 1]);
+        for (size_t i = 0; i < QUERIES; i++) {
+            const float energy = expf(low + (high - low) * (float)rand() / (float)RAND_MAX);
+            energies[i] = fminf(fmaxf(energy, x[0]), x[len - 1]);
+        }
+
+        size_t bucket = 0;
+        while (len >= bucket_limit[bucket]) bucket++;
+        count[bucket]++;
+        points[bucket] += len;
+        for (int m = 0; m < NUM_METHODS; m++)
+            total[bucket][m] += time_search(view[m], energies, &checksum[m]);
+    }
+
+    // Searches that each go to a random table, as in transport through many
+    // materials, find little of any table in the cache
+    size_t* order = malloc(MIXED_QUERIES * sizeof(size_t));
+    float* mixed = malloc(MIXED_QUERIES * sizeof(float));
+    double mixed_ns[NUM_METHODS] = {0.0};
+    if (order && mixed && num_kept > 0) {
+        for (size_t i = 0; i < MIXED_QUERIES; i++) {
+            order[i] = (size_t)rand() % num_kept;
+            const xsec_t* table = tables[kept[order[i]]].xsec;
+            const float* x = get_xsec_enArray(table);
+            const float low = logf(x[0]);
+            const float high = logf(x[xsec_size(table) - 1]);
+            const float energy = expf(low + (high - low) * (float)rand() / (float)RAND_MAX);
+            mixed[i] = fminf(fmaxf(energy, x[0]), x[xsec_size(table) - 1]);
+        }
+        for (int m = 0; m < NUM_METHODS; m++) {
+            struct timespec start, stop;
+            size_t index;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (size_t i = 0; i < MIXED_QUERIES; i++) {
+                find_xsec_interval(views[NUM_METHODS * order[i] + m], mixed[i], &index);
+                checksum[m] += index;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &stop);
+            mixed_ns[m] = elapsed_ns(&start, &stop) / (double)MIXED_QUERIES;
+        }
+    }
+
+    printf("%zu tables from %zu files, %d searches per table\n\n",
+           num_tables, xsec_library_files(library), QUERIES * REPEAT);
+    printf("%-12s %7s %9s", "points", "tables", "mean len");
+    for (int m = 0; m < NUM_METHODS; m++) printf(" %12s", method_name[m]);
+    printf("\n");
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+        if (count[b] == 0) continue;
+        printf("%-12s %7zu %9zu", bucket_name[b], count[b], points[b] / count[b]);
+        for (int m = 0; m < NUM_METHODS; m++)
+            printf(" %9.1f ns", total[b][m] / (double)count[b]);
+        printf("\n");
+    }
+    printf("%-12s %7zu %9s", "random table", num_kept, "");
+    for (int m = 0; m < NUM_METHODS; m++) printf(" %9.1f ns", mixed_ns[m]);
+    printf("\n");
+    if (checksum[0] != checksum[1] || checksum[0] != checksum[2])
+        fprintf(stderr, "Search layouts disagree\n");
+
+    for (size_t i = 0; i < NUM_METHODS * num_kept; i++) free_xsec(views[i]);
+    free(views);
+    free(kept);
+    free(order);
+    free(mixed);
+    free(energies);
+    free_xsec_library(library);
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+// eof
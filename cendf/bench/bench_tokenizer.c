@@ -0,0 +1,187 @@
+// ================================================================================
+// ================================================================================
+// - File:    bench_tokenizer.c
+// - Purpose: Compares the ENDF tokenizer against strtod and sscanf
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "../include/read_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIELD_WIDTH 11
+#define REPEAT 200
+// ================================================================================
+// ================================================================================
+
+static double elapsed_ns(const struct timespec* start, const struct timespec* stop) {
+    return (double)(stop->tv_sec - start->tv_sec) * 1.0e9 +
+           (double)(stop->tv_nsec - start->tv_nsec);
+}
+// --------------------------------------------------------------------------------
+
+static char* read_whole_file(const char* file_name, size_t* length) {
+    FILE* file = fopen(file_name, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = malloc((size_t)size + 1);
+    if (!data || fread(data, 1, (size_t)size, file) != (size_t)size) {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    data[size] = '\0';
+    fclose(file);
+    *length = (size_t)size;
+    return data;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Locates the data records of MF23/MT501, skipping the HEAD, control and
+ * interpolation records, and returns the number of data records.
+ */
+static size_t find_mt501_block(const char* data, size_t length, const char** start) {
+    const char* rec = data;
+    const char* end = data + length;
+    size_t skipped = 0, count = 0;
+    *start = NULL;
+    while (rec < end) {
+        const char* eol = memchr(rec, '\n', (size_t)(end - rec));
+        const char* next = eol ? eol + 1 : end;
+        if (next - rec > 75 && strncmp(rec + 70, "23501", 5) == 0) {
+            if (skipped < 3) {
+                skipped++;
+            } else {
+                if (!*start) *start = rec;
+                count++;
+            }
+        }
+        rec = next;
+    }
+    return count;
+}
+// --------------------------------------------------------------------------------
+
+static void report(const char* name, double ns, size_t records, size_t bytes, double checksum) {
+    double per_record = ns / (double)(records * REPEAT);
+    double mb_per_s = (double)(bytes * REPEAT) / ns * 1.0e3;
+    printf("%-26s %10.1f ns/record %10.1f MB/s   (checksum %.6e)\n",
+           name, per_record, mb_per_s, checksum);
+}
+// ================================================================================
+// ================================================================================
+
+int main(int argc, const char* argv[]) {
+    const char* file_name = argc > 1 ? argv[1] : "../../../../data/test/photoat-047_Ag_000.endf";
+    size_t length;
+    char* data = read_whole_file(file_name, &length);
+    if (!data) {
+        fprintf(stderr, "Unable to read %s\n", file_name);
+        return 1;
+    }
+
+    const char* block;
+    size_t records = find_mt501_block(data, length, &block);
+    if (records == 0) {
+        fprintf(stderr, "MF23/MT501 not found in %s\n", file_name);
+        free(data);
+        return 1;
+    }
+    const char* last = block;
+    for (size_t i = 0; i < records; i++) last = strchr(last, '\n') + 1;
+    size_t bytes = (size_t)(last - block);
+
+    double* values = malloc(sizeof(double) * 6 * records);
+    if (!values) {
+        free(data);
+        return 1;
+    }
+    printf("MF23/MT501: %zu records, %zu bytes, %d repetitions\n\n", records, bytes, REPEAT);
+
+    struct timespec start, stop;
+    double checksum;
+
+    // Batch tokenizer
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEAT; r++) {
+        if (parse_endf_records(block, bytes, records, values) != records) {
+            fprintf(stderr, "parse_endf_records failed\n");
+            free(values);
+            free(data);
+            return 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    checksum = 0.0;
+    for (size_t i = 0; i < 6 * records; i++) checksum += values[i];
+    report("parse_endf_records", elapsed_ns(&start, &stop), records, bytes, checksum);
+
+    // Single record tokenizer
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEAT; r++) {
+        const char* rec = block;
+        for (size_t i = 0; i < records; i++) {
+            parse_endf_record(rec, values + 6 * i);
+            rec = strchr(rec, '\n') + 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    checksum = 0.0;
+    for (size_t i = 0; i < 6 * records; i++) checksum += values[i];
+    report("parse_endf_record", elapsed_ns(&start, &stop), records, bytes, checksum);
+
+    // strtod on each field copied into a null terminated buffer
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEAT; r++) {
+        const char* rec = block;
+        char field[FIELD_WIDTH + 1];
+        for (size_t i = 0; i < records; i++) {
+            for (int j = 0; j < 6; j++) {
+                memcpy(field, rec + j * FIELD_WIDTH, FIELD_WIDTH);
+                field[FIELD_WIDTH] = '\0';
+                values[6 * i + j] = strtod(field, NULL);
+            }
+            rec = strchr(rec, '\n') + 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    checksum = 0.0;
+    for (size_t i = 0; i < 6 * records; i++) checksum += values[i];
+    report("strtod", elapsed_ns(&start, &stop), records, bytes, checksum);
+
+    // sscanf with fixed field widths
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEAT; r++) {
+        const char* rec = block;
+        for (size_t i = 0; i < records; i++) {
+            double* v = values + 6 * i;
+            v[4] = v[5] = 0.0;
+            sscanf(rec, "%11lf%11lf%11lf%11lf%11lf%11lf", v, v + 1, v + 2, v + 3, v + 4, v + 5);
+            rec = strchr(rec, '\n') + 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    checksum = 0.0;
+    for (size_t i = 0; i < 6 * records; i++) checksum += values[i];
+    report("sscanf", elapsed_ns(&start, &stop), records, bytes, checksum);
+
+    free(values);
+    free(data);
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,642 @@
+// ================================================================================
+// ================================================================================
+// - File:    cache.c
+// - Purpose: Binary cache of parsed cross section tables
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/cache.h"
+#include "include/read_file.h"
+#include "interp_laws.h"
+
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define XSEC_CACHE_MAGIC "CENDFBIN"
+#define XSEC_CACHE_VERSION 2
+#define XSEC_CACHE_BYTE_ORDER 0x01020304u
+#define XSEC_CACHE_ALIGNMENT 64
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+// ================================================================================
+// ================================================================================
+// CACHE FILE LAYOUT
+//
+// A cache file is a 64 byte header, followed by the energy and cross section
+// arrays of every table, followed by the table of contents.  Every array and
+// the table of contents start on a 64 byte boundary, and since the file is
+// mapped at a page boundary the arrays are 64 byte aligned in memory as well.
+// The header checksum covers the header and the table of contents, and each
+// table of contents entry holds the checksum of its own arrays.  All fields
+// are written in the byte order of the host, which is checked on loading.
+// Tables that are not lin-lin throughout also store their NR interpolation
+// ranges, as NR 64 bit NBT values followed by NR 32 bit INT values.
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t num_tables;
+    uint64_t toc_offset;
+    uint64_t file_size;
+    uint64_t checksum;
+    uint8_t reserved[16];
+} cache_header;
+_Static_assert(sizeof(cache_header) == XSEC_CACHE_ALIGNMENT, "cache_header must be 64 bytes");
+
+typedef struct {
+    float za;
+    float awr;
+    int32_t mat;
+    int32_t mf;
+    int32_t mt;
+    uint32_t nr;
+    uint64_t np;
+    uint64_t energy_offset;
+    uint64_t xs_offset;
+    uint64_t checksum;
+    uint64_t interp_offset;
+} cache_entry;
+_Static_assert(sizeof(cache_entry) == XSEC_CACHE_ALIGNMENT, "cache_entry must be 64 bytes");
+// --------------------------------------------------------------------------------
+
+/*
+ * 64 bit FNV-1a hash.  The hash is chained through `hash`, so several blocks
+ * of memory can be combined into one checksum.
+ */
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t bytes) {
+    const unsigned char* ptr = data;
+    for (size_t i = 0; i < bytes; i++) {
+        hash ^= ptr[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+// --------------------------------------------------------------------------------
+
+static uint64_t header_checksum(const cache_header* header, const void* toc, size_t toc_bytes) {
+    cache_header copy = *header;
+    copy.checksum = 0;
+    uint64_t hash = fnv1a(FNV_OFFSET_BASIS, &copy, sizeof(copy));
+    return fnv1a(hash, toc, toc_bytes);
+}
+// ================================================================================
+// ================================================================================
+// CACHE WRITER
+
+typedef struct {
+    float za;
+    size_t file;
+} material_order;
+// --------------------------------------------------------------------------------
+
+static int compare_materials(const void* a, const void* b) {
+    const material_order* ma = a;
+    const material_order* mb = b;
+    if (ma->za < mb->za) return -1;
+    if (ma->za > mb->za) return 1;
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int compare_sections(const void* a, const void* b) {
+    const endfSection* sa = a;
+    const endfSection* sb = b;
+    if (sa->mf != sb->mf) return sa->mf < sb->mf ? -1 : 1;
+    if (sa->mt != sb->mt) return sa->mt < sb->mt ? -1 : 1;
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Pads the file with zeros up to the next 64 byte boundary and returns the
+ * new offset.
+ */
+static bool pad_file(FILE* file, uint64_t* offset) {
+    static const char zeros[XSEC_CACHE_ALIGNMENT] = {0};
+    size_t pad = (size_t)((XSEC_CACHE_ALIGNMENT - *offset % XSEC_CACHE_ALIGNMENT) %
+                          XSEC_CACHE_ALIGNMENT);
+    if (pad > 0 && fwrite(zeros, 1, pad, file) != pad) return false;
+    *offset += pad;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool write_array(FILE* file, const float* data, size_t len, uint64_t* offset) {
+    if (!pad_file(file, offset)) return false;
+    if (fwrite(data, sizeof(float), len, file) != len) return false;
+    *offset += len * sizeof(float);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static uint64_t ranges_bytes(uint64_t nr) {
+    return nr * (sizeof(uint64_t) + sizeof(int32_t));
+}
+// --------------------------------------------------------------------------------
+
+static bool write_ranges(FILE* file, const size_t* nbt, const int* law, size_t nr,
+                         uint64_t* offset) {
+    if (!pad_file(file, offset)) return false;
+    for (size_t i = 0; i < nr; i++) {
+        uint64_t value = nbt[i];
+        if (fwrite(&value, sizeof(value), 1, file) != 1) return false;
+    }
+    for (size_t i = 0; i < nr; i++) {
+        int32_t value = law[i];
+        if (fwrite(&value, sizeof(value), 1, file) != 1) return false;
+    }
+    *offset += ranges_bytes(nr);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static uint64_t table_checksum(const char* data, const cache_entry* entry) {
+    const size_t bytes = (size_t)entry->np * sizeof(float);
+    uint64_t hash = fnv1a(FNV_OFFSET_BASIS, data + entry->energy_offset, bytes);
+    hash = fnv1a(hash, data + entry->xs_offset, bytes);
+    if (entry->nr > 0)
+        hash = fnv1a(hash, data + entry->interp_offset, (size_t)ranges_bytes(entry->nr));
+    return hash;
+}
+// --------------------------------------------------------------------------------
+
+static bool append_entry(cache_entry** toc, size_t* len, size_t* alloc, cache_entry entry) {
+    if (*len == *alloc) {
+        size_t new_alloc = *alloc == 0 ? 64 : 2 * *alloc;
+        cache_entry* ptr = realloc(*toc, new_alloc * sizeof(cache_entry));
+        if (!ptr) return false;
+        *toc = ptr;
+        *alloc = new_alloc;
+    }
+    (*toc)[(*len)++] = entry;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Writes every TAB1 table of one ENDF file.  Tables are streamed to the file
+ * one at a time, so the memory used does not depend on the size of the
+ * library.
+ */
+static bool write_material(FILE* file, const char* file_name, uint64_t* offset,
+                           cache_entry** toc, size_t* len, size_t* alloc) {
+    endf_index_t* index = read_endf_index(file_name);
+    if (!index) return false;
+
+    const size_t num_sections = endf_index_size(index);
+    endfSection* sections = malloc(num_sections * sizeof(endfSection));
+    if (!sections) {
+        free_endf_index(index);
+        errno = ENOMEM;
+        return false;
+    }
+    memcpy(sections, get_endf_sections(index), num_sections * sizeof(endfSection));
+    qsort(sections, num_sections, sizeof(endfSection), compare_sections);
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < num_sections; i++) {
+        size_t np;
+        float emin, emax;
+        if (sections[i].mf == 1 ||
+            !read_tab1_range(index, sections[i].mf, sections[i].mt, &np, &emin, &emax))
+            continue;
+        xsec_t* xsec = read_indexed_xsec(index, sections[i].mf, sections[i].mt);
+        if (!xsec) {
+            ok = false;
+            break;
+        }
+        const size_t points = xsec_size(xsec);
+        const float* energy = get_xsec_enArray(xsec);
+        const float* xs = get_xsec_xsArray(xsec);
+        cache_entry entry = {
+            .za = endf_index_za(index),
+            .awr = endf_index_awr(index),
+            .mat = endf_index_mat(index),
+            .mf = sections[i].mf,
+            .mt = sections[i].mt,
+            .np = points
+        };
+        ok = write_array(file, energy, points, offset);
+        entry.energy_offset = *offset - points * sizeof(float);
+        ok = ok && write_array(file, xs, points, offset);
+        entry.xs_offset = *offset - points * sizeof(float);
+        entry.checksum = fnv1a(fnv1a(FNV_OFFSET_BASIS, energy, points * sizeof(float)),
+                               xs, points * sizeof(float));
+        const size_t* nbt;
+        const int* law;
+        entry.nr = (uint32_t)get_xsec_interpolation(xsec, &nbt, &law);
+        if (ok && entry.nr > 0) {
+            ok = write_ranges(file, nbt, law, entry.nr, offset);
+            entry.interp_offset = *offset - ranges_bytes(entry.nr);
+            for (size_t j = 0; j < entry.nr; j++) {
+                uint64_t value = nbt[j];
+                entry.checksum = fnv1a(entry.checksum, &value, sizeof(value));
+            }
+            for (size_t j = 0; j < entry.nr; j++) {
+                int32_t value = law[j];
+                entry.checksum = fnv1a(entry.checksum, &value, sizeof(value));
+            }
+        }
+        free_xsec(xsec);
+        if (ok && !append_entry(toc, len, alloc, entry)) {
+            errno = ENOMEM;
+            ok = false;
+        } else if (!ok) {
+            errno = EIO;
+        }
+    }
+    free(sections);
+    free_endf_index(index);
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Orders the files by ZA from their MF1/MT451 directories, which are cheap to
+ * read, so that the tables are written in sorted order in a single pass.
+ */
+static material_order* order_materials(const char* const* file_names, size_t num_files) {
+    material_order* order = malloc(num_files * sizeof(material_order));
+    if (!order) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (size_t i = 0; i < num_files; i++) {
+        endf_index_t* index = read_endf_index(file_names[i]);
+        if (!index) {
+            free(order);
+            return NULL;
+        }
+        order[i] = (material_order){ .za = endf_index_za(index), .file = i };
+        free_endf_index(index);
+    }
+    qsort(order, num_files, sizeof(material_order), compare_materials);
+    for (size_t i = 1; i < num_files; i++) {
+        if (order[i].za == order[i - 1].za) {
+            free(order);
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+    return order;
+}
+// --------------------------------------------------------------------------------
+
+bool write_xsec_cache(const char* cache_file, const char* const* file_names, size_t num_files) {
+    if (!cache_file || !file_names || num_files == 0) {
+        CENDF_REPORT(EINVAL, "Invalid arguments passed to write_xsec_cache");
+        return false;
+    }
+    material_order* order = order_materials(file_names, num_files);
+    if (!order) {
+        CENDF_REPORT(errno, "Unable to order materials for %s: %s", cache_file, strerror(errno));
+        return false;
+    }
+
+    // Write to a temporary file so that readers never see a partial cache
+    char* tmp_name = malloc(strlen(cache_file) + 32);
+    FILE* file = NULL;
+    if (tmp_name) {
+        sprintf(tmp_name, "%s.tmp.%ld", cache_file, (long)getpid());
+        file = fopen(tmp_name, "wb");
+    }
+    if (!file) {
+        free(tmp_name);
+        free(order);
+        CENDF_REPORT(EIO, "Unable to write cache file %s", cache_file);
+        return false;
+    }
+
+    cache_header header = {
+        .version = XSEC_CACHE_VERSION,
+        .byte_order = XSEC_CACHE_BYTE_ORDER
+    };
+    memcpy(header.magic, XSEC_CACHE_MAGIC, sizeof(header.magic));
+    cache_entry* toc = NULL;
+    size_t len = 0;
+    size_t alloc = 0;
+    uint64_t offset = sizeof(cache_header);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (size_t i = 0; ok && i < num_files; i++)
+        ok = write_material(file, file_names[order[i].file], &offset, &toc, &len, &alloc);
+    int error = errno;
+    if (ok && len == 0) {
+        ok = false;
+        error = ENODATA;
+    }
+    if (ok) {
+        ok = pad_file(file, &offset);
+        header.num_tables = len;
+        header.toc_offset = offset;
+        header.file_size = offset + len * sizeof(cache_entry);
+        header.checksum = header_checksum(&header, toc, len * sizeof(cache_entry));
+        ok = ok && fwrite(toc, sizeof(cache_entry), len, file) == len;
+        ok = ok && fseek(file, 0, SEEK_SET) == 0;
+        ok = ok && fwrite(&header, sizeof(header), 1, file) == 1;
+        if (!ok) error = EIO;
+    }
+    if (fclose(file) != 0 && ok) {
+        ok = false;
+        error = EIO;
+    }
+    if (ok && rename(tmp_name, cache_file) != 0) {
+        ok = false;
+        error = EIO;
+    }
+    if (!ok) {
+        remove(tmp_name);
+        CENDF_REPORT(error, "Unable to write cache file %s: %s", cache_file, strerror(error));
+    }
+    free(tmp_name);
+    free(toc);
+    free(order);
+    return ok;
+}
+// ================================================================================
+// ================================================================================
+// CACHE LOADER
+
+struct xsec_cache_t {
+    const char* data;
+    size_t size;
+    cacheTable* tables;
+    size_t len;
+};
+// --------------------------------------------------------------------------------
+
+static const cache_entry* cache_toc(const xsec_cache_t* cache) {
+    cache_header header;
+    memcpy(&header, cache->data, sizeof(header));
+    return (const cache_entry*)(cache->data + header.toc_offset);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Checks the bounds of the interpolation ranges of a table and the stored
+ * values: NBT must increase to NP and every INT must be a known law.  The
+ * size of the ranges is compared with the offset before it is subtracted,
+ * since NR may be as large as NP and the ranges larger than the data region.
+ */
+static bool validate_ranges(const char* data, uint64_t toc_offset, const cache_entry* entry) {
+    const uint64_t nr = entry->nr;
+    if (nr == 0) return true;
+    const uint64_t bytes = ranges_bytes(nr);
+    if (nr > entry->np || entry->interp_offset % XSEC_CACHE_ALIGNMENT != 0 ||
+        bytes > toc_offset || entry->interp_offset > toc_offset - bytes)
+        return false;
+
+    const char* ptr = data + entry->interp_offset;
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < nr; i++) {
+        uint64_t nbt;
+        memcpy(&nbt, ptr + i * sizeof(uint64_t), sizeof(nbt));
+        if (nbt <= previous || nbt > entry->np) return false;
+        previous = nbt;
+    }
+    if (previous != entry->np) return false;
+    ptr += nr * sizeof(uint64_t);
+    for (uint64_t i = 0; i < nr; i++) {
+        int32_t law;
+        memcpy(&law, ptr + i * sizeof(int32_t), sizeof(law));
+        if (law < INTERP_HISTOGRAM || law > INTERP_LOG_LOG) return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Checks the header, the table of contents, the bounds and alignment of
+ * every array and the interpolation ranges.  The float arrays themselves are
+ * not read.
+ */
+static bool validate_cache(const char* data, size_t size) {
+    if (size < sizeof(cache_header)) return false;
+    const cache_header* header = (const cache_header*)data;
+    if (memcmp(header->magic, XSEC_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != XSEC_CACHE_VERSION ||
+        header->byte_order != XSEC_CACHE_BYTE_ORDER ||
+        header->file_size != size ||
+        header->toc_offset % XSEC_CACHE_ALIGNMENT != 0 ||
+        header->toc_offset > size ||
+        header->num_tables == 0 ||
+        header->num_tables > (size - header->toc_offset) / sizeof(cache_entry))
+        return false;
+
+    const cache_entry* toc = (const cache_entry*)(data + header->toc_offset);
+    const size_t toc_bytes = header->num_tables * sizeof(cache_entry);
+    if (header_checksum(header, toc, toc_bytes) != header->checksum) return false;
+
+    for (uint64_t i = 0; i < header->num_tables; i++) {
+        const cache_entry* entry = &toc[i];
+        const uint64_t bytes = entry->np * sizeof(float);
+        if (entry->np == 0 || entry->np > header->toc_offset / sizeof(float) ||
+            entry->energy_offset % XSEC_CACHE_ALIGNMENT != 0 ||
+            entry->xs_offset % XSEC_CACHE_ALIGNMENT != 0 ||
+            entry->energy_offset > header->toc_offset - bytes ||
+            entry->xs_offset > header->toc_offset - bytes)
+            return false;
+        if (!validate_ranges(data, header->toc_offset, entry)) return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Applies the stored interpolation ranges of a table to its view.  Only
+ * tables that are not lin-lin throughout have ranges, so most views skip
+ * this step.
+ */
+static bool set_view_ranges(const char* data, const cache_entry* entry, xsec_t* view) {
+    const size_t nr = entry->nr;
+    size_t* nbt = malloc(nr * sizeof(size_t));
+    int* law = malloc(nr * sizeof(int));
+    bool ok = nbt && law;
+    if (ok) {
+        const char* ptr = data + entry->interp_offset;
+        for (size_t i = 0; i < nr; i++) {
+            uint64_t value;
+            memcpy(&value, ptr + i * sizeof(uint64_t), sizeof(value));
+            nbt[i] = (size_t)value;
+        }
+        ptr += nr * sizeof(uint64_t);
+        for (size_t i = 0; i < nr; i++) {
+            int32_t value;
+            memcpy(&value, ptr + i * sizeof(int32_t), sizeof(value));
+            law[i] = value;
+        }
+        ok = set_xsec_interpolation(view, nbt, law, nr);
+    } else {
+        errno = ENOMEM;
+    }
+    free(nbt);
+    free(law);
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+xsec_cache_t* open_xsec_cache(const char* cache_file) {
+    if (!cache_file) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to open_xsec_cache");
+        return NULL;
+    }
+    int fd = open(cache_file, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        if (fd >= 0) close(fd);
+        CENDF_REPORT(ENOENT, "Unable to open cache file %s", cache_file);
+        return NULL;
+    }
+    const size_t size = (size_t)st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        CENDF_REPORT(ENOENT, "Unable to map cache file %s", cache_file);
+        return NULL;
+    }
+    if (!validate_cache(data, size)) {
+        munmap(data, size);
+        CENDF_REPORT(EINVAL, "Invalid cache file %s", cache_file);
+        return NULL;
+    }
+
+    xsec_cache_t* cache = malloc(sizeof(xsec_cache_t));
+    const cache_header* header = data;
+    const size_t len = (size_t)header->num_tables;
+    cacheTable* tables = cache ? calloc(len, sizeof(cacheTable)) : NULL;
+    if (!tables) {
+        free(cache);
+        munmap(data, size);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for cache file %s", cache_file);
+        return NULL;
+    }
+    cache->data = data;
+    cache->size = size;
+    cache->tables = tables;
+    cache->len = len;
+
+    const cache_entry* toc = cache_toc(cache);
+    for (size_t i = 0; i < len; i++) {
+        const float* energy = (const float*)(cache->data + toc[i].energy_offset);
+        const float* xs = (const float*)(cache->data + toc[i].xs_offset);
+        xsec_t* view = init_xsec_view(xs, energy, (size_t)toc[i].np);
+        if (view && toc[i].nr > 0 && !set_view_ranges(cache->data, &toc[i], view)) {
+            free_xsec(view);
+            view = NULL;
+        }
+        if (!view) {
+            int error = errno;
+            cache->len = i;
+            free_xsec_cache(cache);
+            CENDF_REPORT(error, "Unable to load tables of cache file %s", cache_file);
+            return NULL;
+        }
+        tables[i] = (cacheTable){
+            .za = toc[i].za,
+            .awr = toc[i].awr,
+            .mat = toc[i].mat,
+            .mf = toc[i].mf,
+            .mt = toc[i].mt,
+            .xsec = view
+        };
+    }
+    return cache;
+}
+// --------------------------------------------------------------------------------
+
+bool verify_xsec_cache(const xsec_cache_t* cache) {
+    if (!cache) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to verify_xsec_cache");
+        return false;
+    }
+    const cache_entry* toc = cache_toc(cache);
+    for (size_t i = 0; i < cache->len; i++) {
+        if (table_checksum(cache->data, &toc[i]) != toc[i].checksum) {
+            CENDF_REPORT(EINVAL, "Checksum mismatch in cached table MF%d/MT%d of ZA %g",
+                         toc[i].mf, toc[i].mt, toc[i].za);
+            return false;
+        }
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t xsec_cache_size(const xsec_cache_t* cache) {
+    if (!cache) {
+        errno = EINVAL;
+        return 0;
+    }
+    return cache->len;
+}
+// --------------------------------------------------------------------------------
+
+const cacheTable* get_cache_tables(const xsec_cache_t* cache) {
+    if (!cache) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return cache->tables;
+}
+// --------------------------------------------------------------------------------
+
+static int compare_key(const cacheTable* table, int z, int mf, int mt) {
+    int table_z = (int)(table->za / 1000.0f);
+    if (table_z != z) return table_z < z ? -1 : 1;
+    if (table->mf != mf) return table->mf < mf ? -1 : 1;
+    if (table->mt != mt) return table->mt < mt ? -1 : 1;
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+const xsec_t* get_cached_xsec(const xsec_cache_t* cache, int z, int mf, int mt) {
+    if (!cache) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to get_cached_xsec");
+        return NULL;
+    }
+    // Tables are sorted by ZA, MF and MT
+    size_t low = 0;
+    size_t high = cache->len;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (compare_key(&cache->tables[mid], z, mf, mt) < 0) low = mid + 1;
+        else high = mid;
+    }
+    if (low < cache->len && compare_key(&cache->tables[low], z, mf, mt) == 0)
+        return cache->tables[low].xsec;
+    errno = ENODATA;
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+void free_xsec_cache(xsec_cache_t* cache) {
+    if (!cache) return;
+    for (size_t i = 0; i < cache->len; i++)
+        free_xsec((xsec_t*)cache->tables[i].xsec);
+    free(cache->tables);
+    munmap((void*)cache->data, cache->size);
+    free(cache);
+}
+// --------------------------------------------------------------------------------
+
+void _free_xsec_cache(xsec_cache_t** cache) {
+    if (cache && *cache) {
+        free_xsec_cache(*cache);
+        *cache = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,131 @@
+// ================================================================================
+// ================================================================================
+// - File:    diagnostics.c
+// - Purpose: Status codes, the last error of a thread and the error log
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/diagnostics.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+// ================================================================================
+// ================================================================================
+// ERROR LOG
+
+/*
+ * The handler and its pointer are only read and written under the lock, so a
+ * handler is never called with the pointer of another.  The rate limit is
+ * checked with atomics before the lock is taken, so errors that are dropped
+ * never wait on it.  The limit counts errors within one second of the
+ * monotonic clock.
+ */
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static cendfLogHandler log_handler = cendf_stderr_log;
+static void* log_user = NULL;
+static atomic_size_t log_rate = CENDF_LOG_RATE;
+static atomic_llong log_window = -1;
+static atomic_size_t log_count = 0;
+static atomic_size_t log_suppressed = 0;
+
+static _Thread_local cendfError last_error = {0};
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns true if an error may be logged within the current second.
+ */
+static bool log_permitted(void) {
+    const size_t limit = atomic_load_explicit(&log_rate, memory_order_relaxed);
+    if (limit == 0) return true;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long window = atomic_load_explicit(&log_window, memory_order_relaxed);
+    // The thread that opens a new second resets the count for it
+    if (window != (long long)now.tv_sec &&
+        atomic_compare_exchange_strong(&log_window, &window, (long long)now.tv_sec))
+        atomic_store(&log_count, 0);
+    return atomic_fetch_add(&log_count, 1) < limit;
+}
+// ================================================================================
+// ================================================================================
+
+void cendf_set_log_handler(cendfLogHandler handler, void* user) {
+    pthread_mutex_lock(&log_lock);
+    log_handler = handler;
+    log_user = user;
+    pthread_mutex_unlock(&log_lock);
+}
+// --------------------------------------------------------------------------------
+
+void cendf_stderr_log(const cendfError* error, size_t suppressed, void* user) {
+    (void) user;
+    if (suppressed > 0)
+        fprintf(stderr, "%zu earlier errors were not logged\n", suppressed);
+    fprintf(stderr, "%s\n", error->message);
+}
+// --------------------------------------------------------------------------------
+
+void cendf_set_log_rate(size_t messages_per_second) {
+    atomic_store(&log_rate, messages_per_second);
+    atomic_store(&log_count, 0);
+}
+// --------------------------------------------------------------------------------
+
+const cendfError* cendf_last_error(void) {
+    return &last_error;
+}
+// --------------------------------------------------------------------------------
+
+void cendf_clear_error(void) {
+    last_error.code = 0;
+    last_error.function = NULL;
+    last_error.message[0] = '\0';
+}
+// --------------------------------------------------------------------------------
+
+const char* cendf_status_string(cendfStatus status) {
+    switch (status) {
+        case CENDF_STATUS_OK: return "Success";
+        case CENDF_STATUS_INVALID: return "Invalid argument";
+        case CENDF_STATUS_RANGE: return "Value out of range";
+        case CENDF_STATUS_NO_MEMORY: return "Out of memory";
+        case CENDF_STATUS_NO_DATA: return "No data available";
+        case CENDF_STATUS_NOT_PERMITTED: return "Operation not permitted";
+        default: return "Unknown status";
+    }
+}
+// --------------------------------------------------------------------------------
+
+void cendf_report(int code, const char* function, const char* format, ...) {
+    last_error.code = code;
+    last_error.function = function;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(last_error.message, CENDF_MESSAGE_SIZE, format, args);
+    va_end(args);
+
+    if (log_permitted()) {
+        pthread_mutex_lock(&log_lock);
+        if (log_handler)
+            log_handler(&last_error, atomic_exchange(&log_suppressed, 0), log_user);
+        pthread_mutex_unlock(&log_lock);
+    } else {
+        atomic_fetch_add_explicit(&log_suppressed, 1, memory_order_relaxed);
+    }
+    // Set last, since the handler may change errno
+    errno = code;
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -13,6 +13,7 @@
 // Include modules here
 
 #include "include/dstructures.h"
+#include "interp_laws.h"
 
 #include <errno.h>
 #include <linux/limits.h>
@@ -20,45 +21,393 @@
 #include <stdio.h>
 #include <limits.h>
 #include <float.h>
+#include <math.h>
+#include <stdint.h>
 #include <jansson.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define XSEC_BATCH_X86
+    #include <immintrin.h>
+#endif
+
 const float LOAD_FACTOR_THRESHOLD = 0.7;
-static const size_t XSEC_THRESHOLD = 1 * 1024 * 1024;  // 1 MB
-static const size_t XSEC_FIXED_AMOUNT = 1 * 1024 * 1024;  // 1 MB
-                                                          
 static const size_t hashSize = 3;  //  Size fo hash map initi functions
 // ================================================================================
 // ================================================================================
+// TAB1 INTERPOLATION LAWS
+
+/*
+ * Interpolation ranges of a table.  Range i covers the intervals that end at
+ * or before the 1-based point nbt[i].  A table without ranges is lin-lin
+ * throughout.  For the logarithmic laws the slope of every interval is
+ * computed once in double precision, so an evaluation needs at most one log
+ * and one exp.  Intervals that a logarithmic law can not represent, such as
+ * those with a zero end point, hold NAN and are interpolated lin-lin.
+ */
+typedef struct {
+    size_t* nbt;
+    int* law;
+    size_t nr;
+    float* slope;
+} interp_ranges;
+// --------------------------------------------------------------------------------
+
+static void free_interp_ranges(interp_ranges* interp) {
+    free(interp->nbt);
+    free(interp->law);
+    free(interp->slope);
+    *interp = (interp_ranges){0};
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Validates and copies the ranges of a table of `len` points.  Tables that
+ * are lin-lin throughout are stored without ranges.
+ */
+static bool build_interp_ranges(interp_ranges* interp, const float* x, const float* y,
+                                size_t len, const size_t* nbt, const int* law, size_t nr) {
+    bool linear, logarithmic;
+    if (!check_interp_ranges(nbt, law, nr, len, &linear, &logarithmic)) {
+        errno = EINVAL;
+        return false;
+    }
+    free_interp_ranges(interp);
+    if (linear) return true;
+
+    interp->nbt = malloc(nr * sizeof(size_t));
+    interp->law = malloc(nr * sizeof(int));
+    interp->slope = logarithmic && len > 1 ? malloc((len - 1) * sizeof(float)) : NULL;
+    if (!interp->nbt || !interp->law || (logarithmic && len > 1 && !interp->slope)) {
+        free_interp_ranges(interp);
+        errno = ENOMEM;
+        return false;
+    }
+    memcpy(interp->nbt, nbt, nr * sizeof(size_t));
+    memcpy(interp->law, law, nr * sizeof(int));
+    interp->nr = nr;
+    if (interp->slope) {
+        size_t range = 0;
+        for (size_t i = 0; i + 1 < len; i++) {
+            while (nbt[range] < i + 2) range++;
+            interp->slope[i] = (float)interval_slope(law[range], x[i], x[i + 1], y[i], y[i + 1]);
+        }
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Evaluates the interval between points `lower` and `lower + 1`.
+ */
+static inline float interp_interval(const interp_ranges* interp, const float* x,
+                                    const float* y, size_t lower, float value) {
+    const float X1 = x[lower];
+    const float X2 = x[lower + 1];
+    const float Y1 = y[lower];
+    const float Y2 = y[lower + 1];
+    int law = INTERP_LIN_LIN;
+    if (interp->nr > 0) {
+        // The ranges hold 1-based point numbers, so interval `lower` ends at lower + 2
+        size_t range = 0;
+        while (range + 1 < interp->nr && interp->nbt[range] < lower + 2) range++;
+        law = interp->law[range];
+    }
+    if (law == INTERP_HISTOGRAM) return Y1;
+    if (law != INTERP_LIN_LIN) {
+        const float slope = interp->slope[lower];
+        if (!isnan(slope)) {
+            if (law == INTERP_LIN_LOG) return Y1 + slope * logf(value / X1);
+            if (law == INTERP_LOG_LIN) return Y1 * expf(slope * (value - X1));
+            return Y1 * expf(slope * logf(value / X1));
+        }
+    }
+    return Y1 + (Y2 - Y1) * (value - X1) / (X2 - X1);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Evaluates interval `lower` as found by a search for the last point at or
+ * below `value`.  Only the last interval can end at `value`, at the final
+ * point or at a repeated energy, which takes the value above the edge; the
+ * point is returned exactly rather than interpolated.
+ */
+static inline float table_value(const interp_ranges* interp, const float* x, const float* y,
+                                size_t lower, float value) {
+    if (value == x[lower + 1]) return y[lower + 1];
+    return interp_interval(interp, x, y, lower, value);
+}
+// ================================================================================
+// ================================================================================
+// LOGARITHMIC SEARCH BINS
+
+/*
+ * Equal-width bins in the log of the energy.  Bin b covers the energies whose
+ * `log_bin` is b, and the interval holding any such energy starts at a point
+ * between start[b] and start[b + 1], so a lookup searches only that window.
+ * start has num_bins + 1 entries.  A table without bins has num_bins == 0.
+ */
+typedef struct {
+    uint32_t* start;
+    size_t num_bins;
+    float log_min;
+    float scale;
+} log_bins;
+// --------------------------------------------------------------------------------
+
+static void free_log_bins(log_bins* bins) {
+    free(bins->start);
+    *bins = (log_bins){0};
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t log_bin(const log_bins* bins, float value) {
+    const float position = (logf(value) - bins->log_min) * bins->scale;
+    if (!(position > 0.f)) return 0;
+    const size_t bin = (size_t)position;
+    return bin < bins->num_bins ? bin : bins->num_bins - 1;
+}
+// --------------------------------------------------------------------------------
+
+static bool build_log_bins(log_bins* bins, const float* x, size_t len, size_t num_bins) {
+    if (num_bins == 0 || len < 2 || len > UINT32_MAX || !(x[0] > 0.f) || !(x[len - 1] > x[0])) {
+        errno = EINVAL;
+        return false;
+    }
+    uint32_t* start = malloc((num_bins + 1) * sizeof(uint32_t));
+    if (!start) {
+        errno = ENOMEM;
+        return false;
+    }
+    free_log_bins(bins);
+    bins->start = start;
+    bins->num_bins = num_bins;
+    bins->log_min = logf(x[0]);
+    bins->scale = (float)num_bins / (logf(x[len - 1]) - bins->log_min);
+
+    // start[b] is the last point that lies in a bin below b, since the
+    // interval of the lowest energy in bin b may begin there
+    size_t i = 0;
+    for (size_t b = 0; b <= num_bins; b++) {
+        while (i < len && log_bin(bins, x[i]) < b) i++;
+        start[b] = (uint32_t)(i > 0 ? i - 1 : 0);
+    }
+    start[num_bins] = (uint32_t)(len - 1);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Narrows the search for `value`, which must lie within the table, to the
+ * points [*first, *last].  The window is checked, so a log that rounds an
+ * energy into the neighbouring bin falls back to the whole table.
+ */
+static inline void log_bin_window(const log_bins* bins, const float* x, size_t len,
+                                  float value, size_t* first, size_t* last) {
+    *first = 0;
+    *last = len - 1;
+    if (bins->num_bins == 0) return;
+    const size_t bin = log_bin(bins, value);
+    const size_t low = bins->start[bin];
+    const size_t high = bins->start[bin + 1] + 1 < len ? bins->start[bin + 1] + 1 : len - 1;
+    if (x[low] <= value && value <= x[high]) {
+        *first = low;
+        *last = high;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the last point of the window [first, last] at or below `value`,
+ * limited to len - 2, for a value within the window of a table of at least
+ * two points.  An energy repeated at an edge belongs to the interval above
+ * it, as it does for every other search of a table.
+ */
+static inline size_t window_lower(const float* x, size_t len, size_t first, size_t last,
+                                  float value) {
+    size_t low = first, high = last;
+    while (high - low > 1) {
+        const size_t mid = low + (high - low) / 2;
+        if (x[mid] <= value) low = mid;
+        else high = mid;
+    }
+    while (low + 2 < len && x[low + 1] <= value) low++;
+    return low;
+}
+// ================================================================================
+// ================================================================================
+// EYTZINGER SEARCH TREE
+
+/*
+ * A copy of the energies in the breadth-first order of a complete binary
+ * search tree, one-based so that the children of node k are 2k and 2k + 1.
+ * The first levels of the tree, which every search visits, share a few cache
+ * lines, and the sixteen descendants of a node four levels down are adjacent,
+ * so they are fetched one cache line ahead of the search.  The tree has full
+ * levels down to depth - 1 and `last` nodes at `depth`.  A table without a
+ * tree has len == 0.
+ */
+typedef struct {
+    float* key;
+    size_t len;
+    size_t last;
+    int depth;
+} search_tree;
+
+// The number of floats in a cache line, the fan out of four tree levels
+#define TREE_LINE 16
+// --------------------------------------------------------------------------------
+
+static void free_search_tree(search_tree* tree) {
+    free(tree->key);
+    *tree = (search_tree){0};
+}
+// --------------------------------------------------------------------------------
+
+static inline int floor_log2(size_t k) {
+#if defined(__GNUC__) || defined (__clang__)
+    return 63 - __builtin_clzll((unsigned long long)k);
+#else
+    int bits = 0;
+    while (k >>= 1) bits++;
+    return bits;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the position in the table of node k.  In a tree whose last level
+ * were full, node k at depth d would be in-order position p, counting the
+ * nodes of the last level, which take the even positions.  Only the first
+ * `last` of those nodes exist, so the missing ones are not counted.
+ */
+static inline size_t search_tree_rank(const search_tree* tree, size_t k) {
+    const int d = floor_log2(k);
+    const size_t p = ((2 * (k - ((size_t)1 << d)) + 1) << (tree->depth - d)) - 1;
+    const size_t leaves = (p + 1) / 2;
+    return p / 2 + (leaves < tree->last ? leaves : tree->last);
+}
+// --------------------------------------------------------------------------------
+
+static size_t fill_search_tree(search_tree* tree, const float* x, size_t i, size_t k) {
+    // An in-order traversal of the tree visits the energies in ascending order
+    if (k <= tree->len) {
+        i = fill_search_tree(tree, x, i, 2 * k);
+        tree->key[k] = x[i];
+        i = fill_search_tree(tree, x, i + 1, 2 * k + 1);
+    }
+    return i;
+}
+// --------------------------------------------------------------------------------
+
+static bool build_search_tree(search_tree* tree, const float* x, size_t len) {
+    if (len < 2) {
+        errno = EINVAL;
+        return false;
+    }
+    // Aligned so that each group of sixteen descendants fills one cache line
+    const size_t bytes = ((len + 1) * sizeof(float) + 63) / 64 * 64;
+    float* key = aligned_alloc(64, bytes);
+    if (!key) {
+        errno = ENOMEM;
+        return false;
+    }
+    free_search_tree(tree);
+    tree->key = key;
+    tree->len = len;
+    tree->depth = floor_log2(len);
+    tree->last = len - (((size_t)1 << tree->depth) - 1);
+    key[0] = NAN;
+    fill_search_tree(tree, x, 0, 1);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the last point at or below `value`, limited to len - 2, for a value
+ * within the table.  The descent is branchless: each step moves to the right
+ * child when the node is at or below the value.  The node of the first point
+ * above the value is then the last ancestor entered through a left child.
+ */
+static inline size_t search_tree_lower(const search_tree* tree, float value) {
+    size_t k = 1;
+    while (k <= tree->len) {
+#if defined(__GNUC__) || defined (__clang__)
+        __builtin_prefetch(tree->key + TREE_LINE * k);
+#endif
+        k = 2 * k + (tree->key[k] <= value);
+    }
+    // Strip the right turns taken after the last left turn, and that left turn
+#if defined(__GNUC__) || defined (__clang__)
+    k >>= __builtin_ffsll((long long)~k);
+#else
+    while (k & 1) k >>= 1;
+    k >>= 1;
+#endif
+    const size_t upper = k == 0 ? tree->len : search_tree_rank(tree, k);
+    return upper - 1 < tree->len - 2 ? upper - 1 : tree->len - 2;
+}
+// ================================================================================
+// ================================================================================
 // XSEC_T DATA TYPE 
 
+/*
+ * One point of a packed table: its energy and cross section, and the slope of
+ * the interval that starts at it.  Records are sixteen bytes and the array is
+ * aligned to a cache line, so a record never straddles two lines.
+ */
+typedef struct {
+    float energy;
+    float xs;
+    float slope;
+    float pad;
+} xsec_record;
+
 // define xsec_t
 struct xsec_t {
     float* xs;
     float* energy;
     size_t len; 
     size_t alloc;
+    bool read_only;
+    interp_ranges interp;
+    log_bins bins;
+    search_tree tree;
+    xsec_record* packed;
 };
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the last point at or below `energy`, limited to len - 2, for an
+ * energy within a table of at least two points, with the fastest search the
+ * table has been given.
+ */
+static inline size_t xsec_lower(const xsec_t* cross_section, float energy) {
+    if (cross_section->tree.len > 0)
+        return search_tree_lower(&cross_section->tree, energy);
+    const float* x = cross_section->energy;
+    const size_t len = cross_section->len;
+    size_t first, last;
+    log_bin_window(&cross_section->bins, x, len, energy, &first, &last);
+    return window_lower(x, len, first, last, energy);
+}
 // -------------------------------------------------------------------------------- 
 
 xsec_t* init_xsec(size_t buffer_length) {
     xsec_t *struct_ptr = malloc(sizeof(xsec_t));
     if (struct_ptr == NULL) {
-        errno = ENOMEM;
-        fprintf(stderr, "xsec allocation failed with error %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "xsec allocation failed with error %s", strerror(ENOMEM));
         return NULL;
     }
 
     float *xsec_ptr = malloc(sizeof(float) * buffer_length);
     if (xsec_ptr == NULL) {
-        errno = ENOMEM;
-        fprintf(stderr, "xsec allocation failed with error %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "xsec allocation failed with error %s", strerror(ENOMEM));
         free(struct_ptr);
         return NULL;
     }
     float *energy_ptr = malloc(sizeof(float) * buffer_length);
     if (energy_ptr == NULL) {
-        errno = ENOMEM;
-        fprintf(stderr, "xsec allocation failed with error %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "xsec allocation failed with error %s", strerror(ENOMEM));
         free(struct_ptr);
         free(xsec_ptr);
         return NULL;
@@ -67,16 +416,60 @@ xsec_t* init_xsec(size_t buffer_length) {
     struct_ptr->energy = energy_ptr;
     struct_ptr->len = 0;
     struct_ptr->alloc = buffer_length;
+    struct_ptr->read_only = false;
+    struct_ptr->interp = (interp_ranges){0};
+    struct_ptr->bins = (log_bins){0};
+    struct_ptr->tree = (search_tree){0};
+    struct_ptr->packed = NULL;
+    return struct_ptr;
+}
+// --------------------------------------------------------------------------------
+
+xsec_t* init_xsec_view(const float* xs, const float* energy, size_t len) {
+    if (!xs || !energy) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to init_xsec_view");
+        return NULL;
+    }
+    xsec_t *struct_ptr = malloc(sizeof(xsec_t));
+    if (struct_ptr == NULL) {
+        CENDF_REPORT(ENOMEM, "xsec allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    // The arrays are only read through a view, so casting away const is safe
+    struct_ptr->xs = (float*)xs;
+    struct_ptr->energy = (float*)energy;
+    struct_ptr->len = len;
+    struct_ptr->alloc = len;
+    struct_ptr->read_only = true;
+    struct_ptr->interp = (interp_ranges){0};
+    struct_ptr->bins = (log_bins){0};
+    struct_ptr->tree = (search_tree){0};
+    struct_ptr->packed = NULL;
     return struct_ptr;
 }
 // --------------------------------------------------------------------------------
 
 bool push_xsec(xsec_t* cross_section, float xsec, float energy) {
     if (!cross_section || !cross_section->xs || !cross_section->energy) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid cross_section passed to push_xsec function\n");
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to push_xsec function");
         return false;
     }
+    if (cross_section->read_only) {
+        CENDF_REPORT(EPERM, "Read-only cross_section passed to push_xsec function");
+        return false;
+    }
+    if (cross_section->interp.nr > 0) {
+        CENDF_REPORT(EPERM, "Cross section with interpolation ranges passed to push_xsec function");
+        return false;
+    }
+    if (cross_section->packed) {
+        CENDF_REPORT(EPERM, "Packed cross_section passed to push_xsec function");
+        return false;
+    }
+
+    // The search structures only describe the energies they were built from
+    free_log_bins(&cross_section->bins);
+    free_search_tree(&cross_section->tree);
 
     // Check if reallocation is needed
     if (cross_section->alloc <= cross_section->len) {
@@ -90,16 +483,14 @@ bool push_xsec(xsec_t* cross_section, float xsec, float energy) {
         // Attempt to reallocate the cross-section array
         float* new_xs = realloc(cross_section->xs, new_alloc * sizeof(float));
         if (!new_xs) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate xs in push_xsec\n");
+            CENDF_REPORT(ENOMEM, "Failed to reallocate xs in push_xsec");
             return false;
         }
 
         // Attempt to reallocate the energy array
         float* new_energy = realloc(cross_section->energy, new_alloc * sizeof(float));
         if (!new_energy) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate energy in push_xsec\n");
+            CENDF_REPORT(ENOMEM, "Failed to reallocate energy in push_xsec");
             free(new_xs);  // Free successfully reallocated xs to prevent memory leak
             return false;
         }
@@ -121,13 +512,11 @@ bool push_xsec(xsec_t* cross_section, float xsec, float energy) {
 
 static bool validate_xsec(const xsec_t* cross_section, size_t index) {
     if (!cross_section || !cross_section->xs || !cross_section->energy) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid cross_section passed to function\n");
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to function");
         return false;
     }
     if (index >= cross_section->len) {
-        errno = EINVAL;
-        fprintf(stderr, "Index %zu out of bounds (len: %zu)\n", index, cross_section->len);
+        CENDF_REPORT(EINVAL, "Index %zu out of bounds (len: %zu)", index, cross_section->len);
         return false;
     }
     return true;
@@ -143,6 +532,16 @@ const float get_xsec(const xsec_t* cross_section, size_t index) {
 }
 // --------------------------------------------------------------------------------
 
+const float get_xsec_status(const xsec_t* cross_section, size_t index, cendfStatus* status) {
+    if (!cross_section || !cross_section->xs || index >= cross_section->len) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return -1.0f;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    return cross_section->xs[index];
+}
+// --------------------------------------------------------------------------------
+
 const float get_xsec_energy(const xsec_t* cross_section, size_t index) {
     if (!validate_xsec(cross_section, index)) {
         return -1.0f;  // Or define a constant for invalid value
@@ -151,10 +550,20 @@ const float get_xsec_energy(const xsec_t* cross_section, size_t index) {
 }
 // --------------------------------------------------------------------------------
 
+const float get_xsec_energy_status(const xsec_t* cross_section, size_t index,
+                                   cendfStatus* status) {
+    if (!cross_section || !cross_section->energy || index >= cross_section->len) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return -1.0f;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    return cross_section->energy[index];
+}
+// --------------------------------------------------------------------------------
+
 const float* get_xsec_xsArray(const xsec_t* xsec) {
     if (!xsec || !xsec->xs) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to xesc_t or arrays in get_xsec_xsArray\n");
+        CENDF_REPORT(EINVAL, "Null pointer to xesc_t or arrays in get_xsec_xsArray");
         return NULL;
     }
     return xsec->xs;
@@ -163,8 +572,7 @@ const float* get_xsec_xsArray(const xsec_t* xsec) {
 
 const float* get_xsec_enArray(const xsec_t* xsec) {
     if (!xsec || !xsec->xs) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to xesc_t or arrays in get_xsec_xsArray\n");
+        CENDF_REPORT(EINVAL, "Null pointer to xesc_t or arrays in get_xsec_xsArray");
         return NULL;
     }
     return xsec->energy;
@@ -182,79 +590,442 @@ const xsecData get_xsec_data(const xsec_t* cross_section, size_t index) {
 }
 // --------------------------------------------------------------------------------
 
-static bool find_indices(const float *array, size_t size, float value, 
-                        size_t *lower, size_t *upper) {
-    size_t low = 0, high = size - 1;
-
-    if (value < array[low]) {
-        *lower = 0;
-        *upper = 1;
+/*
+ * Interpolation in a table of ascending x values.  This is the lookup shared
+ * by every tabulated data type; it returns false and sets errno to ERANGE
+ * when `value` lies outside of the table.  When `bins` is not NULL the
+ * search is limited to the window of the bin that holds `value`.  A repeated
+ * energy takes the value above the edge.
+ */
+static bool interp_table(const interp_ranges* interp, const log_bins* bins, const float* x,
+                         const float* y, size_t len, float value, float* result) {
+    // Checked here rather than through errno, which may hold an earlier ERANGE
+    if (!(value >= x[0] && value <= x[len - 1])) {
         errno = ERANGE;
-        return false; // Below range
+        return false;
     }
-    if (value > array[high]) {
-        *lower = high - 1;
-        *upper = high;
-        errno = ERANGE;
-        return false; // Above range
+    if (len < 2) {
+        *result = y[0];
+        return true;
     }
+    size_t first = 0, last = len - 1;
+    if (bins) log_bin_window(bins, x, len, value, &first, &last);
+    *result = table_value(interp, x, y, window_lower(x, len, first, last, value), value);
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    while (low <= high) {
-        size_t mid = low + (high - low) / 2;
-
-        if (array[mid] == value) {
-            *lower = *upper = mid;
-            return true; // Exact match found
-        } else if (array[mid] < value) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
+const float interp_xsec_status(const xsec_t* xsec, float energy, cendfStatus* status) {
+    if (!xsec || !xsec->xs || !xsec->energy || xsec->len == 0) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return -1.0f;
+    }
+    const float* x = xsec->energy;
+    if (!(energy >= x[0] && energy <= x[xsec->len - 1])) {
+        cendf_set_status(status, CENDF_STATUS_RANGE);
+        return -1.0f;
     }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    if (xsec->packed) {
+        // Compilers may fuse this into one multiply-add where the target has one
+        const xsec_record record = xsec->packed[xsec_lower(xsec, energy)];
+        return record.xs + record.slope * (energy - record.energy);
+    }
+    if (xsec->tree.len > 0)
+        return table_value(&xsec->interp, x, xsec->xs, search_tree_lower(&xsec->tree, energy), energy);
 
-    *lower = high;
-    *upper = low;
-    return false; // Value lies between lower and upper
+    // The energy is known to be in range, so the search can not fail
+    float result;
+    interp_table(&xsec->interp, &xsec->bins, x, xsec->xs, xsec->len, energy, &result);
+    return result;
 }
 // --------------------------------------------------------------------------------
 
 const float interp_xsec(const xsec_t *xsec, float energy) {
-    if (!xsec || !xsec->xs || !xsec->energy) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer passed to inter_xsec function\n");
+    cendfStatus status;
+    const float result = interp_xsec_status(xsec, energy, &status);
+    if (status == CENDF_STATUS_INVALID) {
+        if (xsec && xsec->xs && xsec->energy)
+            CENDF_REPORT(EINVAL, "xsec_t data type not populated with data");
+        else
+            CENDF_REPORT(EINVAL, "Null pointer passed to inter_xsec function");
+    } else if (status == CENDF_STATUS_RANGE) {
+        CENDF_REPORT(ERANGE, "Energy %g is out of bounds for cross section database", energy);
+    }
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the last point at or below `energy`, limited to len - 2, starting
+ * from the interval `hint`.  The search steps away from the hint by 1, 2, 4,
+ * ... points until it brackets the energy and then bisects the bracket, so an
+ * energy k intervals away costs about 2 log2(k) probes, and one in the same
+ * interval costs two.
+ */
+static inline size_t gallop_lower(const float* x, size_t len, size_t hint, float energy) {
+    size_t low, high;
+    size_t step = 1;
+    if (hint > len - 2) hint = len - 2;
+    // The bracket keeps x[low] <= energy and x[high] > energy, or high == len - 1
+    if (x[hint] <= energy) {
+        low = hint;
+        high = hint + 1;
+        while (high < len - 1 && x[high] <= energy) {
+            low = high;
+            step *= 2;
+            high = low + step < len - 1 ? low + step : len - 1;
+        }
+    } else {
+        high = hint;
+        low = hint - 1;
+        while (x[low] > energy) {
+            high = low;
+            step *= 2;
+            low = high > step ? high - step : 0;
+        }
+    }
+    while (high - low > 1) {
+        const size_t mid = low + (high - low) / 2;
+        if (x[mid] <= energy) low = mid;
+        else high = mid;
+    }
+    // An energy repeated at an edge belongs to the interval above it
+    while (low + 2 < len && x[low + 1] <= energy) low++;
+    return low;
+}
+// --------------------------------------------------------------------------------
+
+const float interp_xsec_hint_status(const xsec_t* cross_section, float energy, xsecHint* hint,
+                                   cendfStatus* status) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy || !hint) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
         return -1.0f;
     }
+    const float* x = cross_section->energy;
+    const size_t len = cross_section->len;
+    if (len < 2 || !(energy >= x[0] && energy <= x[len - 1]))
+        return interp_xsec_status(cross_section, energy, status);
+    cendf_set_status(status, CENDF_STATUS_OK);
 
-    if (xsec->len == 0) {
-        errno = EINVAL;
-        fprintf(stderr, "xsec_t data type not populated with data\n");
+    // A hint from another table starts from a full search
+    size_t lower;
+    if (hint->table == cross_section) {
+        lower = gallop_lower(x, len, hint->index, energy);
+    } else {
+        lower = xsec_lower(cross_section, energy);
+        hint->table = cross_section;
+    }
+    hint->index = lower;
+    if (cross_section->packed) {
+        const xsec_record record = cross_section->packed[lower];
+        return record.xs + record.slope * (energy - record.energy);
+    }
+    return table_value(&cross_section->interp, x, cross_section->xs, lower, energy);
+}
+// --------------------------------------------------------------------------------
+
+const float interp_xsec_hint(const xsec_t* cross_section, float energy, xsecHint* hint) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy || !hint) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_xsec_hint function");
         return -1.0f;
     }
+    cendfStatus status;
+    const float result = interp_xsec_hint_status(cross_section, energy, hint, &status);
+    // Tables of a single point and energies out of range are reported as by interp_xsec
+    if (status != CENDF_STATUS_OK) return interp_xsec(cross_section, energy);
+    return result;
+}
+// --------------------------------------------------------------------------------
 
-    size_t lower, upper;
+bool set_xsec_interpolation(xsec_t* cross_section, const size_t* nbt, const int* law,
+                            size_t nr) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to set_xsec_interpolation");
+        return false;
+    }
+    if (cross_section->packed) {
+        CENDF_REPORT(EPERM, "Packed cross_section passed to set_xsec_interpolation");
+        return false;
+    }
+    if (!build_interp_ranges(&cross_section->interp, cross_section->energy, cross_section->xs,
+                             cross_section->len, nbt, law, nr)) {
+        CENDF_REPORT(errno, "Unable to set interpolation ranges: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    if (find_indices(xsec->energy, xsec->len, energy, &lower, &upper)) {
-        return xsec->xs[lower]; // Exact match
+size_t get_xsec_interpolation(const xsec_t* cross_section, const size_t** nbt, const int** law) {
+    if (!cross_section) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to get_xsec_interpolation");
+        return 0;
     }
-    if (errno == ERANGE) {
-        fprintf(stderr, "Energy is out of bounds for cross section database\n");
-        return -1.0f;
+    if (nbt) *nbt = cross_section->interp.nbt;
+    if (law) *law = cross_section->interp.law;
+    return cross_section->interp.nr;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * The value at `value` of the chord from point i to point j under `law`,
+ * evaluated as interp_interval would evaluate it were i and j neighbours.
+ */
+static double chord_value(int law, const float* x, const float* y, size_t i, size_t j,
+                          double value) {
+    const double x1 = x[i], x2 = x[j], y1 = y[i], y2 = y[j];
+    if (law == INTERP_HISTOGRAM) return y1;
+    if (law != INTERP_LIN_LIN) {
+        const double slope = interval_slope(law, x1, x2, y1, y2);
+        if (!isnan(slope)) {
+            if (law == INTERP_LIN_LOG) return y1 + slope * log(value / x1);
+            if (law == INTERP_LOG_LIN) return y1 * exp(slope * (value - x1));
+            return y1 * exp(slope * log(value / x1));
+        }
+    }
+    return y1 + (y2 - y1) * (value - x1) / (x2 - x1);
+}
+// --------------------------------------------------------------------------------
+
+static bool chord_fits(int law, const float* x, const float* y, size_t i, size_t j,
+                       double tolerance) {
+    for (size_t k = i + 1; k < j; k++) {
+        if (!(fabs(chord_value(law, x, y, i, j, x[k]) - y[k]) <= tolerance * fabs(y[k])))
+            return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the farthest point up to `end` that a chord from point i can reach.
+ * The chord is doubled until it fails and the last doubling is bisected, so
+ * a run of n points costs O(n log n) evaluations rather than O(n^2).
+ */
+static size_t farthest_chord(int law, const float* x, const float* y, size_t i, size_t end,
+                             double tolerance) {
+    size_t good = i + 1;
+    size_t bad = end + 1;
+    for (size_t span = 2; good < end; span *= 2) {
+        const size_t next = end - i > span ? i + span : end;
+        if (!chord_fits(law, x, y, i, next, tolerance)) {
+            bad = next;
+            break;
+        }
+        good = next;
+    }
+    while (bad - good > 1) {
+        const size_t mid = good + (bad - good) / 2;
+        if (chord_fits(law, x, y, i, mid, tolerance)) good = mid;
+        else bad = mid;
+    }
+    return good;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns true for the points that thinning must keep: the ends of the table,
+ * both points of a repeated energy and the last point of each range.
+ */
+static inline bool fixed_point(const float* x, size_t len, const interp_ranges* interp,
+                               size_t range, size_t k) {
+    if (k == 0 || k + 1 == len) return true;
+    if (x[k] == x[k - 1] || x[k] == x[k + 1]) return true;
+    return range < interp->nr && interp->nbt[range] == k + 1;
+}
+// --------------------------------------------------------------------------------
+
+bool thin_xsec(xsec_t* cross_section, float tolerance, size_t* removed) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy || !(tolerance >= 0.0f)) {
+        CENDF_REPORT(EINVAL, "Invalid arguments passed to thin_xsec");
+        return false;
+    }
+    if (cross_section->read_only || cross_section->packed) {
+        CENDF_REPORT(EPERM, "Read-only or packed cross_section passed to thin_xsec");
+        return false;
+    }
+    const float* x = cross_section->energy;
+    const float* y = cross_section->xs;
+    const size_t len = cross_section->len;
+    const interp_ranges* interp = &cross_section->interp;
+    if (removed) *removed = 0;
+    if (len < 3) return true;
+
+    // The points kept are chosen first, so the table is only replaced once
+    // every allocation has succeeded
+    size_t* kept = malloc(len * sizeof(size_t));
+    size_t* nbt = interp->nr > 0 ? malloc(interp->nr * sizeof(size_t)) : NULL;
+    if (!kept || (interp->nr > 0 && !nbt)) {
+        free(kept);
+        free(nbt);
+        CENDF_REPORT(ENOMEM, "thin_xsec allocation failed with error %s", strerror(ENOMEM));
+        return false;
+    }
+    size_t count = 0;
+    size_t range = 0;
+    kept[count++] = 0;
+    for (size_t start = 0; start + 1 < len;) {
+        // Runs between fixed points lie within one range
+        while (range < interp->nr && interp->nbt[range] < start + 2) range++;
+        const int law = range < interp->nr ? interp->law[range] : INTERP_LIN_LIN;
+        size_t end = start + 1;
+        while (!fixed_point(x, len, interp, range, end)) end++;
+        for (size_t i = start; i < end;) {
+            i = farthest_chord(law, x, y, i, end, tolerance);
+            kept[count++] = i;
+        }
+        start = end;
+    }
+    // The last point of every range is kept, so each range ends at a kept point
+    for (size_t r = 0, k = 0; r < interp->nr; r++) {
+        while (kept[k] + 1 < interp->nbt[r]) k++;
+        nbt[r] = k + 1;
+    }
+
+    float* energy = malloc(count * sizeof(float));
+    float* xs = malloc(count * sizeof(float));
+    interp_ranges ranges = {0};
+    bool ok = energy && xs;
+    if (ok) {
+        for (size_t k = 0; k < count; k++) {
+            energy[k] = x[kept[k]];
+            xs[k] = y[kept[k]];
+        }
+        if (interp->nr > 0)
+            ok = build_interp_ranges(&ranges, energy, xs, count, nbt, interp->law, interp->nr);
+    }
+    free(kept);
+    free(nbt);
+    if (!ok) {
+        free(energy);
+        free(xs);
+        CENDF_REPORT(ENOMEM, "thin_xsec allocation failed with error %s", strerror(ENOMEM));
+        return false;
+    }
+
+    free(cross_section->energy);
+    free(cross_section->xs);
+    free_interp_ranges(&cross_section->interp);
+    free_log_bins(&cross_section->bins);
+    free_search_tree(&cross_section->tree);
+    cross_section->energy = energy;
+    cross_section->xs = xs;
+    cross_section->interp = ranges;
+    cross_section->len = count;
+    cross_section->alloc = count;
+    if (removed) *removed = len - count;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool build_xsec_bins(xsec_t* cross_section, size_t num_bins) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to build_xsec_bins");
+        return false;
     }
+    if (!build_log_bins(&cross_section->bins, cross_section->energy, cross_section->len,
+                        num_bins)) {
+        CENDF_REPORT(errno, "Unable to build search bins: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    // Perform linear interpolation
-    float E1 = xsec->energy[lower];
-    float E2 = xsec->energy[upper];
-    float XS1 = xsec->xs[lower];
-    float XS2 = xsec->xs[upper];
+bool pack_xsec(xsec_t* cross_section) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to pack_xsec");
+        return false;
+    }
+    const size_t len = cross_section->len;
+    if (len < 2 || cross_section->interp.nr > 0) {
+        CENDF_REPORT(EINVAL, "pack_xsec requires a lin-lin table of at least two points");
+        return false;
+    }
+    if (cross_section->packed) return true;
+    xsec_record* packed = aligned_alloc(64, (len * sizeof(xsec_record) + 63) / 64 * 64);
+    if (!packed) {
+        CENDF_REPORT(ENOMEM, "Packed xsec allocation failed with error %s", strerror(ENOMEM));
+        return false;
+    }
+    const float* x = cross_section->energy;
+    const float* y = cross_section->xs;
+    for (size_t i = 0; i < len; i++) {
+        packed[i] = (xsec_record){.energy = x[i], .xs = y[i], .slope = 0.f, .pad = 0.f};
+        if (i + 1 == len) continue;
+        if (x[i + 1] > x[i]) {
+            packed[i].slope = (float)(((double)y[i + 1] - y[i]) / ((double)x[i + 1] - x[i]));
+        } else if (i + 2 == len) {
+            // A search only stops on a repeated energy at the end of the table,
+            // where the value above the edge applies
+            packed[i].xs = y[i + 1];
+        }
+    }
+    cross_section->packed = packed;
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    return XS1 + (XS2 - XS1) * (energy - E1) / (E2 - E1);
+bool xsec_is_packed(const xsec_t* cross_section) {
+    if (!cross_section) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to xsec_is_packed");
+        return false;
+    }
+    return cross_section->packed != NULL;
+}
+// --------------------------------------------------------------------------------
+
+bool build_xsec_tree(xsec_t* cross_section) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to build_xsec_tree");
+        return false;
+    }
+    if (!build_search_tree(&cross_section->tree, cross_section->energy, cross_section->len)) {
+        CENDF_REPORT(errno, "Unable to build search tree: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool xsec_has_tree(const xsec_t* cross_section) {
+    if (!cross_section) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to xsec_has_tree");
+        return false;
+    }
+    return cross_section->tree.len > 0;
+}
+// --------------------------------------------------------------------------------
+
+size_t xsec_bins(const xsec_t* cross_section) {
+    if (!cross_section) {
+        CENDF_REPORT(EINVAL, "Invalid cross_section passed to xsec_bins");
+        return 0;
+    }
+    return cross_section->bins.num_bins;
+}
+// --------------------------------------------------------------------------------
+
+bool find_xsec_interval(const xsec_t* cross_section, float energy, size_t* index) {
+    if (!cross_section || !cross_section->energy || !index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to find_xsec_interval");
+        return false;
+    }
+    const float* x = cross_section->energy;
+    const size_t len = cross_section->len;
+    if (len < 2 || !(energy >= x[0] && energy <= x[len - 1])) {
+        errno = ERANGE;
+        return false;
+    }
+    *index = xsec_lower(cross_section, energy);
+    return true;
 }
 // --------------------------------------------------------------------------------
 
 size_t xsec_size(const xsec_t* cross_section) {
     if (!cross_section || !cross_section->xs || !cross_section->energy) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid cross section passed to xsec_size\n");
+        CENDF_REPORT(EINVAL, "Invalid cross section passed to xsec_size");
         return 0;
     }
     return cross_section->len;
@@ -263,8 +1034,7 @@ size_t xsec_size(const xsec_t* cross_section) {
 
 size_t xsec_alloc(const xsec_t* cross_section) {
     if (!cross_section || !cross_section->xs || !cross_section->energy) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid cross section passed to xsec_alloc\n");
+        CENDF_REPORT(EINVAL, "Invalid cross section passed to xsec_alloc");
         return 0;
     }
     return cross_section->alloc;
@@ -273,8 +1043,16 @@ size_t xsec_alloc(const xsec_t* cross_section) {
 
 void free_xsec(xsec_t* cross_section) {
     if (!cross_section) {
-        errno = EINVAL;
-        fprintf(stderr, "Cross section NULL, possible double free\n");
+        CENDF_REPORT(EINVAL, "Cross section NULL, possible double free");
+    }
+    free_interp_ranges(&cross_section->interp);
+    free_log_bins(&cross_section->bins);
+    free_search_tree(&cross_section->tree);
+    free(cross_section->packed);
+    // A view does not own its arrays
+    if (cross_section->read_only) {
+        free(cross_section);
+        return;
     }
     if (cross_section->xs) { 
         free(cross_section->xs);
@@ -295,6 +1073,405 @@ void _free_xsec(xsec_t** cross_section) {
     }
 }
 // ================================================================================
+// ================================================================================
+// BATCHED XSEC_T INTERPOLATION
+
+// The number of searches that advance together, a multiple of the SSE and AVX2 widths
+#define XSEC_BATCH_WIDTH 8
+// --------------------------------------------------------------------------------
+
+/*
+ * Copies a group of up to XSEC_BATCH_WIDTH energies into `energy`, replacing
+ * those outside of the table, and the unused lanes, by the first energy so
+ * that every lane can be searched.  Returns the number of energies outside.
+ */
+static inline size_t batch_load(const float* x, size_t len, const float* energies, size_t count,
+                                float* energy, bool* inside) {
+    size_t outside = 0;
+    for (size_t lane = 0; lane < XSEC_BATCH_WIDTH; lane++) {
+        const float value = lane < count ? energies[lane] : x[0];
+        inside[lane] = value >= x[0] && value <= x[len - 1];
+        energy[lane] = inside[lane] ? value : x[0];
+        if (!inside[lane] && lane < count) outside++;
+    }
+    return outside;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Branchless search for the last point at or below each energy of a group,
+ * limited to len - 2.  Every search takes the same number of steps, so the
+ * loads of the group do not depend on each other and are in flight together.
+ */
+static inline void batch_search(const float* x, size_t len, const float* energy, uint32_t* lower) {
+    for (size_t lane = 0; lane < XSEC_BATCH_WIDTH; lane++) lower[lane] = 0;
+    for (size_t n = len - 1; n > 1; n -= n / 2) {
+        const uint32_t half = (uint32_t)(n / 2);
+        for (size_t lane = 0; lane < XSEC_BATCH_WIDTH; lane++)
+            lower[lane] += x[lower[lane] + half] <= energy[lane] ? half : 0;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static size_t batch_scalar(const xsec_t* xsec, const float* energies, float* out, size_t n) {
+    float energy[XSEC_BATCH_WIDTH];
+    bool inside[XSEC_BATCH_WIDTH];
+    uint32_t lower[XSEC_BATCH_WIDTH];
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i += XSEC_BATCH_WIDTH) {
+        const size_t count = n - i < XSEC_BATCH_WIDTH ? n - i : XSEC_BATCH_WIDTH;
+        outside += batch_load(xsec->energy, xsec->len, energies + i, count, energy, inside);
+        batch_search(xsec->energy, xsec->len, energy, lower);
+        for (size_t lane = 0; lane < count; lane++)
+            out[i + lane] = inside[lane] ? table_value(&xsec->interp, xsec->energy, xsec->xs, lower[lane], energy[lane]) : -1.0f;
+    }
+    return outside;
+}
+// --------------------------------------------------------------------------------
+
+#ifdef XSEC_BATCH_X86
+/*
+ * Lin-lin interpolation of four lanes, in the same order of operations as
+ * `interp_interval` so the results are identical.
+ */
+__attribute__((target("sse2")))
+static inline __m128 batch_lerp_sse(__m128 e, __m128 x1, __m128 x2, __m128 y1, __m128 y2) {
+    const __m128 slope = _mm_div_ps(_mm_mul_ps(_mm_sub_ps(y2, y1), _mm_sub_ps(e, x1)),
+                                    _mm_sub_ps(x2, x1));
+    const __m128 repeated = _mm_cmpeq_ps(x2, x1);
+    const __m128 value = _mm_add_ps(y1, slope);
+    return _mm_or_ps(_mm_and_ps(repeated, y2), _mm_andnot_ps(repeated, value));
+}
+// --------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static size_t batch_sse(const xsec_t* xsec, const float* energies, float* out, size_t n) {
+    const float* x = xsec->energy;
+    const float* y = xsec->xs;
+    float energy[XSEC_BATCH_WIDTH];
+    bool inside[XSEC_BATCH_WIDTH];
+    uint32_t lower[XSEC_BATCH_WIDTH];
+    float result[XSEC_BATCH_WIDTH];
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i += XSEC_BATCH_WIDTH) {
+        const size_t count = n - i < XSEC_BATCH_WIDTH ? n - i : XSEC_BATCH_WIDTH;
+        const size_t group_outside = batch_load(x, xsec->len, energies + i, count, energy, inside);
+        batch_search(x, xsec->len, energy, lower);
+        for (size_t lane = 0; lane < XSEC_BATCH_WIDTH; lane += 4) {
+            const uint32_t* l = lower + lane;
+            const __m128 x1 = _mm_setr_ps(x[l[0]], x[l[1]], x[l[2]], x[l[3]]);
+            const __m128 x2 = _mm_setr_ps(x[l[0] + 1], x[l[1] + 1], x[l[2] + 1], x[l[3] + 1]);
+            const __m128 y1 = _mm_setr_ps(y[l[0]], y[l[1]], y[l[2]], y[l[3]]);
+            const __m128 y2 = _mm_setr_ps(y[l[0] + 1], y[l[1] + 1], y[l[2] + 1], y[l[3] + 1]);
+            _mm_storeu_ps(result + lane, batch_lerp_sse(_mm_loadu_ps(energy + lane), x1, x2, y1, y2));
+        }
+        if (group_outside > 0) {
+            outside += group_outside;
+            for (size_t lane = 0; lane < count; lane++)
+                if (!inside[lane]) result[lane] = -1.0f;
+        }
+        memcpy(out + i, result, count * sizeof(float));
+    }
+    return outside;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * The AVX2 kernel searches all eight lanes of two groups in vector registers,
+ * loading the probed energies with gathers, so the sixteen loads of each step
+ * are issued together.
+ */
+__attribute__((target("avx2")))
+static inline __m256 batch_lerp_avx2(const float* x, const float* y, __m256 e, __m256i lower) {
+    const __m256i upper = _mm256_add_epi32(lower, _mm256_set1_epi32(1));
+    const __m256 x1 = _mm256_i32gather_ps(x, lower, 4);
+    const __m256 x2 = _mm256_i32gather_ps(x, upper, 4);
+    const __m256 y1 = _mm256_i32gather_ps(y, lower, 4);
+    const __m256 y2 = _mm256_i32gather_ps(y, upper, 4);
+    const __m256 slope = _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(y2, y1), _mm256_sub_ps(e, x1)),
+                                       _mm256_sub_ps(x2, x1));
+    const __m256 repeated = _mm256_cmp_ps(x2, x1, _CMP_EQ_OQ);
+    return _mm256_blendv_ps(_mm256_add_ps(y1, slope), y2, repeated);
+}
+// --------------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static size_t batch_avx2(const xsec_t* xsec, const float* energies, float* out, size_t n) {
+    const float* x = xsec->energy;
+    float energy[2 * XSEC_BATCH_WIDTH];
+    bool inside[2 * XSEC_BATCH_WIDTH];
+    float result[2 * XSEC_BATCH_WIDTH];
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i += 2 * XSEC_BATCH_WIDTH) {
+        const size_t count = n - i < 2 * XSEC_BATCH_WIDTH ? n - i : 2 * XSEC_BATCH_WIDTH;
+        const size_t second = count > XSEC_BATCH_WIDTH ? count - XSEC_BATCH_WIDTH : 0;
+        size_t group_outside = batch_load(x, xsec->len, energies + i, count - second, energy, inside);
+        group_outside += batch_load(x, xsec->len, energies + i + XSEC_BATCH_WIDTH, second,
+                                    energy + XSEC_BATCH_WIDTH, inside + XSEC_BATCH_WIDTH);
+        const __m256 e1 = _mm256_loadu_ps(energy);
+        const __m256 e2 = _mm256_loadu_ps(energy + XSEC_BATCH_WIDTH);
+        __m256i lower1 = _mm256_setzero_si256();
+        __m256i lower2 = _mm256_setzero_si256();
+        for (size_t m = xsec->len - 1; m > 1; m -= m / 2) {
+            const __m256i half = _mm256_set1_epi32((int)(m / 2));
+            const __m256 below1 = _mm256_cmp_ps(
+                _mm256_i32gather_ps(x, _mm256_add_epi32(lower1, half), 4), e1, _CMP_LE_OQ);
+            const __m256 below2 = _mm256_cmp_ps(
+                _mm256_i32gather_ps(x, _mm256_add_epi32(lower2, half), 4), e2, _CMP_LE_OQ);
+            lower1 = _mm256_add_epi32(lower1, _mm256_and_si256(_mm256_castps_si256(below1), half));
+            lower2 = _mm256_add_epi32(lower2, _mm256_and_si256(_mm256_castps_si256(below2), half));
+        }
+        _mm256_storeu_ps(result, batch_lerp_avx2(x, xsec->xs, e1, lower1));
+        _mm256_storeu_ps(result + XSEC_BATCH_WIDTH, batch_lerp_avx2(x, xsec->xs, e2, lower2));
+        if (group_outside > 0) {
+            outside += group_outside;
+            for (size_t lane = 0; lane < count; lane++)
+                if (!inside[lane]) result[lane] = -1.0f;
+        }
+        memcpy(out + i, result, count * sizeof(float));
+    }
+    return outside;
+}
+#endif
+// --------------------------------------------------------------------------------
+
+xsecKernel xsec_batch_kernel(void) {
+#ifdef XSEC_BATCH_X86
+    if (__builtin_cpu_supports("avx2")) return XSEC_KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2")) return XSEC_KERNEL_SSE;
+#endif
+    return XSEC_KERNEL_SCALAR;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_xsec_batch_kernel(const xsec_t* cross_section, const float* energies, float* out,
+                              size_t n, xsecKernel kernel) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy || !energies || !out) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_xsec_batch");
+        return false;
+    }
+    const size_t len = cross_section->len;
+    if (len == 0 || len > INT32_MAX) {
+        CENDF_REPORT(EINVAL, "xsec_t data type not populated with data");
+        return false;
+    }
+    if (kernel < XSEC_KERNEL_AUTO || kernel > XSEC_KERNEL_AVX2) {
+        CENDF_REPORT(EINVAL, "Unknown kernel passed to interp_xsec_batch");
+        return false;
+    }
+    const xsecKernel available = xsec_batch_kernel();
+    if (kernel == XSEC_KERNEL_AUTO) {
+        kernel = available;
+    } else if (kernel > available) {
+        CENDF_REPORT(ENOTSUP, "Kernel passed to interp_xsec_batch is not supported by the processor");
+        return false;
+    }
+
+    size_t outside = 0;
+    if (len == 1) {
+        for (size_t i = 0; i < n; i++) {
+            const bool inside = energies[i] == cross_section->energy[0];
+            out[i] = inside ? cross_section->xs[0] : -1.0f;
+            if (!inside) outside++;
+        }
+    } else if (kernel == XSEC_KERNEL_SCALAR || cross_section->interp.nr > 0) {
+        outside = batch_scalar(cross_section, energies, out, n);
+    }
+#ifdef XSEC_BATCH_X86
+    else if (kernel == XSEC_KERNEL_SSE) {
+        outside = batch_sse(cross_section, energies, out, n);
+    } else {
+        outside = batch_avx2(cross_section, energies, out, n);
+    }
+#endif
+    if (outside > 0) {
+        CENDF_REPORT(ERANGE, "%zu energies are out of bounds for cross section database", outside);
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_xsec_batch(const xsec_t* cross_section, const float* energies, float* out, size_t n) {
+    return interp_xsec_batch_kernel(cross_section, energies, out, n, XSEC_KERNEL_AUTO);
+}
+// --------------------------------------------------------------------------------
+
+bool interp_xsec_sorted(const xsec_t* cross_section, const float* energies, float* out, size_t n) {
+    if (!cross_section || !cross_section->xs || !cross_section->energy || !energies || !out) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_xsec_sorted");
+        return false;
+    }
+    const float* x = cross_section->energy;
+    const size_t len = cross_section->len;
+    if (len == 0) {
+        CENDF_REPORT(EINVAL, "xsec_t data type not populated with data");
+        return false;
+    }
+
+    // The grid and the energies are walked together, so each is read once in order
+    size_t lower = 0;
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i++) {
+        const float energy = energies[i];
+        if (i > 0 && !(energy >= energies[i - 1])) {
+            CENDF_REPORT(EINVAL, "Energies passed to interp_xsec_sorted are not ascending");
+            return false;
+        }
+        if (!(energy >= x[0] && energy <= x[len - 1])) {
+            out[i] = -1.0f;
+            outside++;
+        } else if (len == 1) {
+            out[i] = cross_section->xs[0];
+        } else {
+            while (lower + 2 < len && x[lower + 1] <= energy) lower++;
+            out[i] = table_value(&cross_section->interp, x, cross_section->xs, lower, energy);
+        }
+    }
+    if (outside > 0) {
+        CENDF_REPORT(ERANGE, "%zu energies are out of bounds for cross section database", outside);
+        return false;
+    }
+    return true;
+}
+// ================================================================================
+// ================================================================================ 
+// FORM_FACTOR_T DATA TYPE 
+
+// define form_factor_t
+struct form_factor_t {
+    float* value;
+    float* x;
+    size_t len;
+    int mt;
+    interp_ranges interp;
+};
+// --------------------------------------------------------------------------------
+
+form_factor_t* init_form_factor(const float* value, const float* x, size_t len, int mt) {
+    if (!value || !x || len == 0) {
+        CENDF_REPORT(EINVAL, "Invalid table passed to init_form_factor");
+        return NULL;
+    }
+    form_factor_t* struct_ptr = malloc(sizeof(form_factor_t));
+    float* value_ptr = struct_ptr ? malloc(sizeof(float) * len) : NULL;
+    float* x_ptr = value_ptr ? malloc(sizeof(float) * len) : NULL;
+    if (!x_ptr) {
+        CENDF_REPORT(ENOMEM, "form_factor allocation failed with error %s", strerror(ENOMEM));
+        free(value_ptr);
+        free(struct_ptr);
+        return NULL;
+    }
+    memcpy(value_ptr, value, sizeof(float) * len);
+    memcpy(x_ptr, x, sizeof(float) * len);
+    struct_ptr->value = value_ptr;
+    struct_ptr->x = x_ptr;
+    struct_ptr->len = len;
+    struct_ptr->mt = mt;
+    struct_ptr->interp = (interp_ranges){0};
+    return struct_ptr;
+}
+// --------------------------------------------------------------------------------
+
+const float interp_form_factor_status(const form_factor_t* form_factor, float x,
+                                     cendfStatus* status) {
+    if (!form_factor || form_factor->len == 0) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return -1.0f;
+    }
+    if (!(x >= form_factor->x[0] && x <= form_factor->x[form_factor->len - 1])) {
+        cendf_set_status(status, CENDF_STATUS_RANGE);
+        return -1.0f;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    float result;
+    interp_table(&form_factor->interp, NULL, form_factor->x, form_factor->value,
+                 form_factor->len, x, &result);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+const float interp_form_factor(const form_factor_t* form_factor, float x) {
+    cendfStatus status;
+    const float result = interp_form_factor_status(form_factor, x, &status);
+    if (status == CENDF_STATUS_INVALID)
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_form_factor function");
+    else if (status == CENDF_STATUS_RANGE)
+        CENDF_REPORT(ERANGE, "Value %g is out of bounds for MT%d form factor", x, form_factor->mt);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+bool set_form_factor_interpolation(form_factor_t* form_factor, const size_t* nbt,
+                                   const int* law, size_t nr) {
+    if (!form_factor) {
+        CENDF_REPORT(EINVAL, "Invalid form_factor passed to set_form_factor_interpolation");
+        return false;
+    }
+    if (!build_interp_ranges(&form_factor->interp, form_factor->x, form_factor->value,
+                             form_factor->len, nbt, law, nr)) {
+        CENDF_REPORT(errno, "Unable to set interpolation ranges: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+const float get_form_factor(const form_factor_t* form_factor, size_t index) {
+    if (!form_factor || index >= form_factor->len) {
+        CENDF_REPORT(EINVAL, "Invalid form_factor or index passed to get_form_factor");
+        return -1.0f;
+    }
+    return form_factor->value[index];
+}
+// --------------------------------------------------------------------------------
+
+const float get_form_factor_x(const form_factor_t* form_factor, size_t index) {
+    if (!form_factor || index >= form_factor->len) {
+        CENDF_REPORT(EINVAL, "Invalid form_factor or index passed to get_form_factor_x");
+        return -1.0f;
+    }
+    return form_factor->x[index];
+}
+// --------------------------------------------------------------------------------
+
+size_t form_factor_size(const form_factor_t* form_factor) {
+    if (!form_factor) {
+        CENDF_REPORT(EINVAL, "Invalid form_factor passed to form_factor_size");
+        return 0;
+    }
+    return form_factor->len;
+}
+// --------------------------------------------------------------------------------
+
+int form_factor_mt(const form_factor_t* form_factor) {
+    if (!form_factor) {
+        CENDF_REPORT(EINVAL, "Invalid form_factor passed to form_factor_mt");
+        return -1;
+    }
+    return form_factor->mt;
+}
+// --------------------------------------------------------------------------------
+
+void free_form_factor(form_factor_t* form_factor) {
+    if (!form_factor) {
+        CENDF_REPORT(EINVAL, "Form factor NULL, possible double free");
+        return;
+    }
+    free_interp_ranges(&form_factor->interp);
+    free(form_factor->value);
+    free(form_factor->x);
+    free(form_factor);
+}
+// --------------------------------------------------------------------------------
+
+void _free_form_factor(form_factor_t** form_factor) {
+    if (form_factor && *form_factor) {
+        free_form_factor(*form_factor);
+        *form_factor = NULL;
+    }
+}
+// ================================================================================
 // ================================================================================ 
 // STRING_T DATA TYPE 
 
@@ -307,21 +1484,18 @@ struct string_t {
 
 string_t* init_string(const char* str) {
     if (str == NULL) {
-        errno = EINVAL;
-        fprintf(stderr, "Null value passed to init_string with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null value passed to init_string with error: %s", strerror(EINVAL));
         return NULL;
     }
     string_t* ptr = malloc(sizeof(string_t));
     if (ptr == NULL) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed string_t allocation with error: %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "Failed string_t allocation with error: %s", strerror(ENOMEM));
         return NULL;
     }
     size_t len = strlen(str);
     char* ptr2 = malloc(len + 1);
     if (ptr2 == NULL) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed string allocation with error: %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "Failed string allocation with error: %s", strerror(ENOMEM));
         free(ptr);
         return NULL;
     }
@@ -335,8 +1509,7 @@ string_t* init_string(const char* str) {
 
 void free_string(string_t* str) {
     if (!str) {
-        errno = EINVAL;
-        fprintf(stderr, "String NULL, possible double free\n");
+        CENDF_REPORT(EINVAL, "String NULL, possible double free");
         return;
     }
     if (str->str) {
@@ -362,8 +1535,7 @@ void _free_string(string_t** str) {
 
 const char* get_string(const string_t* str) {
     if (!str || !str->str) {
-        errno = EINVAL;
-        fprintf(stderr, "string_t struct or literal is NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "string_t struct or literal is NULL with error: %s", strerror(EINVAL));
         return NULL;
     }
     return str->str;
@@ -372,8 +1544,7 @@ const char* get_string(const string_t* str) {
 
 const size_t string_size(const string_t* str) {
     if (!str || !str->str) {
-        errno = EINVAL;
-        fprintf(stderr, "string_t struct or literal is NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "string_t struct or literal is NULL with error: %s", strerror(EINVAL));
         return -1;
     }
     return str->len;
@@ -382,8 +1553,7 @@ const size_t string_size(const string_t* str) {
 
 const size_t string_alloc(const string_t* str) {
     if (!str || !str->str) {
-        errno = EINVAL;
-        fprintf(stderr, "string_t struct or literal is NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "string_t struct or literal is NULL with error: %s", strerror(EINVAL));
         return -1;
     }
     return str->alloc;
@@ -392,8 +1562,7 @@ const size_t string_alloc(const string_t* str) {
 
 bool string_string_concat(string_t* str1, const string_t* str2) {
     if (!str1 || !str2 || !str1->str || !str2->str) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid input: one or both strings are NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Invalid input: one or both strings are NULL with error: %s", strerror(EINVAL));
         return false;
     }
 
@@ -405,8 +1574,7 @@ bool string_string_concat(string_t* str1, const string_t* str2) {
         // Reallocate the buffer to accommodate the new string
         char* new_buffer = realloc(str1->str, new_len + 1); // +1 for the null terminator
         if (!new_buffer) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate memory for concatenated string with error: %s\n", strerror(errno));
+            CENDF_REPORT(ENOMEM, "Failed to reallocate memory for concatenated string with error: %s", strerror(ENOMEM));
             return false;
         }
         str1->str = new_buffer;
@@ -424,8 +1592,7 @@ bool string_string_concat(string_t* str1, const string_t* str2) {
 
 bool string_lit_concat(string_t* str1, const char* literal) {
     if (!str1 || !str1->str || !literal) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid input: string_t or literal is NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Invalid input: string_t or literal is NULL with error: %s", strerror(EINVAL));
         return false;
     }
 
@@ -438,8 +1605,7 @@ bool string_lit_concat(string_t* str1, const char* literal) {
         // Reallocate the buffer to accommodate the new string
         char* new_buffer = realloc(str1->str, new_len + 1); // +1 for the null terminator
         if (!new_buffer) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate memory for concatenated string with error: %s\n", strerror(errno));
+            CENDF_REPORT(ENOMEM, "Failed to reallocate memory for concatenated string with error: %s", strerror(ENOMEM));
             return false;
         }
         str1->str = new_buffer;
@@ -458,8 +1624,7 @@ bool string_lit_concat(string_t* str1, const char* literal) {
 
 int compare_strings_lit(const string_t* str_struct, const char* string) {
     if (!str_struct || !string || !str_struct->str) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer provided to compare_strings_lit.\n");
+        CENDF_REPORT(EINVAL, "Null pointer provided to compare_strings_lit.");
         return INT_MIN; // Or another designated error value
     }
 
@@ -477,8 +1642,7 @@ int compare_strings_lit(const string_t* str_struct, const char* string) {
 
 int compare_strings_string(const string_t* str_struct_one, string_t* str_struct_two) {
     if (!str_struct_one || !str_struct_two || !str_struct_one->str || !str_struct_two->str) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer provided to compare_strings_str.\n");
+        CENDF_REPORT(EINVAL, "Null pointer provided to compare_strings_str.");
         return INT_MIN; // Or another designated error value
     } 
 
@@ -496,8 +1660,7 @@ int compare_strings_string(const string_t* str_struct_one, string_t* str_struct_
 
 string_t* copy_string(const string_t* str) {
     if (!str || !str->str) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid input: string_t struct or literal is NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Invalid input: string_t struct or literal is NULL with error: %s", strerror(EINVAL));
         return false;
     }
     string_t* new_str = init_string(get_string(str));
@@ -509,23 +1672,20 @@ string_t* copy_string(const string_t* str) {
 
 bool reserve_string(string_t* str, size_t len) {
     if (!str || !str->str) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid input: string_t struct or literal is NULL with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Invalid input: string_t struct or literal is NULL with error: %s", strerror(EINVAL));
         return false;
     }
 
     // Ensure the requested length is greater than the current allocation
     if (len <= str->alloc) {
-        errno = EINVAL;
-        fprintf(stderr, "Invalid operation: reserve_string cannot reduce memory allocation. Current alloc: %zu, requested: %zu\n", str->alloc, len);
+        CENDF_REPORT(EINVAL, "Invalid operation: reserve_string cannot reduce memory allocation. Current alloc: %zu, requested: %zu", str->alloc, len);
         return false;
     }
 
     // Attempt to reallocate memory
     char* ptr = realloc(str->str, sizeof(char) * len);
     if (!ptr) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed to reallocate memory with error: %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "Failed to reallocate memory with error: %s", strerror(ENOMEM));
         return false;
     }
 
@@ -548,14 +1708,12 @@ struct vector_t {
 vector_t* init_vector(size_t len) {
     vector_t* ptr = malloc(sizeof(vector_t));
     if (!ptr) {
-        errno = ENOMEM;
-        fprintf(stderr, "Vector allocation failure with error: %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "Vector allocation failure with error: %s", strerror(ENOMEM));
         return NULL;
     }
     float* ptr2 = malloc(len * sizeof(float));
     if (!ptr2) {
-        errno = ENOMEM;
-        fprintf(stderr, "Float vector allocation failure with error: %s\n", strerror(errno));
+        CENDF_REPORT(ENOMEM, "Float vector allocation failure with error: %s", strerror(ENOMEM));
         free(ptr);
         return NULL;
     }
@@ -568,8 +1726,7 @@ vector_t* init_vector(size_t len) {
 
 bool push_back_vector(vector_t* vec, float dat) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return false;
     }
     // Check if reallocation is needed
@@ -584,8 +1741,7 @@ bool push_back_vector(vector_t* vec, float dat) {
         // Attempt to reallocate the cross-section array
         float* ptr = realloc(vec->data, new_alloc * sizeof(float));
         if (!ptr) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate for push_xsec\n");
+            CENDF_REPORT(ENOMEM, "Failed to reallocate for push_xsec");
             return false;
         }
 
@@ -601,8 +1757,7 @@ bool push_back_vector(vector_t* vec, float dat) {
 
 bool push_front_vector(vector_t* vec, float dat) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return false;
     }
     // Check if reallocation is needed
@@ -617,8 +1772,7 @@ bool push_front_vector(vector_t* vec, float dat) {
         // Attempt to reallocate the cross-section array
         float* ptr = realloc(vec->data, new_alloc * sizeof(float));
         if (!ptr) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate for push_xsec\n");
+            CENDF_REPORT(ENOMEM, "Failed to reallocate for push_xsec");
             return false;
         }
 
@@ -639,15 +1793,13 @@ bool push_front_vector(vector_t* vec, float dat) {
 
 bool insert_vector(vector_t* vec, float dat, size_t index) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return false;
     }
 
     // Ensure index is within valid range
     if (index > vec->len) {  // Allow inserting at the end (index == vec->len)
-        errno = ERANGE;
-        fprintf(stderr, "Index value of %ld is out of range for length %ld\n", index, vec->len);
+        CENDF_REPORT(ERANGE, "Index value of %ld is out of range for length %ld", index, vec->len);
         return false;
     }
 
@@ -671,8 +1823,7 @@ bool insert_vector(vector_t* vec, float dat, size_t index) {
         // Attempt to reallocate the vector's array
         float* new_data = realloc(vec->data, new_alloc * sizeof(float));
         if (!new_data) {
-            errno = ENOMEM;
-            fprintf(stderr, "Failed to reallocate for insert_vector with error: %s\n", strerror(errno));
+            CENDF_REPORT(ENOMEM, "Failed to reallocate for insert_vector with error: %s", strerror(ENOMEM));
             return false;
         }
 
@@ -695,13 +1846,11 @@ bool insert_vector(vector_t* vec, float dat, size_t index) {
 
 float pop_back_vector(vector_t* vec) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return FLT_MIN;
     }
     if (vec->len == 0) {
-        errno = EINVAL;
-        fprintf(stderr, "Vector is empty, can not pop\n");
+        CENDF_REPORT(EINVAL, "Vector is empty, can not pop");
         return FLT_MIN;
     }
     float dat = vec->data[vec->len-1];
@@ -712,14 +1861,12 @@ float pop_back_vector(vector_t* vec) {
 
 float pop_front_vector(vector_t* vec) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return FLT_MIN;  // Return FLT_MIN to indicate error
     }
 
     if (vec->len == 0) {
-        errno = EINVAL;
-        fprintf(stderr, "Vector is empty, cannot pop\n");
+        CENDF_REPORT(EINVAL, "Vector is empty, cannot pop");
         return FLT_MIN;  // Return FLT_MIN to indicate error
     }
 
@@ -740,20 +1887,17 @@ float pop_front_vector(vector_t* vec) {
 
 float pop_any_vector(vector_t* vec, size_t index) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return FLT_MIN;  // Return FLT_MIN to indicate error
     }
 
     if (vec->len == 0) {
-        errno = EINVAL;
-        fprintf(stderr, "Vector is empty, cannot pop\n");
+        CENDF_REPORT(EINVAL, "Vector is empty, cannot pop");
         return FLT_MIN;  // Return FLT_MIN to indicate error
     }
 
     if (index >= vec->len) {  // Ensure index is within bounds
-        errno = ERANGE;
-        fprintf(stderr, "Index %ld is out of range for vector length %ld\n", index, vec->len);
+        CENDF_REPORT(ERANGE, "Index %ld is out of range for vector length %ld", index, vec->len);
         return FLT_MIN;  // Return FLT_MIN to indicate error
     }
 
@@ -779,23 +1923,30 @@ float pop_any_vector(vector_t* vec, size_t index) {
 
 const float get_vector(const vector_t* vec, size_t index) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return FLT_MAX;
     }
     if (index >= vec->len) {
-        errno = EINVAL;
-        fprintf(stderr, "Index %zu out of bounds (len: %zu)\n", index, vec->len);
+        CENDF_REPORT(EINVAL, "Index %zu out of bounds (len: %zu)", index, vec->len);
         return FLT_MAX;
     }
     return vec->data[index]; 
 }
 // --------------------------------------------------------------------------------
 
+const float get_vector_status(const vector_t* vec, size_t index, cendfStatus* status) {
+    if (!vec || !vec->data || index >= vec->len) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return FLT_MAX;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    return vec->data[index];
+}
+// --------------------------------------------------------------------------------
+
 const size_t vector_size(const vector_t* vec) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return 0;
     }
     return vec->len;
@@ -804,8 +1955,7 @@ const size_t vector_size(const vector_t* vec) {
 
 const size_t vector_alloc(const vector_t* vec) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return 0;
     }
     return vec->alloc;
@@ -814,8 +1964,7 @@ const size_t vector_alloc(const vector_t* vec) {
 
 void free_vector(vector_t* vec) {
     if (!vec) {
-        errno = EINVAL;
-        fprintf(stderr, "Vector NULL, possible double free\n");
+        CENDF_REPORT(EINVAL, "Vector NULL, possible double free");
         return;
     }
     if (vec->data) {
@@ -840,8 +1989,7 @@ void _free_vector(vector_t** vec) {
 
 vector_t* copy_vector(const vector_t* vec) {
     if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return NULL;
     }
     vector_t* new_vec = init_vector(vec->alloc);
@@ -855,8 +2003,7 @@ vector_t* copy_vector(const vector_t* vec) {
 
 const float* get_vecArray(const vector_t* vec) {
    if (!vec || !vec->data) {
-        errno = EINVAL;
-        fprintf(stderr, "Null pointer to vector_t or float vector with error: %s\n", strerror(errno));
+        CENDF_REPORT(EINVAL, "Null pointer to vector_t or float vector with error: %s", strerror(EINVAL));
         return NULL;
     }
     return vec->data; 
@@ -936,14 +2083,12 @@ static bool resize_dict(dict_t* dict, size_t new_size) {
 dict_t* init_dict() {
     dict_t* hashPtr = malloc(sizeof(*hashPtr));
     if (!hashPtr) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failure to allocate dict_t struct in init_dict()\n");
+        CENDF_REPORT(ENOMEM, "Failure to allocate dict_t struct in init_dict()");
         return NULL;
     }
     dictNode* arrPtr = malloc(hashSize * sizeof(*arrPtr));
     if (!arrPtr) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failure to allocate dictNode in init_dict()\n");
+        CENDF_REPORT(ENOMEM, "Failure to allocate dictNode in init_dict()");
         free(hashPtr);
         return NULL;
     }
@@ -977,8 +2122,7 @@ bool insert_dict(dict_t* dict, char* key, float value) {
     while (current) {
         if (strcmp(current->key, key) == 0) {
             // Key already exists, return control to the calling program
-            errno = EINVAL;
-            fprintf(stderr, "Key already exists in dictionary, exiting insert_dict()\n");
+            CENDF_REPORT(EINVAL, "Key already exists in dictionary, exiting insert_dict()");
             return false;
         }
         current = current->next;
@@ -987,8 +2131,7 @@ bool insert_dict(dict_t* dict, char* key, float value) {
     // Allocate memory for the key
     char* new_key = malloc((strlen(key) + 1) * sizeof(char));
     if (!new_key) {
-        errno = ENOMEM;
-        fprintf(stderr, "Failed to allocate string for dictionary key word, exiting insert_dict()\n");
+        CENDF_REPORT(ENOMEM, "Failed to allocate string for dictionary key word, exiting insert_dict()");
         free(current->key);
         return false;
     }
@@ -1060,11 +2203,28 @@ const float get_dict_value(const dict_t* table, char* key) {
         }
         current = current->next;
     }
-    fprintf(stderr, "Key: '%s' does not exist in dictionary\n", key);
+    CENDF_REPORT(ENODATA, "Key: '%s' does not exist in dictionary", key);
     return FLT_MAX; 
 }
 // --------------------------------------------------------------------------------
 
+const float get_dict_value_status(const dict_t* table, char* key, cendfStatus* status) {
+    if (!table || !key) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return FLT_MAX;
+    }
+    size_t index = hash_function(key) % table->alloc;
+    for (dictNode* current = table->keyValues[index].next; current; current = current->next) {
+        if (strcmp(current->key, key) == 0) {
+            cendf_set_status(status, CENDF_STATUS_OK);
+            return current->value;
+        }
+    }
+    cendf_set_status(status, CENDF_STATUS_NO_DATA);
+    return FLT_MAX;
+}
+// --------------------------------------------------------------------------------
+
 void free_dict(dict_t* dict) {
     for (size_t i = 0; i < dict->alloc; i++) {
         dictNode* current = dict->keyValues[i].next; // Start from the head of the list
@@ -1098,7 +2258,7 @@ bool update_dict(dict_t* dict, char* key, float value) {
         }
         current = current->next;
     }
-    fprintf(stderr, "Key '%s' does not exist in dictionary\n", key);
+    CENDF_REPORT(ENODATA, "Key '%s' does not exist in dictionary", key);
     // If key is not found, no action is taken
     return false;
 }
@@ -1149,8 +2309,7 @@ element_t* fetch_element_data(const char* element, const char* file_name) {
     json_error_t error;
     json_t* root = json_load_file(file_name, 0, &error);
     if (!root) {
-        errno = ENOENT;
-        fprintf(stderr, "Element json file '%s' does not exist", file_name);
+        CENDF_REPORT(ENOENT, "Element json file '%s' does not exist", file_name);
         return NULL;
     }
     // Search for the element
@@ -1275,8 +2434,7 @@ element_t* fetch_element(const char* element) {
 
 const string_t* element_symbol(const element_t* elem) {
     if (!elem || !elem->symbol) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or symbol is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or symbol is NULL");
         return NULL;
     }
     return elem->symbol;
@@ -1285,8 +2443,7 @@ const string_t* element_symbol(const element_t* elem) {
 
 const string_t* element_element(const element_t* elem) {
     if (!elem || !elem->element) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or element is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or element is NULL");
         return NULL;
     }
     return elem->element;
@@ -1295,8 +2452,7 @@ const string_t* element_element(const element_t* elem) {
 
 const string_t* element_category(const element_t* elem) {
     if (!elem || !elem->category) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or category is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or category is NULL");
         return NULL;
     }
     return elem->category;
@@ -1305,8 +2461,7 @@ const string_t* element_category(const element_t* elem) {
 
 const size_t element_atomic_number(const element_t* elem) {
     if (!elem || !elem->atom_num) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or atomic number is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or atomic number is NULL");
         return LONG_MAX;
     }
     return elem->atom_num;
@@ -1315,8 +2470,7 @@ const size_t element_atomic_number(const element_t* elem) {
 
 const float element_weight(const element_t* elem) {
     if (!elem || !elem->weight) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or weight is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or weight is NULL");
         return -1.0;
     }
     return elem->weight;
@@ -1325,8 +2479,7 @@ const float element_weight(const element_t* elem) {
 
 const float element_electroneg(const element_t* elem) {
     if (!elem || !elem->electro_neg) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or electronegativity is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or electronegativity is NULL");
         return -1.0;
     }
     return elem->electro_neg;
@@ -1335,8 +2488,7 @@ const float element_electroneg(const element_t* elem) {
 
 const dict_t* element_melting_point(const element_t* elem) {
     if (!elem || !elem->electro_neg) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or melting point is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or melting point is NULL");
         return NULL;
     }
     return elem->melting;
@@ -1345,8 +2497,7 @@ const dict_t* element_melting_point(const element_t* elem) {
 
 const dict_t* element_boiling_point(const element_t* elem) {
     if (!elem || !elem->electro_neg) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or boiling point is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or boiling point is NULL");
         return NULL;
     }
     return elem->boiling;
@@ -1355,8 +2506,7 @@ const dict_t* element_boiling_point(const element_t* elem) {
 
 const float element_electron_affin(const element_t* elem) {
     if (!elem || !elem->electron_affin) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or electron_affin is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or electron_affin is NULL");
         return -1.0;
     }
     return elem->electron_affin;
@@ -1365,8 +2515,7 @@ const float element_electron_affin(const element_t* elem) {
 
 const vector_t* element_ionization(const element_t* elem) {
     if (!elem || !elem->ionization) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or ionization is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or ionization is NULL");
         return NULL;
     }
     return elem->ionization;
@@ -1375,8 +2524,7 @@ const vector_t* element_ionization(const element_t* elem) {
 
 const float element_radius(const element_t* elem) {
     if (!elem || !elem->radius) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or ionization is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or ionization is NULL");
         return -1.0;
     }
     return elem->radius;
@@ -1385,8 +2533,7 @@ const float element_radius(const element_t* elem) {
 
 const float element_density(const element_t* elem) {
     if (!elem || !elem->density) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or density is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or density is NULL");
         return -1.0;
     }
     return elem->density;
@@ -1395,8 +2542,7 @@ const float element_density(const element_t* elem) {
 
 const string_t* element_electron_config(const element_t* elem) {
     if (!elem || !elem->electron_config) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure or electron config is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure or electron config is NULL");
         return NULL;
     }
     return elem->electron_config;
@@ -1405,13 +2551,11 @@ const string_t* element_electron_config(const element_t* elem) {
 
 const float element_hardness(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->hardness == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No hardness data available for this element\n");
+        CENDF_REPORT(ENODATA, "No hardness data available for this element");
         return -1.0f;
     }
     return elem->hardness;
@@ -1420,13 +2564,11 @@ const float element_hardness(const element_t* elem) {
 
 const float element_modulus(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->modulus == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No modulus data available for this element\n");
+        CENDF_REPORT(ENODATA, "No modulus data available for this element");
         return -1.0f;
     }
     return elem->modulus;
@@ -1435,13 +2577,11 @@ const float element_modulus(const element_t* elem) {
 
 const float element_thermal_cond(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->therm_cond == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No thermal conductivity data available for this element\n");
+        CENDF_REPORT(ENODATA, "No thermal conductivity data available for this element");
         return -1.0f;
     }
     return elem->therm_cond;
@@ -1450,13 +2590,11 @@ const float element_thermal_cond(const element_t* elem) {
 
 const float element_electrical_cond(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->electric_cond == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No electrical conductivity data available for this element\n");
+        CENDF_REPORT(ENODATA, "No electrical conductivity data available for this element");
         return -1.0f;
     }
     return elem->electric_cond;
@@ -1465,13 +2603,11 @@ const float element_electrical_cond(const element_t* elem) {
 
 const float element_specific_heat(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->specific_heat == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No specific heat data available for this element\n");
+        CENDF_REPORT(ENODATA, "No specific heat data available for this element");
         return -1.0f;
     }
     return elem->specific_heat;
@@ -1480,13 +2616,11 @@ const float element_specific_heat(const element_t* elem) {
 
 const float element_vaporization_heat(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->vaporization == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No heat of vaporization data available for this element\n");
+        CENDF_REPORT(ENODATA, "No heat of vaporization data available for this element");
         return -1.0f;
     }
     return elem->vaporization;
@@ -1495,13 +2629,11 @@ const float element_vaporization_heat(const element_t* elem) {
 
 const float element_fusion_heat(const element_t* elem) {
     if (!elem) {
-        errno = EINVAL;
-        fprintf(stderr, "element_t data structure is NULL\n");
+        CENDF_REPORT(EINVAL, "element_t data structure is NULL");
         return -1.0f;
     }
     if (elem->fusion_heat == -1.0f) {
-        errno = ENODATA;
-        fprintf(stderr, "No heat of fusion data available for this element\n");
+        CENDF_REPORT(ENODATA, "No heat of fusion data available for this element");
         return -1.0f;
     }
     return elem->fusion_heat;
@@ -0,0 +1,193 @@
+// ================================================================================
+// ================================================================================
+// - File:    cache.h
+// - Purpose: Binary cache of parsed cross section tables
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef cache_H
+#define cache_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "dstructures.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct cacheTable
+ * @brief Describes one cross section table held in a binary cache.
+ *
+ * Fields:
+ *  - float za: The ZA identifier of the material (1000 * Z + A).
+ *  - float awr: The atomic weight ratio of the material to the neutron.
+ *  - int mat: The ENDF MAT number of the material.
+ *  - int mf: The ENDF file number of the table.
+ *  - int mt: The ENDF reaction number of the table.
+ *  - const xsec_t* xsec: A read-only view of the table data.  The view is
+ *    owned by the cache and must not be freed by the caller.
+ */
+typedef struct {
+    float za;
+    float awr;
+    int mat;
+    int mf;
+    int mt;
+    const xsec_t* xsec;
+} cacheTable;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct xsec_cache_t
+ * @brief Forward declaration for a memory-mapped binary cache of cross sections.
+ *
+ * The cache file holds a header, a table of contents and 64 byte aligned
+ * float arrays.  Loading a cache maps the file and creates one read-only
+ * `xsec_t` view per table, so the cost of loading depends on the number of
+ * tables and not on the number of points.  The data in this struct is
+ * encapsulated, preventing a user from directly accessing it.
+ */
+typedef struct xsec_cache_t xsec_cache_t;
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function write_xsec_cache
+ * @brief Parses ENDF files and writes every TAB1 table to a binary cache file.
+ *
+ * Every section of each file except the MF1 directory is read as a TAB1
+ * table; sections that are not TAB1 tables are skipped.  Tables are written
+ * in order of ZA, MF and MT.  The cache is written to a temporary file and
+ * renamed into place, so readers never see a partially written cache.
+ *
+ * @param cache_file The path of the cache file to write.
+ * @param file_names An array of paths to ENDF files.
+ * @param num_files The number of paths in `file_names`.
+ * @return true if the cache file was written, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, or two files hold the same material.
+ * - ENOENT: An ENDF file cannot be opened.
+ * - ENODATA: The files hold no TAB1 table.
+ * - ENOMEM: Memory allocation failed.
+ * - EIO: The cache file could not be written.
+ */
+bool write_xsec_cache(const char* cache_file, const char* const* file_names, size_t num_files);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function open_xsec_cache
+ * @brief Maps a binary cache file and creates read-only views of its tables.
+ *
+ * The header and the table of contents are checked against their checksum;
+ * the float arrays are not read until they are used.  Use `verify_xsec_cache`
+ * to check the arrays as well.
+ *
+ * @param cache_file The path of the cache file.
+ * @return A pointer to an `xsec_cache_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - ENOENT: The cache file cannot be opened or mapped.
+ * - EINVAL: The cache file is damaged or has an unsupported format version.
+ * - ENOMEM: Memory allocation failed.
+ */
+xsec_cache_t* open_xsec_cache(const char* cache_file);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function verify_xsec_cache
+ * @brief Checks the float arrays of every table against their checksums.
+ *
+ * @param cache Pointer to the `xsec_cache_t` structure.
+ * @return true if every table is intact, false otherwise (sets `errno` to EINVAL).
+ */
+bool verify_xsec_cache(const xsec_cache_t* cache);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_cache_size
+ * @brief Returns the number of tables in a cache.
+ *
+ * @param cache Pointer to the `xsec_cache_t` structure.
+ * @return The number of tables, or 0 if the pointer is NULL.
+ */
+size_t xsec_cache_size(const xsec_cache_t* cache);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_cache_tables
+ * @brief Returns the tables of a cache, sorted by ZA, MF and MT.
+ *
+ * @param cache Pointer to the `xsec_cache_t` structure.
+ * @return A pointer to the array of tables, or NULL if the pointer is NULL.
+ */
+const cacheTable* get_cache_tables(const xsec_cache_t* cache);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_cached_xsec
+ * @brief Finds a table of the material with a given atomic number.
+ *
+ * @param cache Pointer to the `xsec_cache_t` structure.
+ * @param z The atomic number of the material.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return A read-only view of the table, or NULL on failure.  The view is
+ *         owned by the cache and must not be freed by the caller.
+ *
+ * Possible errors:
+ * - EINVAL: The cache pointer is NULL.
+ * - ENODATA: The cache does not hold the table.
+ */
+const xsec_t* get_cached_xsec(const xsec_cache_t* cache, int z, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_xsec_cache
+ * @brief Frees the views of a cache and unmaps the cache file.
+ *
+ * @param cache Pointer to the `xsec_cache_t` structure.
+ */
+void free_xsec_cache(xsec_cache_t* cache);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_xsec_cache
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param cache Pointer to a pointer to the `xsec_cache_t` structure.
+ */
+void _free_xsec_cache(xsec_cache_t** cache);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro XSEC_CACHE_GBC
+     * @brief A macro for enabling automatic cleanup of xsec_cache_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_xsec_cache`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define XSEC_CACHE_GBC __attribute__((cleanup(_free_xsec_cache)))
+#endif
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* cache_H */
+// ================================================================================
+// ================================================================================
+// eof
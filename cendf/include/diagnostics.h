@@ -0,0 +1,213 @@
+// ================================================================================
+// ================================================================================
+// - File:    diagnostics.h
+// - Purpose: Status codes, the last error of a thread and the error log
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef diagnostics_H
+#define diagnostics_H
+
+#include <stdlib.h>   // For size_t
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @enum cendfStatus
+ * @brief The outcome of a call, as returned by the `_status` functions.
+ *
+ * Every failure has the value of the `errno` code that the logging form of
+ * the same function sets, so a status can be passed to `strerror` or
+ * compared with `errno` codes directly.
+ *
+ * Values:
+ *  - CENDF_STATUS_OK: The call succeeded.
+ *  - CENDF_STATUS_INVALID: A pointer is NULL or an argument is invalid (EINVAL).
+ *  - CENDF_STATUS_RANGE: A value lies outside of a table or an index is out of bounds (ERANGE).
+ *  - CENDF_STATUS_NO_MEMORY: Memory allocation failed (ENOMEM).
+ *  - CENDF_STATUS_NO_DATA: The data asked for does not exist (ENODATA).
+ *  - CENDF_STATUS_NOT_PERMITTED: The object can not be changed in this way (EPERM).
+ */
+typedef enum {
+    CENDF_STATUS_OK = 0,
+    CENDF_STATUS_INVALID = EINVAL,
+    CENDF_STATUS_RANGE = ERANGE,
+    CENDF_STATUS_NO_MEMORY = ENOMEM,
+    CENDF_STATUS_NO_DATA = ENODATA,
+    CENDF_STATUS_NOT_PERMITTED = EPERM
+} cendfStatus;
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief The longest message kept in a `cendfError`, including the terminating null.
+ */
+#define CENDF_MESSAGE_SIZE 256
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct cendfError
+ * @brief The last error reported by the library on one thread.
+ *
+ * Fields:
+ *  - int code: The `errno` code of the error, or 0 if there has been none.
+ *  - const char* function: The name of the function that reported it, or NULL.
+ *  - char message[CENDF_MESSAGE_SIZE]: The text of the error, truncated to fit.
+ */
+typedef struct {
+    int code;
+    const char* function;
+    char message[CENDF_MESSAGE_SIZE];
+} cendfError;
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef cendfLogHandler
+ * @brief A function that receives the errors the library logs.
+ *
+ * The handler is called with a lock held, so calls never overlap, and it must
+ * not call `cendf_set_log_handler` or `cendf_set_log_rate`.
+ *
+ * @param error The error being logged.
+ * @param suppressed The number of errors dropped by the rate limit since the
+ *                   last error that was logged.
+ * @param user The pointer passed to `cendf_set_log_handler`.
+ */
+typedef void (*cendfLogHandler)(const cendfError* error, size_t suppressed, void* user);
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function cendf_set_log_handler
+ * @brief Installs the function that receives the errors the library logs.
+ *
+ * The library logs to stderr through `cendf_stderr_log` until another
+ * handler is installed.  A NULL handler discards every message, while the
+ * last error of each thread is still recorded.
+ *
+ * @param handler The log handler, or NULL.
+ * @param user A pointer passed to every call of the handler.
+ */
+void cendf_set_log_handler(cendfLogHandler handler, void* user);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cendf_stderr_log
+ * @brief The default log handler, which writes one line per error to stderr.
+ *
+ * @param error The error being logged.
+ * @param suppressed The number of errors dropped before this one.
+ * @param user Unused.
+ */
+void cendf_stderr_log(const cendfError* error, size_t suppressed, void* user);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cendf_set_log_rate
+ * @brief Limits the number of errors logged per second across all threads.
+ *
+ * Errors beyond the limit are counted and dropped before their message is
+ * passed to the handler, and the count is passed with the next error that
+ * is logged.  The default limit is `CENDF_LOG_RATE`.
+ *
+ * @param messages_per_second The limit, or 0 to log every error.
+ */
+void cendf_set_log_rate(size_t messages_per_second);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief The number of errors logged per second before any call to `cendf_set_log_rate`.
+ */
+#define CENDF_LOG_RATE 10
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cendf_last_error
+ * @brief Retrieves the last error reported on the calling thread.
+ *
+ * Every error the library reports with a message is recorded here, whether
+ * or not the message is logged.  Errors that a function only signals through
+ * `errno`, such as an energy outside of a unionized grid, and the errors of
+ * the `_status` functions are not recorded.
+ *
+ * @return A pointer to the record of the calling thread, which stays valid
+ *         for the life of the thread.  Its code is 0 if no error has been
+ *         reported since the thread started or `cendf_clear_error` was called.
+ */
+const cendfError* cendf_last_error(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cendf_clear_error
+ * @brief Clears the last error of the calling thread.
+ */
+void cendf_clear_error(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cendf_status_string
+ * @brief Retrieves a constant description of a status without formatting any text.
+ *
+ * @param status A status code.
+ * @return A string literal describing the status.
+ */
+const char* cendf_status_string(cendfStatus status);
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function cendf_report
+ * @brief Reports an error of the library.
+ *
+ * Sets `errno` to `code`, records the error as the last error of the thread,
+ * and passes it to the log handler unless the rate limit has been reached.
+ * The modules of the library report every error through `CENDF_REPORT`.
+ *
+ * @param code The `errno` code of the error.
+ * @param function The name of the reporting function.
+ * @param format A printf format string for the message, followed by its arguments.
+ */
+void cendf_report(int code, const char* function, const char* format, ...)
+#if defined(__GNUC__) || defined (__clang__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+// --------------------------------------------------------------------------------
+
+/**
+ * @macro CENDF_REPORT
+ * @brief Reports an error with the name of the calling function.
+ */
+#define CENDF_REPORT(code, ...) cendf_report((code), __func__, __VA_ARGS__)
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cendf_set_status
+ * @brief Stores a status through an out-parameter that may be NULL.
+ *
+ * @param status Pointer to the status of the caller, or NULL.
+ * @param value The status to store.
+ */
+static inline void cendf_set_status(cendfStatus* status, cendfStatus value) {
+    if (status) *status = value;
+}
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* diagnostics_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -18,6 +18,8 @@
 #include <stdlib.h>   // For size_t
 #include <stdbool.h>  // For bool
 
+#include "diagnostics.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -37,6 +39,12 @@ extern "C" {
  *  - float* energy: Pointer to an array of energy values.
  *  - size_t len: The current number of elements in the arrays.
  *  - size_t alloc: The total allocated capacity of the arrays.
+ *  - bool read_only: true if the arrays are borrowed from another owner.
+ *  - interp_ranges interp: The TAB1 interpolation ranges of the table and the
+ *    precomputed slopes of its logarithmic intervals.
+ *  - log_bins bins: The optional logarithmic search bins of the table.
+ *  - search_tree tree: The optional Eytzinger ordered copy of the energies.
+ *  - xsec_record* packed: The optional interleaved {energy, xs, slope} records.
  */
 typedef struct xsec_t xsec_t;
 // --------------------------------------------------------------------------------
@@ -53,6 +61,42 @@ typedef struct {
     float xs;
     float energy;
 } xsecData;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct xsecHint
+ * @brief Remembers the interval of a table found by the last lookup.
+ *
+ * A hint is a plain value owned by its caller, so each thread keeps its own
+ * hints and no state is shared between threads.  A hint initialized to zero,
+ * or last used with another table, starts from a full search.
+ *
+ * Fields:
+ *  - const xsec_t* table: The table of the last lookup.
+ *  - size_t index: The interval of that table found by the last lookup.
+ */
+typedef struct {
+    const xsec_t* table;
+    size_t index;
+} xsecHint;
+// --------------------------------------------------------------------------------
+
+/**
+ * @enum xsecKernel
+ * @brief The instruction sets with which `interp_xsec_batch` can evaluate a table.
+ *
+ * Values:
+ *  - XSEC_KERNEL_AUTO: The widest kernel the processor supports.
+ *  - XSEC_KERNEL_SCALAR: Portable C, available on every processor.
+ *  - XSEC_KERNEL_SSE: Four SSE2 lanes, on x86 processors.
+ *  - XSEC_KERNEL_AVX2: Eight AVX2 lanes with gathered loads, on x86 processors that support AVX2.
+ */
+typedef enum {
+    XSEC_KERNEL_AUTO,
+    XSEC_KERNEL_SCALAR,
+    XSEC_KERNEL_SSE,
+    XSEC_KERNEL_AVX2
+} xsecKernel;
 // ================================================================================
 // ================================================================================
 
@@ -68,6 +112,22 @@ typedef struct {
 xsec_t* init_xsec(size_t buffer_length);
 // --------------------------------------------------------------------------------
 
+/**
+ * @function init_xsec_view
+ * @brief Creates a read-only `xsec_t` structure over arrays owned elsewhere.
+ *
+ * No data is copied.  The arrays must outlive the view, `push_xsec` fails on a
+ * view, and `free_xsec` frees only the structure itself.
+ *
+ * @param xs Pointer to an array of `len` cross-section values.
+ * @param energy Pointer to an array of `len` energy values in ascending order.
+ * @param len The number of elements in each array.
+ * @return A pointer to the `xsec_t` view, or NULL on failure (sets `errno` to
+ *         EINVAL for NULL arrays or ENOMEM if allocation fails).
+ */
+xsec_t* init_xsec_view(const float* xs, const float* energy, size_t len);
+// --------------------------------------------------------------------------------
+
 /**
  * @function push_xsec
  * @brief Appends a cross-section and energy value to the `xsec` structure.
@@ -77,7 +137,8 @@ xsec_t* init_xsec(size_t buffer_length);
  * @param cross_section Pointer to the `xsec_t` structure.
  * @param xsec The cross-section value to append.
  * @param energy The energy value to append.
- * @return true on success, false on failure (sets `errno` to ENOMEM or EINVAL).
+ * @return true on success, false on failure (sets `errno` to ENOMEM, EINVAL, or
+ *         EPERM if the structure is a read-only view or has interpolation ranges).
  */
 bool push_xsec(xsec_t* cross_section, float xsec, float energy);
 // --------------------------------------------------------------------------------
@@ -93,6 +154,22 @@ bool push_xsec(xsec_t* cross_section, float xsec, float energy);
 const float get_xsec(const xsec_t* cross_section, size_t index);
 // --------------------------------------------------------------------------------
 
+/**
+ * @function get_xsec_status
+ * @brief Retrieves a cross section as `get_xsec`, reporting failure only through `status`.
+ *
+ * Like every `_status` function, it neither logs, sets `errno`, nor records
+ * the last error of the thread, so it is safe to call at any rate.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param index The index of the desired cross-section value.
+ * @param status Set to CENDF_STATUS_OK, or CENDF_STATUS_INVALID if the pointer
+ *               is NULL or the index is out of bounds.  May be NULL.
+ * @return The cross-section value at the given index, or -1.0f on error.
+ */
+const float get_xsec_status(const xsec_t* cross_section, size_t index, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
 /**
  * @function get_xsec_energy
  * @brief Retrieves the energy value at a specified index.
@@ -104,6 +181,20 @@ const float get_xsec(const xsec_t* cross_section, size_t index);
 const float get_xsec_energy(const xsec_t* cross_section, size_t index);
 // --------------------------------------------------------------------------------
 
+/**
+ * @function get_xsec_energy_status
+ * @brief Retrieves an energy as `get_xsec_energy`, reporting failure only through `status`.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param index The index of the desired energy value.
+ * @param status Set to CENDF_STATUS_OK, or CENDF_STATUS_INVALID if the pointer
+ *               is NULL or the index is out of bounds.  May be NULL.
+ * @return The energy value at the given index, or -1.0f on error.
+ */
+const float get_xsec_energy_status(const xsec_t* cross_section, size_t index,
+                                   cendfStatus* status);
+// --------------------------------------------------------------------------------
+
 /**
  * @function get_xsec_data
  * @brief Retrieves a pair of cross-section and energy values at a specified index.
@@ -150,13 +241,17 @@ const float* get_xsec_enArray(const xsec_t* xsec);
  *
  * @details
  * - If the `energy` matches an exact value in the `.energy` array of `xsec`,
- *   the corresponding `.xs` value is returned.
+ *   the corresponding `.xs` value is returned.  An energy listed twice, as
+ *   at an absorption edge, takes the value above the edge.
  * - If the `energy` lies between two values, the function interpolates the
- *   cross-section using linear interpolation.
+ *   cross-section with the ENDF interpolation law of that interval, as set by
+ *   `set_xsec_interpolation`.  Tables without interpolation ranges use linear
+ *   interpolation.
  * - If `xsec` or its `.energy` or `.xs` attributes are `NULL`, the function sets
- *   `errno` to `EINVAL`, logs an error to `stderr`, and returns -1.0f.
+ *   `errno` to `EINVAL`, reports an error through `cendf_report`, and returns -1.0f.
  * - If the energy is out of bounds, the function sets `errno` to `ERANGE`,
- *   logs an error to `stderr`, and returns -1.0f.
+ *   reports an error through `cendf_report`, and returns -1.0f.  Callers that
+ *   expect energies out of range should use `interp_xsec_status`.
  *
  * @note The function assumes that the `.energy` array in `xsec` is sorted
  *       in ascending order.
@@ -164,6 +259,347 @@ const float* get_xsec_enArray(const xsec_t* xsec);
 const float interp_xsec(const xsec_t* cross_section, float energy);
 // -------------------------------------------------------------------------------- 
 
+/**
+ * @function interp_xsec_status
+ * @brief Interpolates a cross section as `interp_xsec`, reporting failure only through `status`.
+ *
+ * No text is formatted, `errno` is left alone and nothing is logged, so an
+ * energy out of range costs two comparisons.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energy The energy at which to interpolate.
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if a pointer is
+ *               NULL or the table is empty, or CENDF_STATUS_RANGE if the
+ *               energy lies outside of the table.  May be NULL.
+ * @return The cross section, or -1.0f on error.
+ */
+const float interp_xsec_status(const xsec_t* cross_section, float energy, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_xsec_hint
+ * @brief Interpolates a cross section, starting the search from a hint.
+ *
+ * Successive energies of a particle are close to each other: a photon that
+ * Compton scatters only loses energy, often a little at a time.  Rather than
+ * searching the whole table, the lookup first tests the interval in `hint`
+ * and then steps away from it by 1, 2, 4, ... points until the energy is
+ * bracketed, so an energy in the same or a nearby interval costs a few
+ * probes.  The hint is updated with the interval found.  Results equal
+ * those of `interp_xsec`.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energy The energy at which to interpolate.
+ * @param hint Pointer to the hint of this table, updated on success.
+ * @return The cross section, or -1.0f on error.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or the table is empty.
+ * - ERANGE: The energy lies outside of the table; the hint is unchanged.
+ */
+const float interp_xsec_hint(const xsec_t* cross_section, float energy, xsecHint* hint);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_xsec_hint_status
+ * @brief Interpolates from a hint as `interp_xsec_hint`, reporting failure only through `status`.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energy The energy at which to interpolate.
+ * @param hint Pointer to the hint of this table, updated on success.
+ * @param status Set as by `interp_xsec_status`.  May be NULL.
+ * @return The cross section, or -1.0f on error.
+ */
+const float interp_xsec_hint_status(const xsec_t* cross_section, float energy, xsecHint* hint,
+                                   cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_xsec_interpolation
+ * @brief Sets the TAB1 interpolation ranges of a fully populated table.
+ *
+ * Range `i` applies the ENDF interpolation law `law[i]` to every interval
+ * that ends at or before the 1-based point `nbt[i]`.  The supported laws are
+ * histogram (1), lin-lin (2), lin-log (3), log-lin (4) and log-log (5).  The
+ * slope of every logarithmic interval is computed here, so `interp_xsec`
+ * evaluates such an interval with at most one log and one exp.  Logarithmic
+ * intervals with a zero or negative end point are interpolated lin-lin.
+ * Once a table has ranges, `push_xsec` fails with EPERM.  Ranges may also be
+ * set on a view, in which case they are owned by the view.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param nbt Array of `nr` ascending 1-based point numbers, the last of which
+ *            must equal the number of points in the table.
+ * @param law Array of `nr` interpolation laws.
+ * @param nr The number of interpolation ranges.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, or the ranges do not describe the table.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool set_xsec_interpolation(xsec_t* cross_section, const size_t* nbt, const int* law,
+                            size_t nr);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_xsec_interpolation
+ * @brief Retrieves the interpolation ranges of a table.
+ *
+ * Tables that are lin-lin throughout are stored without ranges.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param nbt Set to the array of range boundaries, if not NULL.
+ * @param law Set to the array of interpolation laws, if not NULL.
+ * @return The number of ranges, or 0 if the table is lin-lin throughout or
+ *         the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t get_xsec_interpolation(const xsec_t* cross_section, const size_t** nbt, const int** law);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function thin_xsec
+ * @brief Removes the points of a table that its interpolation law reproduces within a tolerance.
+ *
+ * Starting from each point that is kept, the next point kept is the farthest
+ * one whose chord, evaluated with the interpolation law of the table,
+ * reproduces every point it skips within `tolerance` times the magnitude of
+ * that point.  The farthest point is found by doubling the length of the
+ * chord and then bisecting.  The first and last points, both points of a
+ * repeated energy, as at an absorption edge, and the last point of every
+ * interpolation range are always kept, so edges stay exact and the ranges
+ * keep their laws.  The arrays are reallocated to the points that remain.
+ * Search bins and the search tree describe the old energies and are
+ * discarded, as by `push_xsec`, and must be built again if they are wanted.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param tolerance The largest relative error allowed at a removed point, e.g. 0.001 for 0.1%.
+ * @param removed Set to the number of points removed.  May be NULL.
+ * @return true on success, false otherwise, in which case the table is unchanged.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL or the tolerance is negative or NaN.
+ * - EPERM: The table is a view or has been packed.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool thin_xsec(xsec_t* cross_section, float tolerance, size_t* removed);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function build_xsec_bins
+ * @brief Builds logarithmic search bins that accelerate energy lookups.
+ *
+ * The range from the first to the last energy of the table is split into
+ * `num_bins` bins of equal width in log(E), and each bin stores the range of
+ * points it covers.  `interp_xsec` and `find_xsec_interval` then hash an
+ * energy to its bin and search only the points of that bin instead of the
+ * whole table.  With a few bins per thousand points, a bin typically holds a
+ * handful of points.  The bins cost `4 * (num_bins + 1)` bytes, are rebuilt
+ * by calling this function again, and are discarded by `push_xsec`.  Bins
+ * may also be built on a view, in which case they are owned by the view.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param num_bins The number of bins.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL, `num_bins` is zero, the table has fewer than
+ *   two distinct energies, or its first energy is not positive.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool build_xsec_bins(xsec_t* cross_section, size_t num_bins);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_bins
+ * @brief Retrieves the number of logarithmic search bins of a table.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @return The number of bins, or 0 if the table has none or the pointer is
+ *         NULL (sets `errno` to EINVAL).
+ */
+size_t xsec_bins(const xsec_t* cross_section);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function build_xsec_tree
+ * @brief Builds a cache-friendly search tree over the energies of a table.
+ *
+ * The tree is a copy of the energies in Eytzinger order: the breadth-first
+ * order of a complete binary search tree, so the levels near the root that
+ * every search visits share a few cache lines.  `interp_xsec` and
+ * `find_xsec_interval` then descend it without branches, fetching the
+ * nodes four levels below the current one ahead of time.  The cross section
+ * values stay in their arrays.  The tree costs four bytes per point, is
+ * used instead of any logarithmic bins, and is discarded by `push_xsec`, so
+ * it is best built once a table is complete.  A tree may also be built on a
+ * view, in which case it is owned by the view.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL or the table has fewer than two points.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool build_xsec_tree(xsec_t* cross_section);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_has_tree
+ * @brief Reports whether a table has a search tree.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @return true if `build_xsec_tree` has been called since the last change to
+ *         the table, false otherwise or if the pointer is NULL (sets `errno` to EINVAL).
+ */
+bool xsec_has_tree(const xsec_t* cross_section);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function pack_xsec
+ * @brief Finalizes a lin-lin table into interleaved {energy, xs, slope} records.
+ *
+ * Each point is stored with its cross section and the slope of the interval
+ * that starts at it in one sixteen byte record, and the records are aligned
+ * so that none straddles two cache lines.  Once the search has found an
+ * interval, `interp_xsec` reads a single record and evaluates it with one
+ * multiply-add instead of reading both arrays and dividing.  The slopes are
+ * computed in double precision, so results agree with an unpacked table to
+ * within rounding.  The `xs` and `energy` arrays are kept for the accessors,
+ * and the search still uses the energy array or the search structures of the
+ * table.  A packed table is read-only: `push_xsec` and
+ * `set_xsec_interpolation` fail with EPERM.  Packing a packed table does
+ * nothing.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL, the table has fewer than two points, or it
+ *   has interpolation ranges.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool pack_xsec(xsec_t* cross_section);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_is_packed
+ * @brief Reports whether a table has been packed with `pack_xsec`.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @return true if the table is packed, false otherwise or if the pointer is
+ *         NULL (sets `errno` to EINVAL).
+ */
+bool xsec_is_packed(const xsec_t* cross_section);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function find_xsec_interval
+ * @brief Locates the interval of a table that contains an energy.
+ *
+ * The search uses the search tree of the table when it has been built, then
+ * its logarithmic bins, and a binary search over the whole table otherwise.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energy The energy to locate.
+ * @param index Set to the index `i` of the last point with an energy at or
+ *              below `energy`, limited to `xsec_size - 2`, so that the
+ *              energy lies between points `i` and `i + 1`.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: The energy lies outside of the table, or the table has fewer than two points.
+ */
+bool find_xsec_interval(const xsec_t* cross_section, float energy, size_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_xsec_batch
+ * @brief Interpolates a cross section at an array of energies.
+ *
+ * The table is checked once per call rather than once per energy, and the
+ * energies are searched in groups of eight whose binary searches advance in
+ * step, so the memory latency of one search overlaps that of the others.
+ * Lin-lin tables are then interpolated in vector lanes with the widest
+ * kernel the processor supports.  Tables with other interpolation laws are
+ * searched the same way and interpolated one energy at a time.  The results
+ * equal those of `interp_xsec`.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energies Array of `n` energies.
+ * @param out Array of `n` values to fill.  An energy outside of the table
+ *            gives -1.0f, and the other energies are still evaluated.
+ * @param n The number of energies.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or the table is empty.
+ * - ERANGE: At least one energy lies outside of the table.
+ */
+bool interp_xsec_batch(const xsec_t* cross_section, const float* energies, float* out, size_t n);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_xsec_batch_kernel
+ * @brief Interpolates a cross section at an array of energies with a chosen kernel.
+ *
+ * Behaves as `interp_xsec_batch`, which calls it with XSEC_KERNEL_AUTO.
+ * Forcing a kernel is mostly of use for testing and benchmarking.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energies Array of `n` energies.
+ * @param out Array of `n` values to fill.
+ * @param n The number of energies.
+ * @param kernel The kernel to use.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, the table is empty, or the kernel is unknown.
+ * - ENOTSUP: The processor does not support the kernel.
+ * - ERANGE: At least one energy lies outside of the table.
+ */
+bool interp_xsec_batch_kernel(const xsec_t* cross_section, const float* energies, float* out,
+                              size_t n, xsecKernel kernel);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_batch_kernel
+ * @brief Retrieves the kernel that `interp_xsec_batch` uses on this processor.
+ *
+ * @return XSEC_KERNEL_AVX2, XSEC_KERNEL_SSE or XSEC_KERNEL_SCALAR.
+ */
+xsecKernel xsec_batch_kernel(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_xsec_sorted
+ * @brief Interpolates a cross section at an ascending array of energies.
+ *
+ * The energy grid of the table and the array of energies are walked together
+ * in one pass, so the cost is proportional to the number of points plus the
+ * number of energies and both arrays are read in order.  This suits energy
+ * sweeps and spectrum folding; for unordered energies use `interp_xsec_batch`.
+ * The results equal those of `interp_xsec_batch`.
+ *
+ * @param cross_section Pointer to the `xsec_t` structure.
+ * @param energies Array of `n` energies in ascending order.  Repeated
+ *                 energies are allowed.
+ * @param out Array of `n` values to fill.  An energy outside of the table
+ *            gives -1.0f, and the other energies are still evaluated.
+ * @param n The number of energies.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, the table is empty, or the energies are not
+ *   ascending, in which case only the energies before the first that is out
+ *   of order are evaluated.
+ * - ERANGE: At least one energy lies outside of the table.
+ */
+bool interp_xsec_sorted(const xsec_t* cross_section, const float* energies, float* out, size_t n);
+// --------------------------------------------------------------------------------
+
 /**
  * @function xsec_size
  * @brief Retrieves the current number of elements in the `xsec` structure.
@@ -225,6 +661,172 @@ void _free_xsec(xsec_t** cross_section);
 // ================================================================================
 // ================================================================================
 
+/**
+ * @struct form_factor_t
+ * @brief Forward declaration for a tabulated MF27 form factor or scattering function.
+ *
+ * Photo-atomic ENDF files hold the coherent form factor (MT502) and the
+ * incoherent scattering function (MT504) as functions of the momentum
+ * transfer x = sin(theta/2)/lambda in inverse Angstroms, and the anomalous
+ * scattering factors (MT505/MT506) as functions of the incident energy in eV.
+ * The table is immutable once built and is interpolated with the same lookup
+ * as `interp_xsec`.  The data in this struct is encapsulated, preventing a
+ * user from directly accessing it.
+ *
+ * Fields:
+ *  - float* value: Pointer to an array of form factor values.
+ *  - float* x: Pointer to an array of momentum transfers or energies.
+ *  - size_t len: The number of elements in the arrays.
+ *  - int mt: The ENDF reaction number of the table.
+ *  - interp_ranges interp: The TAB1 interpolation ranges of the table.
+ */
+typedef struct form_factor_t form_factor_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_form_factor
+ * @brief Builds a form factor table from copies of two parallel arrays.
+ *
+ * @param value Array of form factor values.
+ * @param x Array of ascending momentum transfers or energies.
+ * @param len The number of elements in each array.
+ * @param mt The ENDF reaction number of the table.
+ * @return A pointer to the `form_factor_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or `len` is zero.
+ * - ENOMEM: Memory allocation failed.
+ */
+form_factor_t* init_form_factor(const float* value, const float* x, size_t len, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_form_factor
+ * @brief Interpolates a form factor table at a momentum transfer or energy.
+ *
+ * Uses the same binary search and interpolation laws as `interp_xsec`.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @param x The momentum transfer (MT502/MT504) or energy (MT505/MT506).
+ * @return The interpolated value, or -1.0f on error.  Since anomalous
+ *         scattering factors may be negative, callers of MT506 tables must
+ *         check `errno` rather than the return value.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL.
+ * - ERANGE: `x` lies outside of the table.
+ */
+const float interp_form_factor(const form_factor_t* form_factor, float x);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_form_factor_status
+ * @brief Interpolates a form factor as `interp_form_factor`, reporting failure only through `status`.
+ *
+ * Since anomalous scattering factors may be negative, the status is the
+ * only reliable sign of failure for MT506 tables.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @param x The momentum transfer (MT502/MT504) or energy (MT505/MT506).
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if the pointer is
+ *               NULL or the table is empty, or CENDF_STATUS_RANGE if `x` lies
+ *               outside of the table.  May be NULL.
+ * @return The interpolated value, or -1.0f on error.
+ */
+const float interp_form_factor_status(const form_factor_t* form_factor, float x,
+                                      cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_form_factor_interpolation
+ * @brief Sets the TAB1 interpolation ranges of a form factor table.
+ *
+ * The ranges are interpreted as in `set_xsec_interpolation`.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @param nbt Array of `nr` ascending 1-based point numbers.
+ * @param law Array of `nr` interpolation laws.
+ * @param nr The number of interpolation ranges.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, or the ranges do not describe the table.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool set_form_factor_interpolation(form_factor_t* form_factor, const size_t* nbt,
+                                   const int* law, size_t nr);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_form_factor
+ * @brief Retrieves the form factor value at a specific index.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @param index The index of the value to retrieve.
+ * @return The value at the index, or -1.0f on error (sets `errno` to EINVAL).
+ */
+const float get_form_factor(const form_factor_t* form_factor, size_t index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_form_factor_x
+ * @brief Retrieves the momentum transfer or energy at a specific index.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @param index The index of the value to retrieve.
+ * @return The value at the index, or -1.0f on error (sets `errno` to EINVAL).
+ */
+const float get_form_factor_x(const form_factor_t* form_factor, size_t index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function form_factor_size
+ * @brief Retrieves the number of points in a form factor table.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @return The number of points, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t form_factor_size(const form_factor_t* form_factor);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function form_factor_mt
+ * @brief Retrieves the ENDF reaction number of a form factor table.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ * @return The MT number, or -1 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+int form_factor_mt(const form_factor_t* form_factor);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_form_factor
+ * @brief Frees all memory associated with a `form_factor_t` structure.
+ *
+ * @param form_factor Pointer to the `form_factor_t` structure.
+ */
+void free_form_factor(form_factor_t* form_factor);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_form_factor
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param form_factor Pointer to a pointer to the `form_factor_t` structure.
+ */
+void _free_form_factor(form_factor_t** form_factor);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined(__clang__)
+    /**
+     * @macro FORM_FACTOR_GBC
+     * @brief A macro for enabling automatic cleanup of form_factor_t objects.
+     */
+    #define FORM_FACTOR_GBC __attribute__((cleanup(_free_form_factor)))
+#endif
+// ================================================================================
+// ================================================================================
+
 /**
  * @struct xsec
  * @brief Forward declaration for a dynamic data structure for storing strings.
@@ -544,6 +1146,19 @@ float pop_any_vector(vector_t* vec, size_t index);
 const float get_vector(const vector_t* vec, size_t index);
 // --------------------------------------------------------------------------------
 
+/**
+ * @function get_vector_status
+ * @brief Retrieves an element as `get_vector`, reporting failure only through `status`.
+ *
+ * @param vec A pointer to the vector_t object.
+ * @param index The index of the element to retrieve.
+ * @param status Set to CENDF_STATUS_OK, or CENDF_STATUS_INVALID if the pointer
+ *               is NULL or the index is out of bounds.  May be NULL.
+ * @return The float value at the specified index, or FLT_MAX on error.
+ */
+const float get_vector_status(const vector_t* vec, size_t index, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
 /**
  * @function vector_size
  * @brief Retrieves the current number of elements in the vector.
@@ -677,11 +1292,25 @@ float pop_dict(dict_t* dict,  char* key);
  *
  * @param dict Pointer to the dictionary.
  * @param key The key to search for.
- * @return The value associated with the key, or FLT_MAX if the key is not found.
+ * @return The value associated with the key, or FLT_MAX if the key is not
+ *         found (sets `errno` to ENODATA).
  */
 const float get_dict_value(const dict_t* dict, char* key);
 // --------------------------------------------------------------------------------
 
+/**
+ * @function get_dict_value_status
+ * @brief Retrieves a value as `get_dict_value`, reporting failure only through `status`.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to search for.
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if a pointer is
+ *               NULL, or CENDF_STATUS_NO_DATA if the key is not found.  May be NULL.
+ * @return The value associated with the key, or FLT_MAX on error.
+ */
+const float get_dict_value_status(const dict_t* dict, char* key, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Frees the memory associated with the dictionary.
  *
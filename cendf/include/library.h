@@ -0,0 +1,465 @@
+// ================================================================================
+// ================================================================================
+// - File:    library.h
+// - Purpose: Library index and parallel loading of directories of ENDF files
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef library_H
+#define library_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "read_file.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct librarySection
+ * @brief Describes one (MF, MT) section of a material in a library index.
+ *
+ * Fields:
+ *  - int mf: The ENDF file number of the section.
+ *  - int mt: The ENDF reaction number of the section.
+ *  - size_t offset: The byte offset of the HEAD record of the section.
+ *  - size_t np: The number of (energy, value) pairs for TAB1 sections, 0 otherwise.
+ *  - float emin: The first energy of a TAB1 section, 0 otherwise.
+ *  - float emax: The last energy of a TAB1 section, 0 otherwise.
+ */
+typedef struct {
+    int mf;
+    int mt;
+    size_t offset;
+    size_t np;
+    float emin;
+    float emax;
+} librarySection;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct libraryMaterial
+ * @brief Describes one material (one ENDF file) in a library index.
+ *
+ * Fields:
+ *  - const char* file_name: The full path to the ENDF file of the material.
+ *  - float za: The ZA identifier of the material (1000 * Z + A).
+ *  - float awr: The atomic weight ratio of the material to the neutron.
+ *  - int mat: The ENDF MAT number of the material.
+ *  - size_t num_sections: The number of sections listed for the material.
+ *  - const librarySection* sections: The sections in directory order.
+ */
+typedef struct {
+    const char* file_name;
+    float za;
+    float awr;
+    int mat;
+    size_t num_sections;
+    const librarySection* sections;
+} libraryMaterial;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct library_index_t
+ * @brief Forward declaration for an index of every material in an ENDF directory.
+ *
+ * The index is loaded from a sidecar file written by `build_library_index`,
+ * so that the location, size and energy range of any section can be found
+ * without opening the ENDF files themselves.  The data in this struct is
+ * encapsulated, preventing a user from directly accessing it.
+ */
+typedef struct library_index_t library_index_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct libraryTable
+ * @brief Describes one cross section table held by a loaded library.
+ *
+ * Fields:
+ *  - float za: The ZA identifier of the material (1000 * Z + A).
+ *  - float awr: The atomic weight ratio of the material to the neutron.
+ *  - int mat: The ENDF MAT number of the material.
+ *  - int mf: The ENDF file number of the table.
+ *  - int mt: The ENDF reaction number of the table.
+ *  - const xsec_t* xsec: The table data, owned by the library.
+ */
+typedef struct {
+    float za;
+    float awr;
+    int mat;
+    int mf;
+    int mt;
+    const xsec_t* xsec;
+} libraryTable;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct loadResult
+ * @brief Reports the outcome of loading one file into a library.
+ *
+ * Fields:
+ *  - const char* file_name: The path of the file, or NULL if an element
+ *    requested from a library index has no file.
+ *  - int error: 0 if the file was loaded, otherwise an errno value.
+ *  - double seconds: The wall clock time spent loading the file.
+ *  - size_t num_tables: The number of tables read from the file.
+ */
+typedef struct {
+    const char* file_name;
+    int error;
+    double seconds;
+    size_t num_tables;
+} loadResult;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct xsec_library_t
+ * @brief Forward declaration for a set of cross section tables loaded from many files.
+ *
+ * The library owns every `xsec_t` it holds.  Tables are sorted by ZA, MF and
+ * MT, and the outcome of loading each file is kept in a result array.  The
+ * data in this struct is encapsulated, preventing a user from directly
+ * accessing it.
+ */
+typedef struct xsec_library_t xsec_library_t;
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function build_library_index
+ * @brief Scans every `.endf` file in a directory and writes a library index file.
+ *
+ * The files are indexed in parallel from their MF1/MT451 directories.  For
+ * each material the index records ZA, AWR and MAT, and for each section the
+ * byte offset, the number of points and the energy range.  The size and
+ * modification time of every file are stored so that `library_index_stale`
+ * can detect changes to the directory.  Files that cannot be indexed are
+ * reported to `stderr` and left out of the index.  The index file is written
+ * to a temporary name and renamed into place, so readers never see a
+ * partially written index.
+ *
+ * @param directory The directory holding the ENDF files.
+ * @param index_file The path of the index file to write.
+ * @param num_threads The number of worker threads, or 0 to use one per processor.
+ * @return true if the index file was written, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ENOENT: The directory cannot be opened.
+ * - ENODATA: The directory holds no ENDF file that could be indexed.
+ * - ENOMEM: Memory allocation failed.
+ * - EIO: The index file could not be written.
+ */
+bool build_library_index(const char* directory, const char* index_file, size_t num_threads);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function open_library_index
+ * @brief Loads a library index file written by `build_library_index`.
+ *
+ * @param index_file The path of the index file.
+ * @return A pointer to a `library_index_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The index file is damaged or has an unsupported format version.
+ * - ENOENT: The index file cannot be opened.
+ * - ENOMEM: Memory allocation failed.
+ */
+library_index_t* open_library_index(const char* index_file);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function library_index_stale
+ * @brief Checks whether a library index still describes its directory.
+ *
+ * The index is stale if any indexed file has been removed or has a different
+ * size or modification time, or if the number of `.endf` files in the
+ * directory has changed since the index was built.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @return true if the index should be rebuilt, false otherwise.
+ */
+bool library_index_stale(const library_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function library_index_size
+ * @brief Returns the number of materials in a library index.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @return The number of materials, or 0 if the pointer is NULL.
+ */
+size_t library_index_size(const library_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_library_materials
+ * @brief Returns the materials of a library index, sorted by ZA.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @return A pointer to the array of materials, or NULL if the pointer is NULL.
+ */
+const libraryMaterial* get_library_materials(const library_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function find_library_material
+ * @brief Finds the material with a given atomic number.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @param z The atomic number of the material.
+ * @return A pointer to the material, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The index pointer is NULL.
+ * - ENODATA: The library does not hold the material.
+ */
+const libraryMaterial* find_library_material(const library_index_t* index, int z);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function find_library_section
+ * @brief Finds a section of the material with a given atomic number.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @param z The atomic number of the material.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return A pointer to the section, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The index pointer is NULL.
+ * - ENODATA: The library does not hold the material or the section.
+ */
+const librarySection* find_library_section(const library_index_t* index, int z, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function library_amu
+ * @brief Returns the atomic mass of a material without opening its ENDF file.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @param z The atomic number of the material.
+ * @param neutron_mass The mass of a neutron in atomic mass units (amu).
+ * @return The atomic mass in amu, or -1.0f on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The index pointer is NULL.
+ * - ENODATA: The library does not hold the material.
+ */
+float library_amu(const library_index_t* index, int z, const float neutron_mass);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function load_xsec_library
+ * @brief Loads every TAB1 table of a list of ENDF files on a pool of threads.
+ *
+ * Each file is one task, and `num_threads` workers take tasks until every
+ * file has been read.  A file that cannot be read does not stop the others;
+ * its error is recorded in the result array returned by `get_load_results`,
+ * and nothing is written to `stderr` for it.  If two files hold the same
+ * material, lookups return the tables of the file listed first.
+ *
+ * @param file_names An array of paths to ENDF files.
+ * @param num_files The number of paths in `file_names`.
+ * @param num_threads The number of worker threads, or 0 to use one per processor.
+ * @return A pointer to an `xsec_library_t` structure, or NULL if the arguments
+ *         are invalid or memory cannot be allocated.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ENOMEM: Memory allocation failed.
+ */
+xsec_library_t* load_xsec_library(const char* const* file_names, size_t num_files,
+                                  size_t num_threads);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function load_xsec_directory
+ * @brief Loads every `.endf` file in a directory on a pool of threads.
+ *
+ * @param directory The directory holding the ENDF files.
+ * @param num_threads The number of worker threads, or 0 to use one per processor.
+ * @return A pointer to an `xsec_library_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The directory pointer is NULL.
+ * - ENOENT: The directory cannot be opened.
+ * - ENOMEM: Memory allocation failed.
+ */
+xsec_library_t* load_xsec_directory(const char* directory, size_t num_threads);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function load_xsec_elements
+ * @brief Loads the files of a list of elements found through a library index.
+ *
+ * The result array holds one entry per requested element, in the order of
+ * `z`.  An element that is not in the index is reported with a NULL file name
+ * and an error of ENODATA.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ * @param z An array of atomic numbers.
+ * @param num_z The number of atomic numbers in `z`.
+ * @param num_threads The number of worker threads, or 0 to use one per processor.
+ * @return A pointer to an `xsec_library_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ENOMEM: Memory allocation failed.
+ */
+xsec_library_t* load_xsec_elements(const library_index_t* index, const int* z, size_t num_z,
+                                   size_t num_threads);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_library_size
+ * @brief Returns the number of tables in a loaded library.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ * @return The number of tables, or 0 if the pointer is NULL.
+ */
+size_t xsec_library_size(const xsec_library_t* library);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_library_tables
+ * @brief Returns the tables of a loaded library, sorted by ZA, MF and MT.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ * @return A pointer to the array of tables, or NULL if the pointer is NULL.
+ */
+const libraryTable* get_library_tables(const xsec_library_t* library);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_library_xsec
+ * @brief Finds a table of the material with a given atomic number.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ * @param z The atomic number of the material.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return The table, or NULL on failure.  The table is owned by the library
+ *         and must not be freed by the caller.
+ *
+ * Possible errors:
+ * - EINVAL: The library pointer is NULL.
+ * - ENODATA: The library does not hold the table.
+ */
+const xsec_t* get_library_xsec(const xsec_library_t* library, int z, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function thin_xsec_library
+ * @brief Thins every table of a loaded library with `thin_xsec`.
+ *
+ * No other thread may use the library while it is thinned.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ * @param tolerance The largest relative error allowed at a removed point.
+ * @param removed Set to the number of points removed from all tables.  May be NULL.
+ * @return true on success, false otherwise.  Tables thinned before a failure stay thinned.
+ *
+ * Possible errors:
+ * - EINVAL: The library pointer is NULL or the tolerance is negative or NaN.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool thin_xsec_library(xsec_library_t* library, float tolerance, size_t* removed);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function xsec_library_files
+ * @brief Returns the number of entries in the result array of a loaded library.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ * @return The number of results, or 0 if the pointer is NULL.
+ */
+size_t xsec_library_files(const xsec_library_t* library);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_load_results
+ * @brief Returns the outcome of loading each file, in the order the files were given.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ * @return A pointer to the array of results, or NULL if the pointer is NULL.
+ */
+const loadResult* get_load_results(const xsec_library_t* library);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_xsec_library
+ * @brief Frees every table and result held by a loaded library.
+ *
+ * @param library Pointer to the `xsec_library_t` structure.
+ */
+void free_xsec_library(xsec_library_t* library);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_xsec_library
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param library Pointer to a pointer to the `xsec_library_t` structure.
+ */
+void _free_xsec_library(xsec_library_t** library);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_library_index
+ * @brief Frees all memory associated with a library index.
+ *
+ * @param index Pointer to the `library_index_t` structure.
+ */
+void free_library_index(library_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_library_index
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param index Pointer to a pointer to the `library_index_t` structure.
+ */
+void _free_library_index(library_index_t** index);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro LIBRARY_INDEX_GBC
+     * @brief A macro for enabling automatic cleanup of library_index_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_library_index`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define LIBRARY_INDEX_GBC __attribute__((cleanup(_free_library_index)))
+
+    /**
+     * @macro XSEC_LIBRARY_GBC
+     * @brief A macro for enabling automatic cleanup of xsec_library_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_xsec_library`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define XSEC_LIBRARY_GBC __attribute__((cleanup(_free_xsec_library)))
+#endif
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* library_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,144 @@
+// ================================================================================
+// ================================================================================
+// - File:    material.h
+// - Purpose: Material handles that read cross sections on first use
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef material_H
+#define material_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "read_file.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct material_t
+ * @brief Forward declaration for a handle to the cross sections of one material.
+ *
+ * Opening a material only indexes its ENDF file.  Each TAB1 section is parsed
+ * into an `xsec_t` the first time it is requested and kept for the life of the
+ * handle, so reactions that are never requested cost neither parse time nor
+ * memory.  A handle may be shared by many threads.  The data in this struct
+ * is encapsulated, preventing a user from directly accessing it.
+ */
+typedef struct material_t material_t;
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function open_material
+ * @brief Opens a material handle from the MF1/MT451 directory of an ENDF file.
+ *
+ * No cross section is read until it is requested with `get_material_xsec`.
+ *
+ * @param file_name The path to the ENDF file.
+ * @return A pointer to a `material_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The file name is NULL, or the file does not begin with a readable directory.
+ * - ENOENT: The file cannot be opened or mapped.
+ * - ENOMEM: Memory allocation failed.
+ */
+material_t* open_material(const char* file_name);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_material_xsec
+ * @brief Returns a cross section of a material, reading it on first use.
+ *
+ * The first request for a section parses it and publishes the result; later
+ * requests return the same table without locking.  Concurrent first requests
+ * for the same section parse it once, while requests for different sections
+ * proceed in parallel.  A section that cannot be read fails the same way on
+ * every request without being parsed again.
+ *
+ * @param material Pointer to the `material_t` structure.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return The table, or NULL on failure.  The table is owned by the material
+ *         and must not be freed by the caller.
+ *
+ * Possible errors:
+ * - EINVAL: The material pointer is NULL, or the section is not a TAB1 section.
+ * - ENODATA: The section is not listed in the directory.
+ * - ENOMEM: Memory allocation failed.
+ */
+const xsec_t* get_material_xsec(material_t* material, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_material_index
+ * @brief Returns the section index of a material.
+ *
+ * The index supplies ZA, AWR, MAT and the location of every section.
+ *
+ * @param material Pointer to the `material_t` structure.
+ * @return A pointer to the `endf_index_t` structure, or NULL if the pointer is NULL.
+ */
+const endf_index_t* get_material_index(const material_t* material);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function material_loaded_tables
+ * @brief Returns the number of sections of a material that have been read.
+ *
+ * @param material Pointer to the `material_t` structure.
+ * @return The number of tables held in memory, or 0 if the pointer is NULL.
+ */
+size_t material_loaded_tables(const material_t* material);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_material
+ * @brief Frees a material handle and every table it has read.
+ *
+ * No other thread may use the handle while it is freed.
+ *
+ * @param material Pointer to the `material_t` structure.
+ */
+void free_material(material_t* material);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_material
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param material Pointer to a pointer to the `material_t` structure.
+ */
+void _free_material(material_t** material);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro MATERIAL_GBC
+     * @brief A macro for enabling automatic cleanup of material_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_material`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define MATERIAL_GBC __attribute__((cleanup(_free_material)))
+#endif
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* material_H */
+// ================================================================================
+// ================================================================================
+// eof
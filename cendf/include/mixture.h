@@ -0,0 +1,273 @@
+// ================================================================================
+// ================================================================================
+// - File:    mixture.h
+// - Purpose: Macroscopic cross sections of compounds, alloys and other mixtures
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef mixture_H
+#define mixture_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "union_grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @brief Avogadro's number in atoms per mole.
+ */
+#define CENDF_AVOGADRO 6.02214076e23
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief The mass of a neutron in atomic mass units (amu), which converts the
+ *        AWR of an ENDF material into its atomic weight.
+ */
+#define CENDF_NEUTRON_MASS 1.00866491595
+// --------------------------------------------------------------------------------
+
+/**
+ * @enum mixtureBasis
+ * @brief How the fractions of the components of a mixture are given.
+ *
+ * Values:
+ *  - MIXTURE_MASS_FRACTION: Each fraction is a share of the mass of the mixture.
+ *  - MIXTURE_ATOM_FRACTION: Each fraction is a share of the atoms of the mixture,
+ *    as the subscripts of a chemical formula.
+ */
+typedef enum {
+    MIXTURE_MASS_FRACTION,
+    MIXTURE_ATOM_FRACTION
+} mixtureBasis;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct mixtureComponent
+ * @brief Describes one element of a mixture.
+ *
+ * The fractions of a mixture need not sum to one, since they are normalized
+ * by their sum.
+ *
+ * Fields:
+ *  - material_t* material: The cross sections of the element.
+ *  - float atomic_weight: The atomic weight of the element in g/mol, as given by
+ *    `element_weight`, or 0 to use the AWR of the material times `CENDF_NEUTRON_MASS`,
+ *    as `read_amu` does.
+ *  - float fraction: The mass or atom fraction of the element.
+ */
+typedef struct {
+    material_t* material;
+    float atomic_weight;
+    float fraction;
+} mixtureComponent;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct mixture_t
+ * @brief Forward declaration for the precomputed macroscopic cross sections of one mixture.
+ *
+ * The microscopic cross sections of every component are unionized onto one
+ * energy grid, and each reaction is summed over the components with the atom
+ * density of each, so a lookup is a single interpolation on one grid instead
+ * of one lookup and one weighted sum per component.  The data in this struct
+ * is encapsulated, preventing a user from directly accessing it.
+ */
+typedef struct mixture_t mixture_t;
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function build_mixture
+ * @brief Builds the macroscopic cross sections of a mixture for a list of reactions.
+ *
+ * The tables of every component are read through `get_material_xsec` and
+ * must be given in barns per atom, as the ENDF photo-atomic sublibrary is.
+ * Reaction `i` of the mixture is the sum over the components of their atom
+ * density times MF/MT `mt[i]`, in 1/cm.  A component is zero outside of
+ * the energy range of its own table, as for `init_union_grid`.  With a
+ * density of 1 g/cm^3 the values are mass attenuation coefficients in cm^2/g.
+ *
+ * @param components Array of `num_components` elements of the mixture.
+ * @param num_components The number of elements.
+ * @param basis Whether the fractions are mass or atom fractions.
+ * @param density The density of the mixture in g/cm^3.
+ * @param mf The ENDF file number shared by the reactions (e.g. 23).
+ * @param mt Array of `num_mt` ENDF reaction numbers.
+ * @param num_mt The number of reactions.
+ * @return A pointer to a `mixture_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, a count is zero, the density is not positive,
+ *   a fraction or atomic weight is negative, the fractions sum to zero, or the
+ *   atomic weight of a component is unknown.
+ * - ENODATA: A reaction is not in a component.
+ * - ENOMEM: Memory allocation failed.
+ */
+mixture_t* build_mixture(const mixtureComponent* components, size_t num_components,
+                         mixtureBasis basis, float density, int mf, const int* mt,
+                         size_t num_mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_mixture
+ * @brief Evaluates every macroscopic cross section of a mixture at one energy.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @param energy The energy at which to evaluate the reactions.
+ * @param xs Array of `mixture_reactions(mixture)` values to fill in 1/cm, in
+ *           the order of the reactions the mixture was built with.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: The energy lies outside of the grid of the mixture.
+ */
+bool interp_mixture(const mixture_t* mixture, float energy, float* xs);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_mixture_status
+ * @brief Evaluates a mixture as `interp_mixture`, reporting failure only through `status`.
+ *
+ * It neither logs nor sets `errno`, so it is safe to call at any rate.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @param energy The energy at which to evaluate the reactions.
+ * @param xs Array of values to fill, as for `interp_mixture`.
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if a pointer is
+ *               NULL, or CENDF_STATUS_RANGE if the energy lies outside of the
+ *               grid.  May be NULL.
+ * @return true on success, false otherwise.
+ */
+bool interp_mixture_status(const mixture_t* mixture, float energy, float* xs,
+                           cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_mixture_batch
+ * @brief Evaluates every macroscopic cross section of a mixture at an array of energies.
+ *
+ * The energies are searched as by `interp_union_grid_batch`, and each row
+ * equals the values of `interp_mixture` at the same energy.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @param energies Array of `n` energies.
+ * @param xs Array of `n` rows of `mixture_reactions(mixture)` values to fill
+ *           in 1/cm.  The row of an energy outside of the grid is filled with
+ *           -1, and the other rows are still evaluated.
+ * @param n The number of energies.
+ * @return true if every energy lies on the grid, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: At least one energy lies outside of the grid.
+ */
+bool interp_mixture_batch(const mixture_t* mixture, const float* energies, float* xs,
+                          size_t n);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function mixture_reactions
+ * @brief Retrieves the number of reactions of a mixture.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @return The number of reactions, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t mixture_reactions(const mixture_t* mixture);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function mixture_components
+ * @brief Retrieves the number of components of a mixture.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @return The number of components, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t mixture_components(const mixture_t* mixture);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function mixture_density
+ * @brief Retrieves the density of a mixture.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @return The density in g/cm^3, or -1 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+float mixture_density(const mixture_t* mixture);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function mixture_atom_density
+ * @brief Retrieves the atom density of one component of a mixture.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @param component The index of the component, in the order it was given.
+ * @return The atom density in atoms per barn-cm, or -1 if the pointer is NULL
+ *         or the index is out of bounds (sets `errno` to EINVAL).
+ */
+double mixture_atom_density(const mixture_t* mixture, size_t component);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_mixture_grid
+ * @brief Retrieves the unionized grid that holds the macroscopic cross sections of a mixture.
+ *
+ * The grid can be passed to `init_global_grid` with the grids of other
+ * mixtures, and is owned by the mixture.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ * @return A const pointer to the grid, or NULL if the pointer is NULL (sets `errno` to EINVAL).
+ */
+const union_grid_t* get_mixture_grid(const mixture_t* mixture);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_mixture
+ * @brief Frees all memory associated with a mixture.  The materials are not freed.
+ *
+ * @param mixture Pointer to the `mixture_t` structure.
+ */
+void free_mixture(mixture_t* mixture);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_mixture
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param mixture Pointer to a pointer to the `mixture_t` structure.
+ */
+void _free_mixture(mixture_t** mixture);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro MIXTURE_GBC
+     * @brief A macro for enabling automatic cleanup of mixture_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_mixture`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define MIXTURE_GBC __attribute__((cleanup(_free_mixture)))
+#endif
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* mixture_H */
+// ================================================================================
+// ================================================================================
+// eof
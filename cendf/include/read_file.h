@@ -17,12 +17,109 @@
 
 #include <stdio.h>
 
+#include "dstructures.h"
+#include "xsec_precision.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 // ================================================================================ 
 // ================================================================================ 
 
+/**
+ * @struct endfSection
+ * @brief Describes the location of one (MF, MT) section within an ENDF file.
+ *
+ * Fields:
+ *  - int mf: The ENDF file number of the section.
+ *  - int mt: The ENDF reaction number of the section.
+ *  - size_t records: The number of records in the section, as listed in the MF1/MT451 directory.
+ *  - size_t offset: The byte offset of the HEAD record of the section.
+ */
+typedef struct {
+    int mf;
+    int mt;
+    size_t records;
+    size_t offset;
+} endfSection;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct endfTable
+ * @brief Holds one TAB1 table read from an ENDF file.
+ *
+ * Fields:
+ *  - int mf: The ENDF file number of the table.
+ *  - int mt: The ENDF reaction number of the table.
+ *  - xsec_t* xsec: The (energy, value) pairs of the table.
+ */
+typedef struct {
+    int mf;
+    int mt;
+    xsec_t* xsec;
+} endfTable;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct endfMaterial
+ * @brief Holds every TAB1 table of one ENDF file, filled by `read_endf_material`.
+ *
+ * Fields:
+ *  - float za: The ZA identifier of the material (1000 * Z + A).
+ *  - float awr: The atomic weight ratio of the material to the neutron.
+ *  - int mat: The ENDF MAT number of the material.
+ *  - endfTable* tables: The tables in directory order.
+ *  - size_t len: The number of tables.
+ */
+typedef struct {
+    float za;
+    float awr;
+    int mat;
+    endfTable* tables;
+    size_t len;
+} endfMaterial;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct endfHandler
+ * @brief Callbacks invoked by `stream_endf` for each parsed event.
+ *
+ * Any callback may be NULL, in which case its events are skipped.  A callback
+ * returns false to stop the stream.  Every callback receives `user` as its
+ * first argument and the MF and MT numbers of the current section.
+ *
+ * Fields:
+ *  - void* user: A pointer passed through to every callback.
+ *  - head: The HEAD record of a section, with its MAT number and six values.
+ *  - cont: The TAB1 control record (C1, C2, L1, L2, NR, NP).
+ *  - ranges: A block of `len` interpolation ranges (NBT, INT).
+ *  - pairs: A block of `len` (x, y) pairs stored as x0, y0, x1, y1, ...
+ *  - record: Any other record of a section, as its undecoded text.
+ *  - end: The SEND record closing a section.
+ */
+typedef struct {
+    void* user;
+    bool (*head)(void* user, int mat, int mf, int mt, const double* values);
+    bool (*cont)(void* user, int mf, int mt, const double* values);
+    bool (*ranges)(void* user, int mf, int mt, const size_t* nbt, const int* law, size_t len);
+    bool (*pairs)(void* user, int mf, int mt, const double* xy, size_t len);
+    bool (*record)(void* user, int mf, int mt, const char* record);
+    bool (*end)(void* user, int mf, int mt);
+} endfHandler;
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct endf_index_t
+ * @brief Forward declaration for an index of the sections in one ENDF file.
+ *
+ * The index is built from the MF1/MT451 directory of the file, and holds a
+ * read-only memory map of the file so that individual sections can be read
+ * without scanning the records that precede them.  The data in this struct
+ * is encapsulated, preventing a user from directly accessing it.
+ */
+typedef struct endf_index_t endf_index_t;
+// --------------------------------------------------------------------------------
+
 /**
  * Reads the atomic mass (second floating-point number) from the second line of 
  * a FORTRAN-delimited ENDF file.
@@ -46,6 +143,373 @@ extern "C" {
  * - If the atomic mass cannot be parsed from the second line, prints an error message and returns -1.0f (no errno set for parsing errors).
  */
 float read_amu(const char* fileName, const float neutron_mass);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parse_endf_record
+ * @brief Decodes the six 11 column data fields of one ENDF record.
+ *
+ * Each field may be written in standard notation (e.g. `1.36301E-4`), in the
+ * FORTRAN shorthand that omits the exponent character (e.g. `1.36301-4`), or
+ * as an integer.  Blank fields are decoded as zero.  The decoder does not
+ * depend on the locale.  When compiled for a target with SSE2, the digits of
+ * each field are converted with vector instructions.
+ *
+ * @param record Pointer to the first column of a complete ENDF record.  At least
+ *               71 bytes must be readable from this pointer.
+ * @param values An array of at least six doubles that receives the decoded fields.
+ * @return true on success, false if a field can not be decoded (sets `errno` to EINVAL).
+ */
+bool parse_endf_record(const char* record, double* values);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parse_endf_records
+ * @brief Decodes the data fields of a block of consecutive ENDF records.
+ *
+ * Records are separated by new line characters and are decoded in the same
+ * way as `parse_endf_record`.  Decoding stops at the first record that is
+ * incomplete or can not be parsed, or when `length` bytes have been consumed.
+ *
+ * @param data Pointer to the first column of the first record.
+ * @param length The number of readable bytes starting at `data`.
+ * @param num_records The number of records to decode.
+ * @param values An array of at least `6 * num_records` doubles.  The fields of
+ *               record `i` are written to `values[6 * i]` through `values[6 * i + 5]`.
+ * @return The number of records decoded.  If this is less than `num_records`
+ *         `errno` is set to EINVAL.
+ */
+size_t parse_endf_records(const char* data, size_t length, size_t num_records, double* values);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_xsec
+ * @brief Reads a TAB1 section of an ENDF file into an `xsec_t` data structure.
+ *
+ * When the file has an MF1/MT451 directory, the file is memory mapped and the
+ * section is parsed in place through the directory.  Otherwise the file is
+ * read with `stream_endf` until the section is complete.  In either case the
+ * TAB1 control record supplies the number of (energy, cross section) pairs NP,
+ * and the returned `xsec_t` is allocated to exactly NP entries, so no
+ * reallocation takes place while it is populated.
+ *
+ * @param file_name The path to the ENDF file to read.
+ * @param mf The ENDF file number (e.g. 23 for photo-atomic cross sections).
+ * @param mt The ENDF reaction number (e.g. 501 for the total cross section).
+ * @return A pointer to a populated `xsec_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - ENOENT: The file could not be opened or mapped.
+ * - ENODATA: The file does not contain the requested (MF, MT) section.
+ * - EINVAL: The section is truncated, or its records or, for a file without
+ *   a directory, any record before it could not be parsed.
+ * - ENOMEM: The `xsec_t` data structure could not be allocated.
+ */
+xsec_t* read_xsec(const char* file_name, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function stream_endf
+ * @brief Reads an ENDF stream record by record and reports each parsed event.
+ *
+ * The stream is read through a fixed size buffer, so the memory used does not
+ * depend on the size of the file.  The first record of every section is
+ * reported to `head`.  In MF3, MF23 and MF27 sections, which hold one TAB1
+ * record, the TAB1 control record is reported to `cont`, the interpolation
+ * ranges to `ranges` and the (x, y) pairs to `pairs`, each in blocks of at
+ * most 384 entries.  Every other record inside a section is passed to
+ * `record` undecoded, and the SEND record of each section is reported to
+ * `end`.  The tape identification, FEND, MEND and TEND records produce no
+ * events.  Pointers passed to a callback are only valid during the call.
+ *
+ * @param file An open stream positioned at the start of an ENDF tape.
+ * @param handler The callbacks to invoke.
+ * @return true if the whole stream was read, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, or a record is malformed or out of place.
+ * - ECANCELED: A callback returned false.
+ * - EIO: The stream could not be read.
+ * - ENOMEM: The read buffer could not be allocated.
+ */
+bool stream_endf(FILE* file, const endfHandler* handler);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function stream_endf_file
+ * @brief Opens an ENDF file and reads it with `stream_endf`.
+ *
+ * @param file_name The path to the ENDF file.
+ * @param handler The callbacks to invoke.
+ * @return true if the whole file was read, false otherwise.
+ *
+ * Possible errors:
+ * - ENOENT: The file could not be opened.
+ * - All errors of `stream_endf`.
+ */
+bool stream_endf_file(const char* file_name, const endfHandler* handler);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_endf_index
+ * @brief Builds an index of the sections of an ENDF file from its MF1/MT451 directory.
+ *
+ * The file is memory mapped and only the directory records are read.  When
+ * every record in the file has the same length, the byte offset of each
+ * section is computed from the record counts in the directory; otherwise the
+ * offsets are found with a single pass over the file.  Sections are later
+ * read from the mapping without touching the records of any other section.
+ *
+ * @param file_name The path to the ENDF file.
+ * @return A pointer to an `endf_index_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - ENOENT: The file could not be opened or mapped.
+ * - EINVAL: The file does not begin with a readable MF1/MT451 directory.
+ * - ENOMEM: The index could not be allocated.
+ */
+endf_index_t* read_endf_index(const char* file_name);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function endf_index_size
+ * @brief Retrieves the number of sections listed in an ENDF index.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @return The number of sections, or 0 if `index` is NULL (sets `errno` to EINVAL).
+ */
+size_t endf_index_size(const endf_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_endf_sections
+ * @brief Retrieves a const pointer to the array of sections in an ENDF index.
+ *
+ * The array contains `endf_index_size(index)` entries in the order of the directory.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @return A const pointer to the section array, or NULL if `index` is NULL
+ *         (sets `errno` to EINVAL).
+ */
+const endfSection* get_endf_sections(const endf_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_endf_section
+ * @brief Retrieves the directory entry of a single (MF, MT) section.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return A const pointer to the section, or NULL if the section is not listed
+ *         (sets `errno` to ENODATA) or `index` is NULL (sets `errno` to EINVAL).
+ */
+const endfSection* get_endf_section(const endf_index_t* index, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function endf_index_za
+ * @brief Retrieves the ZA identifier (1000 * Z + A) of the indexed material.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @return The ZA value, or -1.0f if `index` is NULL (sets `errno` to EINVAL).
+ */
+float endf_index_za(const endf_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function endf_index_awr
+ * @brief Retrieves the atomic weight ratio (AWR) of the indexed material.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @return The AWR value in units of the neutron mass, or -1.0f if `index` is
+ *         NULL (sets `errno` to EINVAL).
+ */
+float endf_index_awr(const endf_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function endf_index_mat
+ * @brief Retrieves the ENDF material number (MAT) of the indexed material.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @return The MAT number, or -1 if `index` is NULL (sets `errno` to EINVAL).
+ */
+int endf_index_mat(const endf_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_indexed_xsec
+ * @brief Reads a TAB1 section into an `xsec_t` structure through an ENDF index.
+ *
+ * The section is located through the directory offset, so none of the
+ * records of other sections are read.  The result is identical to `read_xsec`.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return A pointer to a populated `xsec_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: `index` is NULL, or the section could not be parsed.
+ * - ENODATA: The section is not listed in the directory.
+ * - ENOMEM: The `xsec_t` data structure could not be allocated.
+ */
+xsec_t* read_indexed_xsec(const endf_index_t* index, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_indexed_xsec_f64
+ * @brief Reads a TAB1 section into a double precision table through an ENDF index.
+ *
+ * The fields are decoded to double and stored without passing through float,
+ * so energies that differ by less than a float can resolve stay distinct.
+ * `read_indexed_xsec_f32` and `read_indexed_xsec_mixed` read the section into
+ * the other tables of `xsec_precision.h` in the same way.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @return A pointer to a populated table, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: `index` is NULL, or the section could not be parsed.
+ * - ENODATA: The section is not listed in the directory.
+ * - ENOMEM: The table could not be allocated.
+ */
+xsec_f64_t* read_indexed_xsec_f64(const endf_index_t* index, int mf, int mt);
+xsec_f32_t* read_indexed_xsec_f32(const endf_index_t* index, int mf, int mt);
+xsec_mixed_t* read_indexed_xsec_mixed(const endf_index_t* index, int mf, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_form_factor
+ * @brief Reads an MF27 form factor or scattering function from an ENDF file.
+ *
+ * The supported sections are the coherent form factor (MT502), the incoherent
+ * scattering function (MT504) and the real (MT506) and imaginary (MT505)
+ * anomalous scattering factors.  The file is read in the same way as with
+ * `read_xsec`.
+ *
+ * @param file_name The path to the ENDF file.
+ * @param mt The ENDF reaction number (502, 504, 505 or 506).
+ * @return A pointer to a populated `form_factor_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The file name is NULL, `mt` is not an MF27 table, or the section
+ *   could not be parsed.
+ * - ENOENT: The file could not be opened.
+ * - ENODATA: The file does not contain the section.
+ * - ENOMEM: Memory allocation failed.
+ */
+form_factor_t* read_form_factor(const char* file_name, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_indexed_form_factor
+ * @brief Reads an MF27 form factor or scattering function through an ENDF index.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @param mt The ENDF reaction number (502, 504, 505 or 506).
+ * @return A pointer to a populated `form_factor_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: `index` is NULL, `mt` is not an MF27 table, or the section could
+ *   not be parsed.
+ * - ENODATA: The section is not listed in the directory.
+ * - ENOMEM: Memory allocation failed.
+ */
+form_factor_t* read_indexed_form_factor(const endf_index_t* index, int mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_tab1_range
+ * @brief Reads the number of points and the energy range of a TAB1 section.
+ *
+ * Only the control record and the first and last data records of the section
+ * are decoded, so the cost does not depend on the number of points.  This
+ * function does not write to `stderr` when the section is missing or is not
+ * a TAB1 section.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ * @param mf The ENDF file number.
+ * @param mt The ENDF reaction number.
+ * @param np Receives the number of (energy, value) pairs NP.
+ * @param emin Receives the first energy of the table.
+ * @param emax Receives the last energy of the table.
+ * @return true on success, false on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, or the section is not a readable TAB1 section.
+ * - ENODATA: The section is not listed in the directory.
+ */
+bool read_tab1_range(const endf_index_t* index, int mf, int mt,
+                     size_t* np, float* emin, float* emax);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function read_endf_material
+ * @brief Reads every TAB1 table of an ENDF file.
+ *
+ * Every section of a TAB1 file (MF3, MF23 and MF27) listed in the MF1/MT451
+ * directory is read as a TAB1 table, and sections of other files are
+ * skipped.  A TAB1 section that can not be read fails the whole file, so
+ * a material is never returned with tables missing.  Unlike the other readers in this file, this function reports
+ * errors only through its return value: it does not write to `stderr` and
+ * leaves `errno` unchanged, so it can be called from many threads at once
+ * with each caller keeping its own error.
+ *
+ * @param file_name The path to the ENDF file.
+ * @param material The structure that receives the tables.  On failure it is
+ *                 left empty.  Release it with `free_endf_material`.
+ * @return 0 on success, or an errno value on failure:
+ * - EINVAL: A pointer is NULL, the file does not begin with a readable directory,
+ *   or a TAB1 section is truncated or malformed.
+ * - ENOENT: The file cannot be opened or mapped.
+ * - ENOMEM: Memory allocation failed.
+ */
+int read_endf_material(const char* file_name, endfMaterial* material);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_endf_material
+ * @brief Frees the tables held by an `endfMaterial` structure.
+ *
+ * The structure itself is not freed, and is left empty.
+ *
+ * @param material Pointer to the `endfMaterial` structure.
+ */
+void free_endf_material(endfMaterial* material);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_endf_index
+ * @brief Unmaps the file and frees all memory associated with an ENDF index.
+ *
+ * @param index Pointer to the `endf_index_t` structure.
+ */
+void free_endf_index(endf_index_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_endf_index
+ * @brief A helper function for use with cleanup attributes to free endf_index_t objects.
+ *
+ * @param index A double pointer to the `endf_index_t` structure to be freed.
+ */
+void _free_endf_index(endf_index_t** index);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro ENDF_INDEX_GBC
+     * @brief A macro for enabling automatic cleanup of endf_index_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_endf_index`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define ENDF_INDEX_GBC __attribute__((cleanup(_free_endf_index)))
+#endif
 
 // ================================================================================ 
 // ================================================================================ 
@@ -0,0 +1,225 @@
+// ================================================================================
+// ================================================================================
+// - File:    sampler.h
+// - Purpose: Reaction selection tables for Monte Carlo collisions
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef sampler_H
+#define sampler_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "union_grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct reaction_sampler_t
+ * @brief Forward declaration for a table that selects the reaction of a collision.
+ *
+ * At every energy of a unionized grid the sampler stores the running sums of
+ * the partial cross sections, so that sum `r` is the sum of reactions 0 to
+ * `r` and the last sum is the total.  Because the sums are linear in the
+ * partial cross sections, interpolating them on the grid gives exactly the
+ * sums of the interpolated partials.  Selecting a reaction then takes one
+ * interval search, and the running sums of the interval are compared with a
+ * random fraction of the total, with no partial cross section evaluated.
+ * The data in this struct is encapsulated, preventing a user from directly
+ * accessing it.
+ */
+typedef struct reaction_sampler_t reaction_sampler_t;
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function init_reaction_sampler
+ * @brief Builds a sampler over the reactions of a unionized grid.
+ *
+ * The reactions of the grid must be the partial reactions a collision can
+ * undergo, such as coherent, incoherent, photoelectric and pair production,
+ * and not their total.  Negative values are treated as zero.  The sampler
+ * copies what it needs, so the grid may be freed once the sampler is built.
+ * A grid of a `mixture_t` gives a sampler for the mixture.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @return A pointer to a `reaction_sampler_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL.
+ * - ENOMEM: Memory allocation failed.
+ */
+reaction_sampler_t* init_reaction_sampler(const union_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function build_material_sampler
+ * @brief Builds a sampler for a list of partial reactions of a material.
+ *
+ * Reaction `i` of the sampler is MF/MT `mt[i]`, e.g. MF23 MT502, 504, 516
+ * and 522 for coherent, incoherent, pair production and photoelectric
+ * absorption.
+ *
+ * @param material Pointer to the `material_t` structure.
+ * @param mf The ENDF file number shared by the reactions (e.g. 23).
+ * @param mt Array of `num_mt` ENDF reaction numbers.
+ * @param num_mt The number of reactions.
+ * @return A pointer to a `reaction_sampler_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or `num_mt` is zero.
+ * - ENODATA: A reaction is not in the material.
+ * - ENOMEM: Memory allocation failed.
+ */
+reaction_sampler_t* build_material_sampler(material_t* material, int mf, const int* mt,
+                                           size_t num_mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function sample_reaction
+ * @brief Selects the reaction of a collision from one random number.
+ *
+ * Reaction `r` is selected with the probability of its share of the total
+ * cross section at `energy`.  A random number below 0 selects the first
+ * reaction with a non-zero cross section and one at or above 1 the last.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ * @param energy The energy of the collision.
+ * @param random A random number uniform on [0, 1).
+ * @return The index of the reaction, or -1 on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL.
+ * - ERANGE: The energy lies outside of the grid of the sampler.
+ * - ENODATA: Every reaction is zero at the energy.
+ */
+int sample_reaction(const reaction_sampler_t* sampler, float energy, float random);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function sample_reaction_status
+ * @brief Selects a reaction as `sample_reaction`, reporting failure only through `status`.
+ *
+ * It neither logs nor sets `errno`, so it is safe to call at any rate.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ * @param energy The energy of the collision.
+ * @param random A random number uniform on [0, 1).
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if the pointer is
+ *               NULL, CENDF_STATUS_RANGE if the energy lies outside of the
+ *               grid, or CENDF_STATUS_NO_DATA if every reaction is zero at the
+ *               energy.  May be NULL.
+ * @return The index of the reaction, or -1 on failure.
+ */
+int sample_reaction_status(const reaction_sampler_t* sampler, float energy, float random,
+                           cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function sample_reaction_batch
+ * @brief Selects the reactions of an array of collisions.
+ *
+ * The sampler is checked once per call, and the energies are searched in
+ * groups of eight whose binary searches advance in step, so the memory
+ * latency of one search overlaps that of the others.  Each result equals
+ * that of `sample_reaction` for the same energy and random number.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ * @param energies Array of `n` collision energies.
+ * @param random Array of `n` random numbers uniform on [0, 1).
+ * @param reaction Array of `n` reaction indices to fill.  A collision that
+ *                 can not be sampled gives -1, and the others are still sampled.
+ * @param n The number of collisions.
+ * @return true if every collision was sampled, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: At least one energy lies outside of the grid.
+ * - ENODATA: Every reaction is zero at one of the energies.
+ */
+bool sample_reaction_batch(const reaction_sampler_t* sampler, const float* energies,
+                           const float* random, int* reaction, size_t n);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function reaction_sampler_size
+ * @brief Retrieves the number of energies of a sampler.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ * @return The number of energies, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t reaction_sampler_size(const reaction_sampler_t* sampler);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function reaction_sampler_reactions
+ * @brief Retrieves the number of reactions of a sampler.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ * @return The number of reactions, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t reaction_sampler_reactions(const reaction_sampler_t* sampler);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_sampler_cumulative
+ * @brief Retrieves the running sums of the partial cross sections at one grid energy.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ * @param index The index of the grid energy.
+ * @return A const pointer to `reaction_sampler_reactions(sampler)` sums, the
+ *         last of which is the total, or NULL if the pointer is NULL or the
+ *         index is out of bounds (sets `errno` to EINVAL).
+ */
+const float* get_sampler_cumulative(const reaction_sampler_t* sampler, size_t index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_reaction_sampler
+ * @brief Frees all memory associated with a sampler.
+ *
+ * @param sampler Pointer to the `reaction_sampler_t` structure.
+ */
+void free_reaction_sampler(reaction_sampler_t* sampler);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_reaction_sampler
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param sampler Pointer to a pointer to the `reaction_sampler_t` structure.
+ */
+void _free_reaction_sampler(reaction_sampler_t** sampler);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro REACTION_SAMPLER_GBC
+     * @brief A macro for enabling automatic cleanup of reaction_sampler_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_reaction_sampler`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define REACTION_SAMPLER_GBC __attribute__((cleanup(_free_reaction_sampler)))
+#endif
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* sampler_H */
+// ================================================================================
+// ================================================================================
+// eof
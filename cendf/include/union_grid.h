@@ -0,0 +1,395 @@
+// ================================================================================
+// ================================================================================
+// - File:    union_grid.h
+// - Purpose: Unionized energy grids for materials and sets of materials
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef union_grid_H
+#define union_grid_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "dstructures.h"
+#include "material.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct union_grid_t
+ * @brief Forward declaration for the cross sections of several reactions on one energy grid.
+ *
+ * The grid is the merged, sorted energies of every table it is built from,
+ * and each table is resampled onto it.  Evaluating all of the reactions at an
+ * energy then takes a single binary search and one interpolation weight,
+ * instead of one search per table.  The values of all reactions at a grid
+ * point are stored together, so an evaluation reads two adjacent rows.  The
+ * data in this struct is encapsulated, preventing a user from directly
+ * accessing it.
+ */
+typedef struct union_grid_t union_grid_t;
+// ================================================================================
+// ================================================================================
+
+/**
+ * @function init_union_grid
+ * @brief Builds a unionized grid from a set of cross section tables.
+ *
+ * An energy that appears in several tables is stored once.  An energy that
+ * a table lists more than once, as at an absorption edge, is stored as many
+ * times as the table lists it, so the discontinuity is kept.  Each table is
+ * evaluated at every grid energy with its own interpolation law, and is zero
+ * below its first and above its last energy, as for a reaction threshold.
+ * The grid is interpolated linearly, and since every energy of every table
+ * is a grid point, lin-lin tables are reproduced exactly between grid points
+ * as well.  Tables with other interpolation laws are exact at the grid points.
+ *
+ * @param tables Array of `num_tables` cross section tables.
+ * @param num_tables The number of tables, which become reactions 0 to num_tables - 1.
+ * @return A pointer to a `union_grid_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, `num_tables` is zero, or a table is empty.
+ * - ENOMEM: Memory allocation failed.
+ */
+union_grid_t* init_union_grid(const xsec_t* const* tables, size_t num_tables);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function build_material_grid
+ * @brief Builds a unionized grid for a list of reactions of a material.
+ *
+ * Tables that have not been read yet are read through `get_material_xsec`.
+ * Reaction `i` of the grid is MF/MT `mt[i]`.
+ *
+ * @param material Pointer to the `material_t` structure.
+ * @param mf The ENDF file number shared by the reactions (e.g. 23).
+ * @param mt Array of `num_mt` ENDF reaction numbers.
+ * @param num_mt The number of reactions.
+ * @return A pointer to a `union_grid_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or `num_mt` is zero.
+ * - ENODATA: A reaction is not in the material.
+ * - ENOMEM: Memory allocation failed.
+ */
+union_grid_t* build_material_grid(material_t* material, int mf, const int* mt, size_t num_mt);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function combine_union_grid
+ * @brief Builds a grid whose reactions are linear combinations of the reactions of another.
+ *
+ * Reaction `r` of the new grid is the sum over the reactions `t` of `grid`
+ * of `weights[r * union_grid_reactions(grid) + t]` times reaction `t`, at
+ * every energy of `grid`.  The sums are accumulated in double precision.
+ * The new grid has the energies of `grid`, edges included, and does not
+ * refer to it, so `grid` may be freed once the new grid is built.
+ *
+ * @param grid Pointer to the `union_grid_t` structure to combine.
+ * @param weights Array of `num_reactions * union_grid_reactions(grid)` weights, row by row.
+ * @param num_reactions The number of reactions of the new grid.
+ * @return A pointer to a `union_grid_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or `num_reactions` is zero.
+ * - ENOMEM: Memory allocation failed.
+ */
+union_grid_t* combine_union_grid(const union_grid_t* grid, const double* weights,
+                                 size_t num_reactions);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_union_grid
+ * @brief Evaluates every reaction of a unionized grid at one energy.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @param energy The energy at which to evaluate the reactions.
+ * @param xs Array of `union_grid_reactions(grid)` values to fill, in the
+ *           order of the tables the grid was built from.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: The energy lies outside of the grid.
+ */
+bool interp_union_grid(const union_grid_t* grid, float energy, float* xs);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_union_grid_status
+ * @brief Evaluates a grid as `interp_union_grid`, reporting failure only through `status`.
+ *
+ * It neither logs nor sets `errno`, so it is safe to call at any rate.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @param energy The energy at which to evaluate the reactions.
+ * @param xs Array of values to fill, as for `interp_union_grid`.
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if a pointer is
+ *               NULL, or CENDF_STATUS_RANGE if the energy lies outside of the
+ *               grid.  May be NULL.
+ * @return true on success, false otherwise.
+ */
+bool interp_union_grid_status(const union_grid_t* grid, float energy, float* xs, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_union_grid_batch
+ * @brief Evaluates every reaction of a unionized grid at an array of energies.
+ *
+ * The grid is checked once per call, and the energies are searched in groups
+ * of eight whose binary searches advance in step, so the memory latency of
+ * one search overlaps that of the others.  Each row equals the values of
+ * `interp_union_grid` at the same energy.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @param energies Array of `n` energies.
+ * @param xs Array of `n` rows of `union_grid_reactions(grid)` values to fill.
+ *           The row of an energy outside of the grid is filled with -1, and
+ *           the other rows are still evaluated.
+ * @param n The number of energies.
+ * @return true if every energy lies on the grid, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: At least one energy lies outside of the grid.
+ */
+bool interp_union_grid_batch(const union_grid_t* grid, const float* energies, float* xs,
+                             size_t n);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function union_grid_size
+ * @brief Retrieves the number of energies of a unionized grid.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @return The number of energies, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t union_grid_size(const union_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function union_grid_reactions
+ * @brief Retrieves the number of reactions of a unionized grid.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @return The number of reactions, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t union_grid_reactions(const union_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_union_energy
+ * @brief Retrieves the ascending energies of a unionized grid.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @return A const pointer to `union_grid_size(grid)` energies, or NULL if the
+ *         pointer is NULL (sets `errno` to EINVAL).
+ */
+const float* get_union_energy(const union_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_union_values
+ * @brief Retrieves the values of every reaction at one grid energy.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ * @param index The index of the grid energy.
+ * @return A const pointer to `union_grid_reactions(grid)` values, or NULL if
+ *         the pointer is NULL or the index is out of bounds (sets `errno` to EINVAL).
+ */
+const float* get_union_values(const union_grid_t* grid, size_t index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_union_grid
+ * @brief Frees all memory associated with a unionized grid.
+ *
+ * @param grid Pointer to the `union_grid_t` structure.
+ */
+void free_union_grid(union_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_union_grid
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param grid Pointer to a pointer to the `union_grid_t` structure.
+ */
+void _free_union_grid(union_grid_t** grid);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro UNION_GRID_GBC
+     * @brief A macro for enabling automatic cleanup of union_grid_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_union_grid`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define UNION_GRID_GBC __attribute__((cleanup(_free_union_grid)))
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct global_grid_t
+ * @brief Forward declaration for a double-indexed grid over the unionized grids of several materials.
+ *
+ * The global grid holds the merged, distinct energies of a set of material
+ * grids, and for every global energy the interval of each material grid that
+ * contains it.  A single binary search on the global grid then locates the
+ * energy in every material, and each material is interpolated on its own
+ * grid.  Only one index per material is stored for each global energy, so
+ * the memory used is far below that of resampling every reaction of every
+ * material onto the global grid.  The material grids are borrowed and must
+ * outlive the global grid.  The data in this struct is encapsulated,
+ * preventing a user from directly accessing it.
+ */
+typedef struct global_grid_t global_grid_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_global_grid
+ * @brief Builds a double-indexed global grid over a set of material grids.
+ *
+ * @param grids Array of `num_grids` unionized grids, one per material.
+ * @param num_grids The number of material grids.
+ * @return A pointer to a `global_grid_t` structure, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or `num_grids` is zero.
+ * - ENOMEM: Memory allocation failed.
+ */
+global_grid_t* init_global_grid(const union_grid_t* const* grids, size_t num_grids);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_global_grid
+ * @brief Evaluates every reaction of every material at one energy.
+ *
+ * The values of material `m` start at `xs[global_grid_offset(grid, m)]`, in
+ * the order of the reactions of its grid.  A material is zero at energies
+ * outside of its own grid.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ * @param energy The energy at which to evaluate the reactions.
+ * @param xs Array of `global_grid_values(grid)` values to fill.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: The energy lies outside of the global grid.
+ */
+bool interp_global_grid(const global_grid_t* grid, float energy, float* xs);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_global_grid_status
+ * @brief Evaluates a grid as `interp_global_grid`, reporting failure only through `status`.
+ *
+ * It neither logs nor sets `errno`, so it is safe to call at any rate.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ * @param energy The energy at which to evaluate the reactions.
+ * @param xs Array of values to fill, as for `interp_global_grid`.
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if a pointer is
+ *               NULL, or CENDF_STATUS_RANGE if the energy lies outside of the
+ *               grid.  May be NULL.
+ * @return true on success, false otherwise.
+ */
+bool interp_global_grid_status(const global_grid_t* grid, float energy, float* xs, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function global_grid_size
+ * @brief Retrieves the number of energies of a global grid.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ * @return The number of energies, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t global_grid_size(const global_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function global_grid_materials
+ * @brief Retrieves the number of materials of a global grid.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ * @return The number of materials, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t global_grid_materials(const global_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function global_grid_values
+ * @brief Retrieves the number of values filled by `interp_global_grid`.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ * @return The sum of the number of reactions of every material, or 0 if the
+ *         pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t global_grid_values(const global_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function global_grid_offset
+ * @brief Retrieves the position of the first value of a material in the output of `interp_global_grid`.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ * @param material The index of the material grid.
+ * @return The offset, or 0 if the pointer is NULL or the index is out of
+ *         bounds (sets `errno` to EINVAL).
+ */
+size_t global_grid_offset(const global_grid_t* grid, size_t material);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_global_grid
+ * @brief Frees a global grid.  The material grids are not freed.
+ *
+ * @param grid Pointer to the `global_grid_t` structure.
+ */
+void free_global_grid(global_grid_t* grid);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_global_grid
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param grid Pointer to a pointer to the `global_grid_t` structure.
+ */
+void _free_global_grid(global_grid_t** grid);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro GLOBAL_GRID_GBC
+     * @brief A macro for enabling automatic cleanup of global_grid_t objects.
+     *
+     * This macro uses the cleanup attribute to automatically call `_free_global_grid`
+     * when the scope ends, ensuring proper memory management.
+     */
+    #define GLOBAL_GRID_GBC __attribute__((cleanup(_free_global_grid)))
+#endif
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+#endif /* union_grid_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,71 @@
+// ================================================================================
+// ================================================================================
+// - File:    xsec_precision.h
+// - Purpose: Cross section tables in single, double and mixed precision
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef xsec_precision_H
+#define xsec_precision_H
+
+// ================================================================================
+// ================================================================================
+// The energies of photo-atomic tables reach 1e11 eV, where neighbouring floats
+// are 8192 eV apart, so points that a table holds as distinct can fall on the
+// same float.  Each of the tables below is declared from xsec_template.h and
+// compiled from xsec_template.inc with its own types, so a table can trade
+// memory for precision without a type switch in its lookups.
+//
+//  - xsec_f32_t:   float energies and float cross sections, 8 bytes a point.
+//  - xsec_f64_t:   double energies and double cross sections, 16 bytes a point.
+//  - xsec_mixed_t: double energies and float cross sections, 12 bytes a point.
+//                  The search and the interpolation weight are exact to double
+//                  precision, which is where float loses points.
+
+#define XSEC_NAME xsec_f32
+#define XSEC_ENERGY_T float
+#define XSEC_VALUE_T float
+#include "xsec_template.h"
+
+#define XSEC_NAME xsec_f64
+#define XSEC_ENERGY_T double
+#define XSEC_VALUE_T double
+#include "xsec_template.h"
+
+#define XSEC_NAME xsec_mixed
+#define XSEC_ENERGY_T double
+#define XSEC_VALUE_T float
+#include "xsec_template.h"
+// ================================================================================
+// ================================================================================
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro XSEC_F32_GBC
+     * @brief A macro for enabling automatic cleanup of xsec_f32_t objects.
+     */
+    #define XSEC_F32_GBC __attribute__((cleanup(_free_xsec_f32)))
+    /**
+     * @macro XSEC_F64_GBC
+     * @brief A macro for enabling automatic cleanup of xsec_f64_t objects.
+     */
+    #define XSEC_F64_GBC __attribute__((cleanup(_free_xsec_f64)))
+    /**
+     * @macro XSEC_MIXED_GBC
+     * @brief A macro for enabling automatic cleanup of xsec_mixed_t objects.
+     */
+    #define XSEC_MIXED_GBC __attribute__((cleanup(_free_xsec_mixed)))
+#endif
+// ================================================================================
+// ================================================================================
+#endif /* xsec_precision_H */
+// ================================================================================
+// ================================================================================
+// eof
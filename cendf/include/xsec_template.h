@@ -0,0 +1,251 @@
+// ================================================================================
+// ================================================================================
+// - File:    xsec_template.h
+// - Purpose: Declarations of a cross section table for one energy and value type
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// This file is a template and has no include guard.  Each inclusion declares
+// one table type from the parameters below, which are undefined again at the
+// end of the file:
+//
+//  - XSEC_NAME:     The name of the table, e.g. xsec_f64 for xsec_f64_t.
+//  - XSEC_ENERGY_T: The type of the energies.
+//  - XSEC_VALUE_T:  The type of the cross sections.
+//
+// The functions of an instantiation are named after XSEC_NAME in the pattern
+// of xsec_t; init_xsec_f64, push_xsec_f64, interp_xsec_f64 and so on.
+
+#include <stdlib.h>   // For size_t
+#include <stdbool.h>  // For bool
+
+#include "diagnostics.h"
+
+#if !defined(XSEC_NAME) || !defined(XSEC_ENERGY_T) || !defined(XSEC_VALUE_T)
+    #error "xsec_template.h requires XSEC_NAME, XSEC_ENERGY_T and XSEC_VALUE_T"
+#endif
+
+#ifndef XSEC_TEMPLATE_NAMES
+#define XSEC_TEMPLATE_NAMES
+    #define XSEC_TEMPLATE_CAT_(a, b) a##b
+    #define XSEC_TEMPLATE_CAT(a, b) XSEC_TEMPLATE_CAT_(a, b)
+    /**
+     * @macro XSEC_TEMPLATE_TYPE
+     * @brief The type name of the table being declared, XSEC_NAME followed by _t.
+     */
+    #define XSEC_TEMPLATE_TYPE XSEC_TEMPLATE_CAT(XSEC_NAME, _t)
+    /**
+     * @macro XSEC_TEMPLATE_FN
+     * @brief The name of a function of the table being declared, XSEC_NAME
+     *        between `prefix` and `suffix`.
+     */
+    #define XSEC_TEMPLATE_FN(prefix, suffix) \
+        XSEC_TEMPLATE_CAT(XSEC_TEMPLATE_CAT(prefix, XSEC_NAME), suffix)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// ================================================================================
+// ================================================================================
+
+/**
+ * @struct XSEC_TEMPLATE_TYPE
+ * @brief Forward declaration for a cross section table of one energy and value type.
+ *
+ * The table holds ascending energies of type XSEC_ENERGY_T, the cross
+ * sections of type XSEC_VALUE_T, and the TAB1 interpolation ranges of the
+ * table.  Every function is compiled for its own types, so no type is
+ * chosen at run time.  The data in this struct is encapsulated, preventing
+ * a user from directly accessing it.
+ */
+typedef struct XSEC_TEMPLATE_TYPE XSEC_TEMPLATE_TYPE;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_<name>
+ * @brief Allocates an empty table with room for `buffer_length` points.
+ *
+ * @param buffer_length The number of points to allocate; the table grows as needed.
+ * @return A pointer to the table, or NULL on failure.
+ *
+ * Possible errors:
+ * - ENOMEM: Memory allocation failed.
+ */
+XSEC_TEMPLATE_TYPE* XSEC_TEMPLATE_FN(init_, )(size_t buffer_length);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function init_<name>_from
+ * @brief Allocates a table holding a copy of `len` (energy, value) pairs.
+ *
+ * @param energy Array of `len` ascending energies.
+ * @param value Array of `len` cross sections.
+ * @param len The number of points.
+ * @return A pointer to the table, or NULL on failure.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL or the energies descend.
+ * - ENOMEM: Memory allocation failed.
+ */
+XSEC_TEMPLATE_TYPE* XSEC_TEMPLATE_FN(init_, _from)(const XSEC_ENERGY_T* energy,
+                                                   const XSEC_VALUE_T* value, size_t len);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function push_<name>
+ * @brief Appends one point to a table.
+ *
+ * An energy may repeat the last energy of the table, as at an absorption
+ * edge, but may not lie below it.
+ *
+ * @param table Pointer to the table.
+ * @param value The cross section of the point.
+ * @param energy The energy of the point.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL or the energy lies below the last energy.
+ * - EPERM: The table has interpolation ranges, which describe a fixed number of points.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool XSEC_TEMPLATE_FN(push_, )(XSEC_TEMPLATE_TYPE* table, XSEC_VALUE_T value,
+                               XSEC_ENERGY_T energy);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_<name>_interpolation
+ * @brief Sets the TAB1 interpolation ranges of a table, as `set_xsec_interpolation`.
+ *
+ * @param table Pointer to the table.
+ * @param nbt Array of `nr` 1-based points that end each range.
+ * @param law Array of `nr` ENDF interpolation laws, 1 to 5.
+ * @param nr The number of ranges.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL, or the ranges are invalid or do not end at the last point.
+ * - ENOMEM: Memory allocation failed.
+ */
+bool XSEC_TEMPLATE_FN(set_, _interpolation)(XSEC_TEMPLATE_TYPE* table, const size_t* nbt,
+                                            const int* law, size_t nr);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_<name>
+ * @brief Interpolates a table at one energy.
+ *
+ * The search and the interpolation are carried out in the precision of the
+ * energies, so points closer together than a float can resolve stay
+ * distinct.  An energy listed twice, as at an absorption edge, takes the
+ * value above the edge.
+ *
+ * @param table Pointer to the table.
+ * @param energy The energy at which to interpolate.
+ * @return The interpolated cross section, or -1 on failure.
+ *
+ * Possible errors:
+ * - EINVAL: The pointer is NULL or the table is empty.
+ * - ERANGE: The energy lies outside of the table.
+ */
+const XSEC_VALUE_T XSEC_TEMPLATE_FN(interp_, )(const XSEC_TEMPLATE_TYPE* table,
+                                               XSEC_ENERGY_T energy);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function interp_<name>_status
+ * @brief Interpolates a table as `interp_<name>`, reporting failure only through `status`.
+ *
+ * @param table Pointer to the table.
+ * @param energy The energy at which to interpolate.
+ * @param status Set to CENDF_STATUS_OK, CENDF_STATUS_INVALID if the pointer is
+ *               NULL or the table is empty, or CENDF_STATUS_RANGE if the energy
+ *               lies outside of the table.  May be NULL.
+ * @return The interpolated cross section, or -1 on failure.
+ */
+const XSEC_VALUE_T XSEC_TEMPLATE_FN(interp_, _status)(const XSEC_TEMPLATE_TYPE* table,
+                                                      XSEC_ENERGY_T energy, cendfStatus* status);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function find_<name>_interval
+ * @brief Finds the interval of a table that holds an energy, as `find_xsec_interval`.
+ *
+ * @param table Pointer to the table.
+ * @param energy The energy to locate.
+ * @param index Set to the last point at or below the energy, at most size - 2.
+ * @return true on success, false otherwise.
+ *
+ * Possible errors:
+ * - EINVAL: A pointer is NULL.
+ * - ERANGE: The table has fewer than two points or the energy lies outside of it.
+ */
+bool XSEC_TEMPLATE_FN(find_, _interval)(const XSEC_TEMPLATE_TYPE* table, XSEC_ENERGY_T energy,
+                                        size_t* index);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function <name>_size
+ * @brief Retrieves the number of points of a table.
+ *
+ * @param table Pointer to the table.
+ * @return The number of points, or 0 if the pointer is NULL (sets `errno` to EINVAL).
+ */
+size_t XSEC_TEMPLATE_FN(, _size)(const XSEC_TEMPLATE_TYPE* table);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_<name>_enArray
+ * @brief Retrieves the energies of a table.
+ *
+ * @param table Pointer to the table.
+ * @return A const pointer to the energies, or NULL if the pointer is NULL
+ *         (sets `errno` to EINVAL).
+ */
+const XSEC_ENERGY_T* XSEC_TEMPLATE_FN(get_, _enArray)(const XSEC_TEMPLATE_TYPE* table);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function get_<name>_xsArray
+ * @brief Retrieves the cross sections of a table.
+ *
+ * @param table Pointer to the table.
+ * @return A const pointer to the cross sections, or NULL if the pointer is
+ *         NULL (sets `errno` to EINVAL).
+ */
+const XSEC_VALUE_T* XSEC_TEMPLATE_FN(get_, _xsArray)(const XSEC_TEMPLATE_TYPE* table);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function free_<name>
+ * @brief Frees all memory associated with a table.
+ *
+ * @param table Pointer to the table.
+ */
+void XSEC_TEMPLATE_FN(free_, )(XSEC_TEMPLATE_TYPE* table);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function _free_<name>
+ * @brief Helper function for use with the cleanup attribute.
+ *
+ * @param table Pointer to a pointer to the table.
+ */
+void XSEC_TEMPLATE_FN(_free_, )(XSEC_TEMPLATE_TYPE** table);
+// ================================================================================
+// ================================================================================
+#ifdef __cplusplus
+}
+#endif /* cplusplus */
+
+#undef XSEC_NAME
+#undef XSEC_ENERGY_T
+#undef XSEC_VALUE_T
+// ================================================================================
+// ================================================================================
+// eof
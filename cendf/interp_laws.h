@@ -0,0 +1,88 @@
+// ================================================================================
+// ================================================================================
+// - File:    interp_laws.h
+// - Purpose: ENDF interpolation laws shared by the tabulated data types
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// This header is internal to the library and is not installed.  It holds the
+// one copy of the interpolation math used by xsec_t, the tables of
+// xsec_precision.h and the cache loader, so a change to a law reaches every
+// table family.
+
+#ifndef interp_laws_H
+#define interp_laws_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <math.h>
+
+// Growth of the table arrays: doubling up to the threshold, then fixed steps
+static const size_t XSEC_THRESHOLD = 1 * 1024 * 1024;  // 1 MB
+static const size_t XSEC_FIXED_AMOUNT = 1 * 1024 * 1024;  // 1 MB
+// ================================================================================
+// ================================================================================
+
+// ENDF interpolation schemes (INT) supported by the tabulated data types
+enum {
+    INTERP_HISTOGRAM = 1,
+    INTERP_LIN_LIN = 2,
+    INTERP_LIN_LOG = 3,
+    INTERP_LOG_LIN = 4,
+    INTERP_LOG_LOG = 5
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * The slope of one interval under a logarithmic law, or NAN where the law
+ * can not represent the interval, such as one with a zero end point, which
+ * is then interpolated lin-lin.
+ */
+static inline double interval_slope(int law, double x1, double x2, double y1, double y2) {
+    switch (law) {
+        case INTERP_LIN_LOG:
+            if (x1 <= 0.0 || x2 <= x1) return NAN;
+            return (y2 - y1) / log(x2 / x1);
+        case INTERP_LOG_LIN:
+            if (y1 <= 0.0 || y2 <= 0.0 || x2 <= x1) return NAN;
+            return log(y2 / y1) / (x2 - x1);
+        case INTERP_LOG_LOG:
+            if (x1 <= 0.0 || x2 <= x1 || y1 <= 0.0 || y2 <= 0.0) return NAN;
+            return log(y2 / y1) / log(x2 / x1);
+        default:
+            return NAN;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Checks the NR interpolation ranges of a table of `len` points: NBT must
+ * increase to `len` and every INT must be a supported law.  On success
+ * `linear` is set if the table is lin-lin throughout, and `logarithmic` if
+ * any range needs the slopes of interval_slope.  Nothing is reported.
+ */
+static inline bool check_interp_ranges(const size_t* nbt, const int* law, size_t nr, size_t len,
+                                       bool* linear, bool* logarithmic) {
+    if (!nbt || !law || nr == 0 || nbt[nr - 1] != len) return false;
+    *linear = true;
+    *logarithmic = false;
+    for (size_t i = 0; i < nr; i++) {
+        if (law[i] < INTERP_HISTOGRAM || law[i] > INTERP_LOG_LOG ||
+            nbt[i] == 0 || (i > 0 && nbt[i] <= nbt[i - 1]))
+            return false;
+        if (law[i] != INTERP_LIN_LIN) *linear = false;
+        if (law[i] >= INTERP_LIN_LOG) *logarithmic = true;
+    }
+    return true;
+}
+// ================================================================================
+// ================================================================================
+#endif /* interp_laws_H */
+// ================================================================================
+// ================================================================================
+// eof
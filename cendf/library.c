@@ -0,0 +1,963 @@
+// ================================================================================
+// ================================================================================
+// - File:    library.c
+// - Purpose: Library index and parallel loading of directories of ENDF files
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/library.h"
+
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#define LIBRARY_INDEX_MAGIC "CENDFIDX"
+#define LIBRARY_INDEX_VERSION 1
+#define LIBRARY_INDEX_BYTE_ORDER 0x01020304u
+#define ENDF_EXTENSION ".endf"
+// ================================================================================
+// ================================================================================
+// INDEX FILE LAYOUT
+//
+// The index file is a header, one record per material, one record per section
+// and a string table.  The first string is the absolute path of the directory
+// and the remaining strings are the file names of the materials.  All fields
+// have fixed widths and are written in the byte order of the host, which is
+// checked when the index is loaded.
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t num_files;
+    uint32_t num_scanned;
+    uint32_t num_sections;
+    uint32_t string_bytes;
+} index_header;
+_Static_assert(sizeof(index_header) == 32, "index_header must be 32 bytes");
+
+typedef struct {
+    uint64_t file_size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint32_t name_offset;
+    uint32_t first_section;
+    uint32_t num_sections;
+    int32_t mat;
+    float za;
+    float awr;
+} index_file_record;
+_Static_assert(sizeof(index_file_record) == 48, "index_file_record must be 48 bytes");
+
+typedef struct {
+    uint64_t offset;
+    uint32_t np;
+    uint16_t mf;
+    uint16_t mt;
+    float emin;
+    float emax;
+} index_section_record;
+_Static_assert(sizeof(index_section_record) == 24, "index_section_record must be 24 bytes");
+// ================================================================================
+// ================================================================================
+// PARALLEL DIRECTORY SCAN
+
+typedef struct {
+    index_file_record file;
+    index_section_record* sections;
+    const char* name;
+    bool valid;
+} scan_result;
+
+typedef struct {
+    const char* directory;
+    scan_result* results;
+    size_t len;
+    atomic_size_t next;
+} scan_job;
+// --------------------------------------------------------------------------------
+
+static bool has_endf_extension(const char* name) {
+    size_t len = strlen(name);
+    size_t ext = strlen(ENDF_EXTENSION);
+    return len > ext && strcmp(name + len - ext, ENDF_EXTENSION) == 0;
+}
+// --------------------------------------------------------------------------------
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the sorted names of the ENDF files in a directory, or NULL if the
+ * directory cannot be read.  An empty directory returns an empty array.
+ */
+static char** list_endf_files(const char* directory, size_t* len) {
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        errno = ENOENT;
+        return NULL;
+    }
+    size_t alloc = 128;
+    size_t count = 0;
+    char** names = malloc(alloc * sizeof(char*));
+    if (!names) {
+        closedir(dir);
+        errno = ENOMEM;
+        return NULL;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!has_endf_extension(entry->d_name)) continue;
+        if (count == alloc) {
+            char** ptr = realloc(names, 2 * alloc * sizeof(char*));
+            if (!ptr) break;
+            names = ptr;
+            alloc *= 2;
+        }
+        names[count] = strdup(entry->d_name);
+        if (!names[count]) break;
+        count++;
+    }
+    bool complete = entry == NULL;
+    closedir(dir);
+    if (!complete) {
+        for (size_t i = 0; i < count; i++) free(names[i]);
+        free(names);
+        errno = ENOMEM;
+        return NULL;
+    }
+    qsort(names, count, sizeof(char*), compare_names);
+    *len = count;
+    return names;
+}
+// --------------------------------------------------------------------------------
+
+static void free_names(char** names, size_t len) {
+    for (size_t i = 0; i < len; i++) free(names[i]);
+    free(names);
+}
+// --------------------------------------------------------------------------------
+
+static char* join_path(const char* directory, const char* name) {
+    size_t dlen = strlen(directory);
+    size_t nlen = strlen(name);
+    char* path = malloc(dlen + nlen + 2);
+    if (!path) return NULL;
+    memcpy(path, directory, dlen);
+    path[dlen] = '/';
+    memcpy(path + dlen + 1, name, nlen + 1);
+    return path;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Indexes one ENDF file.  The file is stat'ed before it is read, so a file
+ * that changes while it is being indexed is reported as stale afterwards.
+ */
+static void scan_file(const char* directory, scan_result* result) {
+    char* path = join_path(directory, result->name);
+    if (!path) return;
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        free(path);
+        return;
+    }
+    endf_index_t* index = read_endf_index(path);
+    free(path);
+    if (!index) return;
+
+    const size_t len = endf_index_size(index);
+    const endfSection* sections = get_endf_sections(index);
+    index_section_record* records = malloc(len * sizeof(index_section_record));
+    if (!records) {
+        free_endf_index(index);
+        return;
+    }
+    const int saved_errno = errno;
+    for (size_t i = 0; i < len; i++) {
+        size_t np = 0;
+        float emin = 0.0f;
+        float emax = 0.0f;
+        // Sections that are not TAB1 tables, such as the MF1 directory, have no range
+        if (sections[i].mf == 1 ||
+            !read_tab1_range(index, sections[i].mf, sections[i].mt, &np, &emin, &emax)) {
+            np = 0;
+            emin = emax = 0.0f;
+        }
+        records[i] = (index_section_record){
+            .offset = sections[i].offset,
+            .np = (uint32_t)np,
+            .mf = (uint16_t)sections[i].mf,
+            .mt = (uint16_t)sections[i].mt,
+            .emin = emin,
+            .emax = emax
+        };
+    }
+    errno = saved_errno;
+
+    result->file = (index_file_record){
+        .file_size = (uint64_t)st.st_size,
+        .mtime_sec = (int64_t)st.st_mtim.tv_sec,
+        .mtime_nsec = (int64_t)st.st_mtim.tv_nsec,
+        .num_sections = (uint32_t)len,
+        .mat = endf_index_mat(index),
+        .za = endf_index_za(index),
+        .awr = endf_index_awr(index)
+    };
+    result->sections = records;
+    result->valid = true;
+    free_endf_index(index);
+}
+// --------------------------------------------------------------------------------
+
+static void* scan_worker(void* arg) {
+    scan_job* job = arg;
+    size_t i;
+    while ((i = atomic_fetch_add(&job->next, 1)) < job->len)
+        scan_file(job->directory, &job->results[i]);
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Runs `worker` on a pool of `num_threads` threads, one of which is the
+ * calling thread, and waits for all of them.  Workers take tasks from an
+ * atomic counter in their job, so the pool is bounded no matter how many
+ * tasks there are, and the job completes even if no thread can be started.
+ */
+static void run_workers(void* (*worker)(void*), void* job, size_t tasks, size_t num_threads) {
+    if (num_threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (num_threads > tasks) num_threads = tasks;
+
+    pthread_t* threads = num_threads > 1 ? malloc((num_threads - 1) * sizeof(pthread_t)) : NULL;
+    size_t started = 0;
+    for (size_t i = 0; threads && i < num_threads - 1; i++) {
+        if (pthread_create(&threads[i], NULL, worker, job) != 0) break;
+        started++;
+    }
+    worker(job);
+    for (size_t i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+}
+// --------------------------------------------------------------------------------
+
+static int compare_results(const void* a, const void* b) {
+    const scan_result* ra = a;
+    const scan_result* rb = b;
+    if (ra->valid != rb->valid) return ra->valid ? -1 : 1;
+    if (ra->file.za < rb->file.za) return -1;
+    if (ra->file.za > rb->file.za) return 1;
+    return strcmp(ra->name, rb->name);
+}
+// --------------------------------------------------------------------------------
+
+static bool write_index_file(FILE* file, const char* directory,
+                             scan_result* results, size_t valid, size_t scanned) {
+    const size_t dir_bytes = strlen(directory) + 1;
+    size_t string_bytes = dir_bytes;
+    size_t num_sections = 0;
+    for (size_t i = 0; i < valid; i++) {
+        results[i].file.name_offset = (uint32_t)string_bytes;
+        results[i].file.first_section = (uint32_t)num_sections;
+        string_bytes += strlen(results[i].name) + 1;
+        num_sections += results[i].file.num_sections;
+    }
+
+    index_header header = {
+        .version = LIBRARY_INDEX_VERSION,
+        .byte_order = LIBRARY_INDEX_BYTE_ORDER,
+        .num_files = (uint32_t)valid,
+        .num_scanned = (uint32_t)scanned,
+        .num_sections = (uint32_t)num_sections,
+        .string_bytes = (uint32_t)string_bytes
+    };
+    memcpy(header.magic, LIBRARY_INDEX_MAGIC, sizeof(header.magic));
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (size_t i = 0; ok && i < valid; i++)
+        ok = fwrite(&results[i].file, sizeof(index_file_record), 1, file) == 1;
+    for (size_t i = 0; ok && i < valid; i++)
+        ok = fwrite(results[i].sections, sizeof(index_section_record),
+                    results[i].file.num_sections, file) == results[i].file.num_sections;
+    ok = ok && fwrite(directory, 1, dir_bytes, file) == dir_bytes;
+    for (size_t i = 0; ok && i < valid; i++) {
+        size_t bytes = strlen(results[i].name) + 1;
+        ok = fwrite(results[i].name, 1, bytes, file) == bytes;
+    }
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+bool build_library_index(const char* directory, const char* index_file, size_t num_threads) {
+    if (!directory || !index_file) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to build_library_index");
+        return false;
+    }
+    char* absolute = realpath(directory, NULL);
+    size_t len = 0;
+    char** names = absolute ? list_endf_files(absolute, &len) : NULL;
+    if (!names) {
+        int error = absolute ? errno : ENOENT;
+        free(absolute);
+        CENDF_REPORT(error, "Unable to read directory %s: %s", directory, strerror(error));
+        return false;
+    }
+
+    scan_result* results = calloc(len > 0 ? len : 1, sizeof(scan_result));
+    if (!results) {
+        free_names(names, len);
+        free(absolute);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for library index");
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) results[i].name = names[i];
+
+    scan_job job = { .directory = absolute, .results = results, .len = len };
+    atomic_init(&job.next, 0);
+    if (len > 0) run_workers(scan_worker, &job, len, num_threads);
+
+    qsort(results, len, sizeof(scan_result), compare_results);
+    size_t valid = 0;
+    while (valid < len && results[valid].valid) valid++;
+
+    bool ok = false;
+    if (valid == 0) {
+        CENDF_REPORT(ENODATA, "No ENDF files could be indexed in %s", directory);
+    } else {
+        // Write to a temporary file so that readers never see a partial index
+        char* tmp_name = malloc(strlen(index_file) + 32);
+        FILE* file = NULL;
+        if (tmp_name) {
+            sprintf(tmp_name, "%s.tmp.%ld", index_file, (long)getpid());
+            file = fopen(tmp_name, "wb");
+        }
+        if (file) {
+            ok = write_index_file(file, absolute, results, valid, len);
+            ok = (fclose(file) == 0) && ok;
+            ok = ok && rename(tmp_name, index_file) == 0;
+            if (!ok) remove(tmp_name);
+        }
+        if (!ok) {
+            CENDF_REPORT(EIO, "Unable to write library index %s", index_file);
+        }
+        free(tmp_name);
+    }
+
+    for (size_t i = 0; i < len; i++) free(results[i].sections);
+    free(results);
+    free_names(names, len);
+    free(absolute);
+    return ok;
+}
+// ================================================================================
+// ================================================================================
+// LIBRARY INDEX
+
+struct library_index_t {
+    char* directory;
+    char* paths;
+    libraryMaterial* materials;
+    librarySection* sections;
+    uint64_t* file_sizes;
+    int64_t* mtimes;
+    size_t len;
+    size_t num_scanned;
+};
+// --------------------------------------------------------------------------------
+
+static char* read_whole_file(const char* file_name, size_t* size) {
+    FILE* file = fopen(file_name, "rb");
+    if (!file) {
+        errno = ENOENT;
+        return NULL;
+    }
+    char* buffer = NULL;
+    long bytes = -1;
+    if (fseek(file, 0, SEEK_END) == 0) bytes = ftell(file);
+    if (bytes >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        buffer = malloc(bytes > 0 ? (size_t)bytes : 1);
+        if (buffer && fread(buffer, 1, (size_t)bytes, file) != (size_t)bytes) {
+            free(buffer);
+            buffer = NULL;
+            errno = EINVAL;
+        } else if (!buffer) {
+            errno = ENOMEM;
+        }
+    } else {
+        errno = EINVAL;
+    }
+    fclose(file);
+    *size = buffer ? (size_t)bytes : 0;
+    return buffer;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Checks the header and every table of an index file before any of it is
+ * used, so that a damaged file is rejected instead of read out of bounds.
+ */
+static bool validate_index(const char* data, size_t size) {
+    if (size < sizeof(index_header)) return false;
+    index_header header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, LIBRARY_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LIBRARY_INDEX_VERSION ||
+        header.byte_order != LIBRARY_INDEX_BYTE_ORDER ||
+        header.num_files == 0 || header.string_bytes == 0)
+        return false;
+    size_t expected = sizeof(index_header) +
+                      (size_t)header.num_files * sizeof(index_file_record) +
+                      (size_t)header.num_sections * sizeof(index_section_record) +
+                      header.string_bytes;
+    if (size != expected) return false;
+
+    const char* strings = data + size - header.string_bytes;
+    if (strings[header.string_bytes - 1] != '\0') return false;
+    const char* files = data + sizeof(index_header);
+    for (uint32_t i = 0; i < header.num_files; i++) {
+        index_file_record record;
+        memcpy(&record, files + i * sizeof(index_file_record), sizeof(record));
+        if (record.name_offset >= header.string_bytes ||
+            record.first_section > header.num_sections ||
+            record.num_sections > header.num_sections - record.first_section)
+            return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+library_index_t* open_library_index(const char* index_file) {
+    if (!index_file) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to open_library_index");
+        return NULL;
+    }
+    size_t size = 0;
+    char* data = read_whole_file(index_file, &size);
+    if (!data) {
+        CENDF_REPORT(errno, "Unable to read library index %s: %s", index_file, strerror(errno));
+        return NULL;
+    }
+    if (!validate_index(data, size)) {
+        free(data);
+        CENDF_REPORT(EINVAL, "Invalid library index %s", index_file);
+        return NULL;
+    }
+
+    index_header header;
+    memcpy(&header, data, sizeof(header));
+    const char* files = data + sizeof(index_header);
+    const char* records = files + (size_t)header.num_files * sizeof(index_file_record);
+    const char* strings = data + size - header.string_bytes;
+    const size_t len = header.num_files;
+
+    // Full paths are stored back to back as "<directory>/<name>"
+    const size_t dir_len = strlen(strings);
+    size_t path_bytes = 0;
+    for (size_t i = 0; i < len; i++) {
+        index_file_record record;
+        memcpy(&record, files + i * sizeof(index_file_record), sizeof(record));
+        path_bytes += dir_len + strlen(strings + record.name_offset) + 2;
+    }
+
+    library_index_t* index = calloc(1, sizeof(library_index_t));
+    if (index) {
+        index->directory = strdup(strings);
+        index->paths = malloc(path_bytes);
+        index->materials = malloc(len * sizeof(libraryMaterial));
+        index->sections = malloc((header.num_sections > 0 ? header.num_sections : 1) *
+                                 sizeof(librarySection));
+        index->file_sizes = malloc(len * sizeof(uint64_t));
+        index->mtimes = malloc(2 * len * sizeof(int64_t));
+    }
+    if (!index || !index->directory || !index->paths || !index->materials ||
+        !index->sections || !index->file_sizes || !index->mtimes) {
+        free(data);
+        free_library_index(index);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for library index");
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < header.num_sections; i++) {
+        index_section_record record;
+        memcpy(&record, records + i * sizeof(index_section_record), sizeof(record));
+        index->sections[i] = (librarySection){
+            .mf = record.mf,
+            .mt = record.mt,
+            .offset = (size_t)record.offset,
+            .np = record.np,
+            .emin = record.emin,
+            .emax = record.emax
+        };
+    }
+    char* path = index->paths;
+    for (size_t i = 0; i < len; i++) {
+        index_file_record record;
+        memcpy(&record, files + i * sizeof(index_file_record), sizeof(record));
+        int written = sprintf(path, "%s/%s", strings, strings + record.name_offset);
+        index->materials[i] = (libraryMaterial){
+            .file_name = path,
+            .za = record.za,
+            .awr = record.awr,
+            .mat = record.mat,
+            .num_sections = record.num_sections,
+            .sections = index->sections + record.first_section
+        };
+        index->file_sizes[i] = record.file_size;
+        index->mtimes[2 * i] = record.mtime_sec;
+        index->mtimes[2 * i + 1] = record.mtime_nsec;
+        path += written + 1;
+    }
+    index->len = len;
+    index->num_scanned = header.num_scanned;
+    free(data);
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+bool library_index_stale(const library_index_t* index) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to library_index_stale");
+        return true;
+    }
+    for (size_t i = 0; i < index->len; i++) {
+        struct stat st;
+        if (stat(index->materials[i].file_name, &st) != 0 ||
+            (uint64_t)st.st_size != index->file_sizes[i] ||
+            (int64_t)st.st_mtim.tv_sec != index->mtimes[2 * i] ||
+            (int64_t)st.st_mtim.tv_nsec != index->mtimes[2 * i + 1])
+            return true;
+    }
+    size_t count = 0;
+    DIR* dir = opendir(index->directory);
+    if (!dir) return true;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (has_endf_extension(entry->d_name)) count++;
+    }
+    closedir(dir);
+    return count != index->num_scanned;
+}
+// --------------------------------------------------------------------------------
+
+size_t library_index_size(const library_index_t* index) {
+    if (!index) {
+        errno = EINVAL;
+        return 0;
+    }
+    return index->len;
+}
+// --------------------------------------------------------------------------------
+
+const libraryMaterial* get_library_materials(const library_index_t* index) {
+    if (!index) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return index->materials;
+}
+// --------------------------------------------------------------------------------
+
+const libraryMaterial* find_library_material(const library_index_t* index, int z) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to find_library_material");
+        return NULL;
+    }
+    // Materials are sorted by ZA, so the atomic number can be bisected
+    size_t low = 0;
+    size_t high = index->len;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int mid_z = (int)(index->materials[mid].za / 1000.0f);
+        if (mid_z < z) low = mid + 1;
+        else high = mid;
+    }
+    if (low < index->len && (int)(index->materials[low].za / 1000.0f) == z)
+        return &index->materials[low];
+    errno = ENODATA;
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+const librarySection* find_library_section(const library_index_t* index, int z, int mf, int mt) {
+    const libraryMaterial* material = find_library_material(index, z);
+    if (!material) return NULL;
+    for (size_t i = 0; i < material->num_sections; i++) {
+        if (material->sections[i].mf == mf && material->sections[i].mt == mt)
+            return &material->sections[i];
+    }
+    errno = ENODATA;
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+float library_amu(const library_index_t* index, int z, const float neutron_mass) {
+    const libraryMaterial* material = find_library_material(index, z);
+    if (!material) return -1.0f;
+    return material->awr * neutron_mass;
+}
+// --------------------------------------------------------------------------------
+
+void free_library_index(library_index_t* index) {
+    if (!index) return;
+    free(index->directory);
+    free(index->paths);
+    free(index->materials);
+    free(index->sections);
+    free(index->file_sizes);
+    free(index->mtimes);
+    free(index);
+}
+// --------------------------------------------------------------------------------
+
+void _free_library_index(library_index_t** index) {
+    if (index && *index) {
+        free_library_index(*index);
+        *index = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// PARALLEL LIBRARY LOADER
+
+struct xsec_library_t {
+    libraryTable* tables;
+    size_t len;
+    loadResult* results;
+    size_t num_results;
+    char* names;
+    endfMaterial* materials;
+};
+
+typedef struct {
+    loadResult* results;
+    endfMaterial* materials;
+    size_t len;
+    atomic_size_t next;
+} load_job;
+// --------------------------------------------------------------------------------
+
+static double elapsed_seconds(const struct timespec* start) {
+    struct timespec stop;
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    return (double)(stop.tv_sec - start->tv_sec) + 1.0e-9 * (double)(stop.tv_nsec - start->tv_nsec);
+}
+// --------------------------------------------------------------------------------
+
+static void* load_worker(void* arg) {
+    load_job* job = arg;
+    size_t i;
+    while ((i = atomic_fetch_add(&job->next, 1)) < job->len) {
+        loadResult* result = &job->results[i];
+        if (!result->file_name) continue;
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        result->error = read_endf_material(result->file_name, &job->materials[i]);
+        result->num_tables = job->materials[i].len;
+        result->seconds = elapsed_seconds(&start);
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+static int compare_tables(const void* a, const void* b) {
+    const libraryTable* ta = a;
+    const libraryTable* tb = b;
+    if (ta->za != tb->za) return ta->za < tb->za ? -1 : 1;
+    if (ta->mf != tb->mf) return ta->mf < tb->mf ? -1 : 1;
+    if (ta->mt != tb->mt) return ta->mt < tb->mt ? -1 : 1;
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Loads the files named in a result array that has already been filled with
+ * file names.  The library takes ownership of `results` and `names`.
+ */
+static xsec_library_t* load_results(loadResult* results, size_t len, char* names,
+                                    size_t num_threads) {
+    xsec_library_t* library = calloc(1, sizeof(xsec_library_t));
+    endfMaterial* materials = calloc(len > 0 ? len : 1, sizeof(endfMaterial));
+    if (!library || !materials) {
+        free(library);
+        free(materials);
+        free(results);
+        free(names);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for xsec_library_t");
+        return NULL;
+    }
+    library->results = results;
+    library->num_results = len;
+    library->names = names;
+    library->materials = materials;
+
+    load_job job = { .results = results, .materials = materials, .len = len };
+    atomic_init(&job.next, 0);
+    if (len > 0) run_workers(load_worker, &job, len, num_threads);
+
+    size_t num_tables = 0;
+    for (size_t i = 0; i < len; i++) num_tables += materials[i].len;
+    library->tables = malloc((num_tables > 0 ? num_tables : 1) * sizeof(libraryTable));
+    if (!library->tables) {
+        free_xsec_library(library);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for xsec_library_t");
+        return NULL;
+    }
+    for (size_t i = 0; i < len; i++) {
+        for (size_t j = 0; j < materials[i].len; j++) {
+            library->tables[library->len++] = (libraryTable){
+                .za = materials[i].za,
+                .awr = materials[i].awr,
+                .mat = materials[i].mat,
+                .mf = materials[i].tables[j].mf,
+                .mt = materials[i].tables[j].mt,
+                .xsec = materials[i].tables[j].xsec
+            };
+        }
+    }
+    // A stable order keeps the tables of the first listed file ahead of duplicates
+    for (size_t i = 1; i < library->len; i++) {
+        libraryTable table = library->tables[i];
+        size_t j = i;
+        while (j > 0 && compare_tables(&library->tables[j - 1], &table) > 0) {
+            library->tables[j] = library->tables[j - 1];
+            j--;
+        }
+        library->tables[j] = table;
+    }
+    return library;
+}
+// --------------------------------------------------------------------------------
+
+xsec_library_t* load_xsec_library(const char* const* file_names, size_t num_files,
+                                  size_t num_threads) {
+    if (!file_names) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to load_xsec_library");
+        return NULL;
+    }
+    size_t bytes = 0;
+    for (size_t i = 0; i < num_files; i++) {
+        if (!file_names[i]) {
+            CENDF_REPORT(EINVAL, "Null file name passed to load_xsec_library");
+            return NULL;
+        }
+        bytes += strlen(file_names[i]) + 1;
+    }
+    // The library keeps its own copy of the file names
+    loadResult* results = calloc(num_files > 0 ? num_files : 1, sizeof(loadResult));
+    char* names = malloc(bytes > 0 ? bytes : 1);
+    if (!results || !names) {
+        free(results);
+        free(names);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for xsec_library_t");
+        return NULL;
+    }
+    char* name = names;
+    for (size_t i = 0; i < num_files; i++) {
+        size_t len = strlen(file_names[i]) + 1;
+        memcpy(name, file_names[i], len);
+        results[i].file_name = name;
+        name += len;
+    }
+    return load_results(results, num_files, names, num_threads);
+}
+// --------------------------------------------------------------------------------
+
+xsec_library_t* load_xsec_directory(const char* directory, size_t num_threads) {
+    if (!directory) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to load_xsec_directory");
+        return NULL;
+    }
+    size_t len = 0;
+    char** names = list_endf_files(directory, &len);
+    if (!names) {
+        CENDF_REPORT(errno, "Unable to read directory %s: %s", directory, strerror(errno));
+        return NULL;
+    }
+    char** paths = calloc(len > 0 ? len : 1, sizeof(char*));
+    size_t joined = 0;
+    for (; paths && joined < len; joined++) {
+        paths[joined] = join_path(directory, names[joined]);
+        if (!paths[joined]) break;
+    }
+    xsec_library_t* library = NULL;
+    if (paths && joined == len) {
+        library = load_xsec_library((const char* const*)paths, len, num_threads);
+    } else {
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for xsec_library_t");
+    }
+    if (paths) free_names(paths, joined);
+    free_names(names, len);
+    return library;
+}
+// --------------------------------------------------------------------------------
+
+xsec_library_t* load_xsec_elements(const library_index_t* index, const int* z, size_t num_z,
+                                   size_t num_threads) {
+    if (!index || !z) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to load_xsec_elements");
+        return NULL;
+    }
+    loadResult* results = calloc(num_z > 0 ? num_z : 1, sizeof(loadResult));
+    if (!results) {
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for xsec_library_t");
+        return NULL;
+    }
+    // File names point into the index, which outlives the load
+    const int saved_errno = errno;
+    for (size_t i = 0; i < num_z; i++) {
+        const libraryMaterial* material = find_library_material(index, z[i]);
+        results[i].file_name = material ? material->file_name : NULL;
+        results[i].error = material ? 0 : ENODATA;
+    }
+    errno = saved_errno;
+    xsec_library_t* library = load_results(results, num_z, NULL, num_threads);
+    if (!library) return NULL;
+
+    // Keep the file names valid after the index is freed
+    size_t bytes = 0;
+    for (size_t i = 0; i < num_z; i++)
+        if (results[i].file_name) bytes += strlen(results[i].file_name) + 1;
+    library->names = malloc(bytes > 0 ? bytes : 1);
+    if (!library->names) {
+        free_xsec_library(library);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for xsec_library_t");
+        return NULL;
+    }
+    char* name = library->names;
+    for (size_t i = 0; i < num_z; i++) {
+        if (!results[i].file_name) continue;
+        size_t len = strlen(results[i].file_name) + 1;
+        memcpy(name, results[i].file_name, len);
+        results[i].file_name = name;
+        name += len;
+    }
+    return library;
+}
+// --------------------------------------------------------------------------------
+
+size_t xsec_library_size(const xsec_library_t* library) {
+    if (!library) {
+        errno = EINVAL;
+        return 0;
+    }
+    return library->len;
+}
+// --------------------------------------------------------------------------------
+
+const libraryTable* get_library_tables(const xsec_library_t* library) {
+    if (!library) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return library->tables;
+}
+// --------------------------------------------------------------------------------
+
+static int compare_table_key(const libraryTable* table, int z, int mf, int mt) {
+    int table_z = (int)(table->za / 1000.0f);
+    if (table_z != z) return table_z < z ? -1 : 1;
+    if (table->mf != mf) return table->mf < mf ? -1 : 1;
+    if (table->mt != mt) return table->mt < mt ? -1 : 1;
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+const xsec_t* get_library_xsec(const xsec_library_t* library, int z, int mf, int mt) {
+    if (!library) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to get_library_xsec");
+        return NULL;
+    }
+    size_t low = 0;
+    size_t high = library->len;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (compare_table_key(&library->tables[mid], z, mf, mt) < 0) low = mid + 1;
+        else high = mid;
+    }
+    if (low < library->len && compare_table_key(&library->tables[low], z, mf, mt) == 0)
+        return library->tables[low].xsec;
+    errno = ENODATA;
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+bool thin_xsec_library(xsec_library_t* library, float tolerance, size_t* removed) {
+    if (!library || !(tolerance >= 0.0f)) {
+        CENDF_REPORT(EINVAL, "Invalid arguments passed to thin_xsec_library");
+        return false;
+    }
+    size_t total = 0;
+    bool ok = true;
+    // The tables are owned through the materials they were read with
+    for (size_t i = 0; ok && i < library->num_results; i++) {
+        const endfMaterial* material = &library->materials[i];
+        for (size_t t = 0; ok && t < material->len; t++) {
+            size_t count = 0;
+            ok = thin_xsec(material->tables[t].xsec, tolerance, &count);
+            total += count;
+        }
+    }
+    if (removed) *removed = total;
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+size_t xsec_library_files(const xsec_library_t* library) {
+    if (!library) {
+        errno = EINVAL;
+        return 0;
+    }
+    return library->num_results;
+}
+// --------------------------------------------------------------------------------
+
+const loadResult* get_load_results(const xsec_library_t* library) {
+    if (!library) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return library->results;
+}
+// --------------------------------------------------------------------------------
+
+void free_xsec_library(xsec_library_t* library) {
+    if (!library) return;
+    for (size_t i = 0; i < library->num_results; i++)
+        free_endf_material(&library->materials[i]);
+    free(library->materials);
+    free(library->tables);
+    free(library->results);
+    free(library->names);
+    free(library);
+}
+// --------------------------------------------------------------------------------
+
+void _free_xsec_library(xsec_library_t** library) {
+    if (library && *library) {
+        free_xsec_library(*library);
+        *library = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
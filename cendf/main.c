@@ -1,7 +1,7 @@
 // ================================================================================
 // ================================================================================
 // - File:    main.c
-// - Purpose: Describe the file purpose here
+// - Purpose: cendf_mc, a reference photon transport benchmark built on the library
 //
 // Source Metadata
 // - Author:  Jonathan A. Webb
@@ -12,14 +12,927 @@
 // ================================================================================
 // Include modules here
 
+#include "include/mixture.h"
+#include "include/sampler.h"
+
+#include <dirent.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SLABS 16
+// Pair production leaves at most two annihilation photons waiting
+#define MAX_BANK 8
+
+// The electron rest mass energy in eV
+static const double ELECTRON_MASS = 510998.95;
+// Planck's constant times the speed of light in eV-cm
+static const double HC = 1.23984198e-4;
+// MF23 coherent, incoherent, pair production and photoelectric, in sampler order
+static const int PARTIALS[] = {502, 504, 516, 522};
+enum { COHERENT, INCOHERENT, PAIR, PHOTOELECTRIC, NUM_REACTIONS };
+static const int TOTAL[] = {501};
+
+static const char* DEFAULT_DIRECTORY = "../../../data/xsec/photoat-version.VIII.1";
+static const char* DEFAULT_TABLE = "../../../data/periodic_table/periodic_table.json";
+static const char* DEFAULT_SLABS[] = {"Fe:5:7.874", "Pb:2:11.35"};
+// ================================================================================
+// ================================================================================
+
+/*
+ * Phases of a history whose time is reported.  Tracking is what is left of
+ * the transport time: random numbers, distances and boundary crossings.
+ */
+typedef enum {
+    PHASE_LOOKUP,     // Total macroscopic cross section at each flight
+    PHASE_REACTION,   // Selection of the reaction at each collision
+    PHASE_COLLISION,  // Scattering kinematics, with their form factor lookups
+    PHASE_TRACKING,
+    NUM_PHASES
+} phaseType;
+
+static const char* PHASE_NAME[NUM_PHASES] = {"xs lookup", "reaction select",
+                                             "collision", "tracking"};
+// --------------------------------------------------------------------------------
+
+/*
+ * A homogeneous slab of one element between x0 and x1 along the beam axis
+ */
+typedef struct {
+    char symbol[4];
+    material_t* material;
+    mixture_t* total;              // MT501 in 1/cm
+    reaction_sampler_t* sampler;   // The partials in 1/cm
+    const xsec_t* incoherent;      // Incoherent scattering function S(x, Z)
+    float* coherent_u;             // Squared momentum transfer of the form factor grid
+    float* coherent_cdf;           // Integral of F(x, Z)^2 over u
+    size_t coherent_len;
+    float z;
+    float density;
+    double x0;
+    double x1;
+} slab_t;
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    double x;
+    float mu;       // Direction cosine with the beam axis
+    float energy;
+    int slab;
+    uint64_t rng;   // The random stream of the photon
+} photon_t;
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    size_t transmitted;
+    size_t reflected;
+    size_t absorbed;
+    size_t cutoff;
+    size_t collisions;
+    size_t reaction[NUM_REACTIONS];
+    size_t lookups;
+    double transmitted_energy;
+    double phase_ns[NUM_PHASES];
+    size_t phase_calls[NUM_PHASES];     // Photons processed in each phase
+    size_t phase_timers[NUM_PHASES];    // Timed intervals of each phase
+} tally_t;
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    size_t histories;
+    size_t batch;       // Histories per batch of the event-based driver
+    bool event;         // Whether to use the event-based driver
+    float energy;
+    float cutoff;
+    uint64_t seed;
+    const char* directory;
+    const char* table;
+} options_t;
+// ================================================================================
+// ================================================================================
+
+static inline double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1.0e9 + (double)t.tv_nsec;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * The cost of one timer read, which is taken out of every timed phase
+ */
+static double timer_overhead(void) {
+    const int reads = 1 << 16;
+    volatile double sink;
+    double start = now_ns();
+    for (int i = 0; i < reads; i++) sink = now_ns();
+    (void) sink;
+    return (now_ns() - start) / reads;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Every history draws from its own stream, seeded from the run seed and its
+ * index, so a history does not depend on the order histories are run in.
+ */
+static inline uint64_t splitmix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * A uniform random number on [0, 1)
+ */
+static inline float uniform(uint64_t* state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return (float)(*state >> 40) * 0x1p-24f;
+}
+// ================================================================================
+// ================================================================================
+
+/*
+ * Tabulates the integral of F(x, Z)^2 over u = x^2, which the coherent
+ * scattering angle is sampled from.
+ */
+static bool build_coherent_cdf(slab_t* slab, const xsec_t* form_factor) {
+    const size_t len = xsec_size(form_factor);
+    const float* x = get_xsec_enArray(form_factor);
+    const float* f = get_xsec_xsArray(form_factor);
+    slab->coherent_u = malloc(len * sizeof(float));
+    slab->coherent_cdf = malloc(len * sizeof(float));
+    if (!slab->coherent_u || !slab->coherent_cdf || len < 2) return false;
+    double sum = 0.0;
+    slab->coherent_u[0] = x[0] * x[0];
+    slab->coherent_cdf[0] = 0.0f;
+    for (size_t i = 1; i < len; i++) {
+        const double u0 = (double)x[i - 1] * x[i - 1];
+        const double u1 = (double)x[i] * x[i];
+        sum += 0.5 * ((double)f[i - 1] * f[i - 1] + (double)f[i] * f[i]) * (u1 - u0);
+        slab->coherent_u[i] = (float)u1;
+        slab->coherent_cdf[i] = (float)sum;
+    }
+    slab->coherent_len = len;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Finds the photo-atomic file of an element, named photoat-ZZZ_Symbol_000.endf
+ */
+static bool find_element_file(const char* directory, const char* symbol, char* file_name,
+                              size_t size) {
+    DIR* dir = opendir(directory);
+    if (!dir) return false;
+    bool found = false;
+    struct dirent* entry;
+    while (!found && (entry = readdir(dir))) {
+        int z;
+        char name[4];
+        if (sscanf(entry->d_name, "photoat-%3d_%3[A-Za-z]_", &z, name) == 2 &&
+            strcmp(name, symbol) == 0) {
+            snprintf(file_name, size, "%s/%s", directory, entry->d_name);
+            found = true;
+        }
+    }
+    closedir(dir);
+    return found;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Parses "Symbol:thickness[:density]" and builds the cross sections of the slab
+ */
+static bool open_slab(slab_t* slab, const char* spec, double x0, const options_t* options) {
+    char symbol[4] = {0};
+    float thickness = 0.0f;
+    float density = 0.0f;
+    int fields = sscanf(spec, "%3[A-Za-z]:%f:%f", symbol, &thickness, &density);
+    if (fields < 2 || !(thickness > 0.0f) || (fields == 3 && !(density > 0.0f))) {
+        fprintf(stderr, "Invalid slab '%s', expected Symbol:thickness[:density]\n", spec);
+        return false;
+    }
+    // Without a density of its own the slab takes that of the periodic table
+    if (fields == 2) {
+        element_t* element = fetch_element_data(symbol, options->table);
+        if (element) {
+            density = element_density(element);
+            free_element(element);
+        }
+        if (!(density > 0.0f)) {
+            fprintf(stderr, "No density for %s in %s, give one as %s:%g:density\n", symbol,
+                    options->table, symbol, thickness);
+            return false;
+        }
+    }
+    char file_name[1024];
+    if (!find_element_file(options->directory, symbol, file_name, sizeof(file_name))) {
+        fprintf(stderr, "No photo-atomic file for %s in %s\n", symbol, options->directory);
+        return false;
+    }
+    memcpy(slab->symbol, symbol, sizeof(symbol));
+    slab->density = density;
+    slab->x0 = x0;
+    slab->x1 = x0 + thickness;
+    slab->material = open_material(file_name);
+    if (!slab->material) return false;
+    slab->z = floorf(endf_index_za(get_material_index(slab->material)) / 1000.0f);
+
+    // The atomic weight of the mixture defaults to the AWR of the file
+    const mixtureComponent component[] = {{.material = slab->material, .fraction = 1.0f}};
+    slab->total = build_mixture(component, 1, MIXTURE_MASS_FRACTION, density, 23, TOTAL, 1);
+    mixture_t* partials = build_mixture(component, 1, MIXTURE_MASS_FRACTION, density, 23,
+                                        PARTIALS, NUM_REACTIONS);
+    if (partials) slab->sampler = init_reaction_sampler(get_mixture_grid(partials));
+    free_mixture(partials);
+    slab->incoherent = get_material_xsec(slab->material, 27, 504);
+    const xsec_t* form_factor = get_material_xsec(slab->material, 27, 502);
+    if (!slab->total || !slab->sampler || !slab->incoherent || !form_factor ||
+        !build_coherent_cdf(slab, form_factor)) {
+        fprintf(stderr, "Unable to build the cross sections of %s\n", file_name);
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void close_slab(slab_t* slab) {
+    free_reaction_sampler(slab->sampler);
+    free_mixture(slab->total);
+    free(slab->coherent_u);
+    free(slab->coherent_cdf);
+    free_material(slab->material);
+}
+// ================================================================================
+// ================================================================================
+
+/*
+ * Turns a direction cosine by a polar angle with cosine `cost` and a random azimuth
+ */
+static inline float rotate(float mu, float cost, uint64_t* rng) {
+    const float phi = 2.0f * (float)M_PI * uniform(rng);
+    const float sint = sqrtf(fmaxf(0.0f, 1.0f - cost * cost));
+    const float sinm = sqrtf(fmaxf(0.0f, 1.0f - mu * mu));
+    return fminf(1.0f, fmaxf(-1.0f, mu * cost + sinm * sint * cosf(phi)));
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Samples the cosine of a coherent scattering angle: u = x^2 from F(x, Z)^2,
+ * then the Thomson factor (1 + cos^2) / 2 by rejection.
+ */
+static float sample_coherent(const slab_t* slab, float energy, uint64_t* rng, tally_t* tally) {
+    const double k = energy / HC;
+    const float u_max = (float)(k * k);
+    const float* u = slab->coherent_u;
+    const float* cdf = slab->coherent_cdf;
+    const size_t len = slab->coherent_len;
+
+    // The integral up to the largest momentum transfer at this energy
+    size_t top = 0;
+    size_t high = len - 1;
+    while (high - top > 1) {
+        size_t mid = top + (high - top) / 2;
+        if (u[mid] <= u_max) top = mid;
+        else high = mid;
+    }
+    float cdf_max = cdf[len - 1];
+    if (u_max < u[len - 1])
+        cdf_max = cdf[top] + (cdf[top + 1] - cdf[top]) * (u_max - u[top]) / (u[top + 1] - u[top]);
+    tally->lookups++;
+
+    for (;;) {
+        const float target = uniform(rng) * cdf_max;
+        size_t low = 0;
+        high = top + 1;
+        while (high - low > 1) {
+            size_t mid = low + (high - low) / 2;
+            if (cdf[mid] <= target) low = mid;
+            else high = mid;
+        }
+        tally->lookups++;
+        const float width = cdf[low + 1] - cdf[low];
+        const float value = width > 0.0f
+            ? u[low] + (u[low + 1] - u[low]) * (target - cdf[low]) / width : u[low];
+        const float cost = fmaxf(-1.0f, 1.0f - 2.0f * fminf(value, u_max) / u_max);
+        if (2.0f * uniform(rng) <= 1.0f + cost * cost) return cost;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Samples an incoherent scattering from the Klein-Nishina formula, rejected
+ * by S(x, Z) / Z.  Returns the cosine of the angle and sets the new energy.
+ */
+static float sample_incoherent(const slab_t* slab, float* energy, uint64_t* rng,
+                               tally_t* tally) {
+    const double kappa = *energy / ELECTRON_MASS;
+    const double eps0 = 1.0 / (1.0 + 2.0 * kappa);
+    const double eps0sq = eps0 * eps0;
+    const double alpha1 = -log(eps0);
+    const double alpha2 = alpha1 + 0.5 * (1.0 - eps0sq);
+    const float* x = get_xsec_enArray(slab->incoherent);
+    const float x_last = x[xsec_size(slab->incoherent) - 1];
+
+    for (;;) {
+        double eps, epssq, onecost, greject;
+        do {
+            if (alpha1 > alpha2 * uniform(rng)) {
+                eps = exp(-alpha1 * uniform(rng));
+                epssq = eps * eps;
+            } else {
+                epssq = eps0sq + (1.0 - eps0sq) * uniform(rng);
+                eps = sqrt(epssq);
+            }
+            onecost = (1.0 - eps) / (eps * kappa);
+            const double sint2 = onecost * (2.0 - onecost);
+            greject = 1.0 - eps * sint2 / (1.0 + epssq);
+        } while (greject < uniform(rng));
+
+        // Binding: the momentum transfer must be large enough to free the electron
+        const float momentum = (float)(*energy / HC * sqrt(0.5 * onecost));
+        float s = slab->z;
+        if (momentum < x_last) {
+            cendfStatus status;
+            s = interp_xsec_status(slab->incoherent, momentum, &status);
+            tally->lookups++;
+        }
+        if (uniform(rng) * slab->z <= s) {
+            *energy = (float)(*energy * eps);
+            return (float)(1.0 - onecost);
+        }
+    }
+}
+// ================================================================================
+// ================================================================================
+
+/*
+ * The outcome of a flight
+ */
+typedef enum {
+    FLIGHT_COLLISION,   // The photon collides in its slab
+    FLIGHT_CROSSING,    // The photon enters the next slab and needs a new lookup
+    FLIGHT_END          // The photon left the slabs or can not be followed
+} flightResult;
+// --------------------------------------------------------------------------------
+
+/*
+ * Flies a photon with total cross section `sigma` to its next collision or
+ * the boundary of its slab.  A history that ends is tallied here.
+ */
+static inline flightResult fly(const slab_t* slabs, int num_slabs, float sigma, double* x,
+                               float mu, int* slab, float energy, uint64_t* rng,
+                               tally_t* tally) {
+    if (!(sigma > 0.0f)) {
+        tally->cutoff++;
+        return FLIGHT_END;
+    }
+    const slab_t* current = slabs + *slab;
+    const double distance = -log(1.0 - uniform(rng)) / sigma;
+    double boundary = INFINITY;
+    if (mu > 0.0f) boundary = (current->x1 - *x) / mu;
+    else if (mu < 0.0f) boundary = (current->x0 - *x) / mu;
+    if (distance < boundary) {
+        *x += distance * mu;
+        tally->collisions++;
+        return FLIGHT_COLLISION;
+    }
+    *x = mu > 0.0f ? current->x1 : current->x0;
+    *slab += mu > 0.0f ? 1 : -1;
+    if (*slab < 0) {
+        tally->reflected++;
+        return FLIGHT_END;
+    }
+    if (*slab >= num_slabs) {
+        tally->transmitted++;
+        tally->transmitted_energy += energy;
+        return FLIGHT_END;
+    }
+    return FLIGHT_CROSSING;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Applies a collision of type `reaction` to a photon, returning false if the
+ * photon is absorbed or falls below the cutoff.  Pair production fills the
+ * direction, energy and random stream of its two annihilation photons.
+ */
+static inline bool collide(const slab_t* slab, int reaction, float* mu, float* energy,
+                           uint64_t* rng, float cutoff, photon_t* pair, tally_t* tally) {
+    tally->reaction[reaction]++;
+    switch (reaction) {
+        case COHERENT:
+            *mu = rotate(*mu, sample_coherent(slab, *energy, rng, tally), rng);
+            return true;
+        case INCOHERENT:
+            *mu = rotate(*mu, sample_incoherent(slab, energy, rng, tally), rng);
+            if (*energy >= cutoff) return true;
+            tally->cutoff++;
+            return false;
+        case PAIR: {
+            // The positron annihilates at rest into two opposite photons, each
+            // with a stream of its own
+            const float cost = 2.0f * uniform(rng) - 1.0f;
+            for (int k = 0; k < 2; k++) {
+                pair[k].mu = k == 0 ? cost : -cost;
+                pair[k].energy = (float)ELECTRON_MASS;
+                pair[k].rng = splitmix(*rng + (uint64_t)k + 1u);
+            }
+            tally->absorbed++;
+            return false;
+        }
+        default:
+            tally->absorbed++;
+            return false;
+    }
+}
+// ================================================================================
+// ================================================================================
+// HISTORY-BASED TRANSPORT
+
+/*
+ * Follows one photon until it leaves the slabs or is absorbed, pushing any
+ * annihilation photons onto the bank.
+ */
+static void track(photon_t p, const slab_t* slabs, int num_slabs, const options_t* options,
+                  photon_t* bank, int* banked, tally_t* tally) {
+    for (;;) {
+        const slab_t* slab = slabs + p.slab;
+        double start = now_ns();
+        float sigma;
+        cendfStatus status;
+        if (!interp_mixture_status(slab->total, p.energy, &sigma, &status)) sigma = -1.0f;
+        double stop = now_ns();
+        tally->phase_ns[PHASE_LOOKUP] += stop - start;
+        tally->phase_calls[PHASE_LOOKUP]++;
+        tally->phase_timers[PHASE_LOOKUP]++;
+        tally->lookups++;
+
+        const flightResult flight = fly(slabs, num_slabs, sigma, &p.x, p.mu, &p.slab,
+                                        p.energy, &p.rng, tally);
+        if (flight == FLIGHT_END) return;
+        if (flight == FLIGHT_CROSSING) continue;
+
+        start = now_ns();
+        const int reaction = sample_reaction_status(slab->sampler, p.energy, uniform(&p.rng),
+                                                    &status);
+        stop = now_ns();
+        tally->phase_ns[PHASE_REACTION] += stop - start;
+        tally->phase_calls[PHASE_REACTION]++;
+        tally->phase_timers[PHASE_REACTION]++;
+        tally->lookups++;
+        if (reaction < 0) {
+            tally->cutoff++;
+            return;
+        }
+
+        start = now_ns();
+        photon_t pair[2];
+        const bool alive = collide(slab, reaction, &p.mu, &p.energy, &p.rng, options->cutoff,
+                                   pair, tally);
+        if (reaction == PAIR) {
+            for (int k = 0; k < 2; k++) {
+                pair[k].x = p.x;
+                pair[k].slab = p.slab;
+                bank[(*banked)++] = pair[k];
+            }
+        }
+        stop = now_ns();
+        tally->phase_ns[PHASE_COLLISION] += stop - start;
+        tally->phase_calls[PHASE_COLLISION]++;
+        tally->phase_timers[PHASE_COLLISION]++;
+        if (!alive) return;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static bool run_histories(const slab_t* slabs, int num_slabs, const options_t* options,
+                          tally_t* tally) {
+    photon_t bank[MAX_BANK];
+    for (size_t h = 0; h < options->histories; h++) {
+        int banked = 0;
+        const photon_t source = {.x = 0.0, .mu = 1.0f, .energy = options->energy, .slab = 0,
+                                 .rng = splitmix(options->seed ^ splitmix(h))};
+        track(source, slabs, num_slabs, options, bank, &banked, tally);
+        while (banked > 0) {
+            photon_t p = bank[--banked];
+            track(p, slabs, num_slabs, options, bank, &banked, tally);
+        }
+    }
+    return true;
+}
+// ================================================================================
+// ================================================================================
+// EVENT-BASED TRANSPORT
+
+/*
+ * Queues of the event-based driver.  A reaction queue holds the photons
+ * about to undergo that reaction, so its index is the index of the reaction.
+ */
+enum {
+    QUEUE_LOOKUP = NUM_REACTIONS,   // Photons that need a total cross section
+    QUEUE_COLLISION,                // Photons that need a reaction
+    QUEUE_NEXT,                     // The lookup queue of the next step
+    NUM_QUEUES
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * Photons in structure-of-arrays form, so a kernel reads only the fields it
+ * needs, and the queues of indices that hold them between kernels.
+ */
+typedef struct {
+    double* x;
+    float* mu;
+    float* energy;
+    int* slab;
+    uint64_t* rng;
+    float* sigma;
+    size_t len;
+    size_t capacity;
+    size_t* queue[NUM_QUEUES];
+    size_t count[NUM_QUEUES];
+    // Scratch space of the batched lookups
+    size_t* sorted;
+    float* energies;
+    float* random;
+    float* values;
+    int* reaction;
+} bank_t;
+// --------------------------------------------------------------------------------
+
+static void free_bank(bank_t* bank) {
+    free(bank->x);
+    free(bank->mu);
+    free(bank->energy);
+    free(bank->slab);
+    free(bank->rng);
+    free(bank->sigma);
+    for (int q = 0; q < NUM_QUEUES; q++) free(bank->queue[q]);
+    free(bank->sorted);
+    free(bank->energies);
+    free(bank->random);
+    free(bank->values);
+    free(bank->reaction);
+}
+// --------------------------------------------------------------------------------
+
+static bool init_bank(bank_t* bank, size_t capacity) {
+    memset(bank, 0, sizeof(bank_t));
+    bank->capacity = capacity;
+    bank->x = malloc(capacity * sizeof(double));
+    bank->mu = malloc(capacity * sizeof(float));
+    bank->energy = malloc(capacity * sizeof(float));
+    bank->slab = malloc(capacity * sizeof(int));
+    bank->rng = malloc(capacity * sizeof(uint64_t));
+    bank->sigma = malloc(capacity * sizeof(float));
+    bool ok = bank->x && bank->mu && bank->energy && bank->slab && bank->rng && bank->sigma;
+    for (int q = 0; q < NUM_QUEUES; q++)
+        ok = (bank->queue[q] = malloc(capacity * sizeof(size_t))) && ok;
+    bank->sorted = malloc(capacity * sizeof(size_t));
+    bank->energies = malloc(capacity * sizeof(float));
+    bank->random = malloc(capacity * sizeof(float));
+    bank->values = malloc(capacity * sizeof(float));
+    bank->reaction = malloc(capacity * sizeof(int));
+    ok = ok && bank->sorted && bank->energies && bank->random && bank->values && bank->reaction;
+    if (!ok) free_bank(bank);
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t add_photon(bank_t* bank, double x, float mu, float energy, int slab,
+                                uint64_t rng) {
+    const size_t p = bank->len++;
+    bank->x[p] = x;
+    bank->mu[p] = mu;
+    bank->energy[p] = energy;
+    bank->slab[p] = slab;
+    bank->rng[p] = rng;
+    return p;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Orders a queue by slab, stably, into `bank->sorted` and records where the
+ * photons of each slab start, so every batched lookup stays in one table.
+ */
+static void sort_by_slab(bank_t* bank, const size_t* queue, size_t count, int num_slabs,
+                         size_t* start) {
+    for (int s = 0; s <= num_slabs; s++) start[s] = 0;
+    for (size_t i = 0; i < count; i++) start[bank->slab[queue[i]] + 1]++;
+    for (int s = 0; s < num_slabs; s++) start[s + 1] += start[s];
+    size_t fill[MAX_SLABS];
+    memcpy(fill, start, num_slabs * sizeof(size_t));
+    for (size_t i = 0; i < count; i++)
+        bank->sorted[fill[bank->slab[queue[i]]]++] = queue[i];
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Evaluates the total cross section of every photon in the lookup queue
+ */
+static void lookup_kernel(bank_t* bank, const slab_t* slabs, int num_slabs) {
+    size_t start[MAX_SLABS + 1];
+    const size_t count = bank->count[QUEUE_LOOKUP];
+    sort_by_slab(bank, bank->queue[QUEUE_LOOKUP], count, num_slabs, start);
+    for (size_t i = 0; i < count; i++) bank->energies[i] = bank->energy[bank->sorted[i]];
+    for (int s = 0; s < num_slabs; s++) {
+        const size_t first = start[s];
+        const size_t n = start[s + 1] - first;
+        if (n == 0) continue;
+        interp_mixture_batch(slabs[s].total, bank->energies + first, bank->values + first, n);
+    }
+    for (size_t i = 0; i < count; i++) bank->sigma[bank->sorted[i]] = bank->values[i];
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Flies every photon of the lookup queue, sending those that collide to the
+ * collision queue and those that cross into another slab to the next step
+ */
+static void flight_kernel(bank_t* bank, const slab_t* slabs, int num_slabs, tally_t* tally) {
+    const size_t* queue = bank->queue[QUEUE_LOOKUP];
+    for (size_t i = 0; i < bank->count[QUEUE_LOOKUP]; i++) {
+        const size_t p = queue[i];
+        const flightResult flight = fly(slabs, num_slabs, bank->sigma[p], bank->x + p,
+                                        bank->mu[p], bank->slab + p, bank->energy[p],
+                                        bank->rng + p, tally);
+        if (flight == FLIGHT_COLLISION)
+            bank->queue[QUEUE_COLLISION][bank->count[QUEUE_COLLISION]++] = p;
+        else if (flight == FLIGHT_CROSSING)
+            bank->queue[QUEUE_NEXT][bank->count[QUEUE_NEXT]++] = p;
+    }
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Selects the reaction of every photon in the collision queue and sends it to
+ * the queue of that reaction
+ */
+static void reaction_kernel(bank_t* bank, const slab_t* slabs, int num_slabs, tally_t* tally) {
+    size_t start[MAX_SLABS + 1];
+    const size_t count = bank->count[QUEUE_COLLISION];
+    sort_by_slab(bank, bank->queue[QUEUE_COLLISION], count, num_slabs, start);
+    for (size_t i = 0; i < count; i++) {
+        const size_t p = bank->sorted[i];
+        bank->energies[i] = bank->energy[p];
+        bank->random[i] = uniform(bank->rng + p);
+    }
+    for (int s = 0; s < num_slabs; s++) {
+        const size_t first = start[s];
+        const size_t n = start[s + 1] - first;
+        if (n == 0) continue;
+        sample_reaction_batch(slabs[s].sampler, bank->energies + first, bank->random + first,
+                              bank->reaction + first, n);
+    }
+    for (size_t i = 0; i < count; i++) {
+        const int reaction = bank->reaction[i];
+        if (reaction < 0) {
+            tally->cutoff++;
+            continue;
+        }
+        bank->queue[reaction][bank->count[reaction]++] = bank->sorted[i];
+    }
+    bank->count[QUEUE_COLLISION] = 0;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Applies the collisions of one reaction queue, sending the photons that
+ * survive and any annihilation photons to the next step
+ */
+static void collision_kernel(bank_t* bank, const slab_t* slabs, int reaction, float cutoff,
+                             tally_t* tally) {
+    const size_t* queue = bank->queue[reaction];
+    for (size_t i = 0; i < bank->count[reaction]; i++) {
+        const size_t p = queue[i];
+        photon_t pair[2];
+        if (collide(slabs + bank->slab[p], reaction, bank->mu + p, bank->energy + p,
+                    bank->rng + p, cutoff, pair, tally))
+            bank->queue[QUEUE_NEXT][bank->count[QUEUE_NEXT]++] = p;
+        if (reaction == PAIR) {
+            for (int k = 0; k < 2; k++) {
+                const size_t q = add_photon(bank, bank->x[p], pair[k].mu, pair[k].energy,
+                                            bank->slab[p], pair[k].rng);
+                bank->queue[QUEUE_NEXT][bank->count[QUEUE_NEXT]++] = q;
+            }
+        }
+    }
+    bank->count[reaction] = 0;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Runs the histories in batches.  Each step applies one kernel to every
+ * photon waiting for its event: the total cross section lookups, grouped by
+ * slab, the flights, the reaction selections, and the collisions of each
+ * reaction in turn.
+ */
+static bool run_events(const slab_t* slabs, int num_slabs, const options_t* options,
+                       tally_t* tally) {
+    // A source photon and the two annihilation photons of its pair production,
+    // which at 511 keV can not produce pairs of their own
+    bank_t bank;
+    if (!init_bank(&bank, 3 * options->batch)) {
+        fprintf(stderr, "Unable to allocate a bank of %zu photons\n", 3 * options->batch);
+        return false;
+    }
+    for (size_t first = 0; first < options->histories; first += options->batch) {
+        const size_t remaining = options->histories - first;
+        const size_t n = remaining < options->batch ? remaining : options->batch;
+        bank.len = 0;
+        for (size_t i = 0; i < n; i++) {
+            const uint64_t rng = splitmix(options->seed ^ splitmix(first + i));
+            bank.queue[QUEUE_LOOKUP][i] = add_photon(&bank, 0.0, 1.0f, options->energy, 0, rng);
+        }
+        bank.count[QUEUE_LOOKUP] = n;
+
+        while (bank.count[QUEUE_LOOKUP] > 0) {
+            const size_t lookups = bank.count[QUEUE_LOOKUP];
+            double start = now_ns();
+            lookup_kernel(&bank, slabs, num_slabs);
+            double stop = now_ns();
+            tally->phase_ns[PHASE_LOOKUP] += stop - start;
+            tally->phase_calls[PHASE_LOOKUP] += lookups;
+            tally->phase_timers[PHASE_LOOKUP]++;
+            tally->lookups += lookups;
+
+            // The flights follow the slab order the lookups were made in
+            size_t* sorted = bank.sorted;
+            bank.sorted = bank.queue[QUEUE_LOOKUP];
+            bank.queue[QUEUE_LOOKUP] = sorted;
+            bank.count[QUEUE_NEXT] = 0;
+            flight_kernel(&bank, slabs, num_slabs, tally);
+
+            const size_t collisions = bank.count[QUEUE_COLLISION];
+            start = now_ns();
+            reaction_kernel(&bank, slabs, num_slabs, tally);
+            stop = now_ns();
+            tally->phase_ns[PHASE_REACTION] += stop - start;
+            tally->phase_calls[PHASE_REACTION] += collisions;
+            tally->phase_timers[PHASE_REACTION]++;
+            tally->lookups += collisions;
+
+            start = now_ns();
+            size_t applied = 0;
+            for (int r = 0; r < NUM_REACTIONS; r++) {
+                applied += bank.count[r];
+                collision_kernel(&bank, slabs, r, options->cutoff, tally);
+            }
+            stop = now_ns();
+            tally->phase_ns[PHASE_COLLISION] += stop - start;
+            tally->phase_calls[PHASE_COLLISION] += applied;
+            tally->phase_timers[PHASE_COLLISION]++;
+
+            size_t* swap = bank.queue[QUEUE_LOOKUP];
+            bank.queue[QUEUE_LOOKUP] = bank.queue[QUEUE_NEXT];
+            bank.queue[QUEUE_NEXT] = swap;
+            bank.count[QUEUE_LOOKUP] = bank.count[QUEUE_NEXT];
+        }
+    }
+    free_bank(&bank);
+    return true;
+}
+// ================================================================================
+// ================================================================================
+
+static void usage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [-n histories] [-e energy] [-c cutoff] [-s seed] [-d directory]\n"
+            "          [-p periodic_table] [-m history|event] [-b batch]\n"
+            "          [Symbol:thickness[:density] ...]\n\n"
+            "Runs a pencil beam of photons of `energy` eV through slabs of elements, each\n"
+            "`thickness` cm thick with a density in g/cm^3 that defaults to the periodic table.\n"
+            "Defaults: -n 1000000 -e 1e6 -c 1e3 -s 1 -m history -b 65536 Fe:5:7.874 Pb:2:11.35\n",
+            name);
+}
+// --------------------------------------------------------------------------------
+
+static void report(const slab_t* slabs, int num_slabs, const options_t* options,
+                   const tally_t* tally, double setup_s, double wall_s, double overhead) {
+    const double histories = (double)options->histories;
+    printf("cendf_mc: %zu histories of %.4g eV photons, seed %llu, ", options->histories,
+           options->energy, (unsigned long long)options->seed);
+    if (options->event) printf("event-based in batches of %zu\n", options->batch);
+    else printf("history-based\n");
+    for (int s = 0; s < num_slabs; s++)
+        printf("  slab %d: %-2s Z = %2.0f, %8.3f cm, %8.4g g/cm^3, %zu grid points\n", s,
+               slabs[s].symbol, slabs[s].z, slabs[s].x1 - slabs[s].x0, slabs[s].density,
+               reaction_sampler_size(slabs[s].sampler));
+
+    // A timed phase holds one timer read and the tracking between phases the
+    // other, so both are taken out, and the rates are for transport without timers
+    size_t timers = 0;
+    for (int p = 0; p < PHASE_TRACKING; p++) timers += tally->phase_timers[p];
+    const double timers_s = 2.0 * overhead * (double)timers * 1.0e-9;
+    const double transport_s = fmax(wall_s - timers_s, 1.0e-9);
+
+    printf("\nPerformance\n");
+    printf("  setup            %10.3f s\n", setup_s);
+    printf("  transport        %10.3f s (%.3f s wall, %.3f s in phase timers)\n", transport_s,
+           wall_s, timers_s);
+    printf("  particles/s      %10.4g\n", histories / transport_s);
+    printf("  lookups/s        %10.4g\n", (double)tally->lookups / transport_s);
+    printf("  lookups/history  %10.2f\n", (double)tally->lookups / histories);
+
+    // Tracking is what the timed phases leave of the transport time
+    double phase_ns[NUM_PHASES];
+    double timed = 0.0;
+    for (int p = 0; p < PHASE_TRACKING; p++) {
+        phase_ns[p] = fmax(0.0, tally->phase_ns[p] - overhead * (double)tally->phase_timers[p]);
+        timed += phase_ns[p];
+    }
+    phase_ns[PHASE_TRACKING] = fmax(0.0, transport_s * 1.0e9 - timed);
+    printf("\nTime per phase\n");
+    for (int p = 0; p < NUM_PHASES; p++) {
+        printf("  %-16s %10.3f s %6.1f %%", PHASE_NAME[p], phase_ns[p] * 1.0e-9,
+               100.0 * phase_ns[p] / (transport_s * 1.0e9));
+        if (p != PHASE_TRACKING && tally->phase_calls[p] > 0)
+            printf(" %8.1f ns/call", phase_ns[p] / (double)tally->phase_calls[p]);
+        printf("\n");
+    }
+
+    const size_t photons = tally->transmitted + tally->reflected + tally->absorbed + tally->cutoff;
+    printf("\nTallies per source photon\n");
+    printf("  photons tracked  %10.5f\n", (double)photons / histories);
+    printf("  transmitted      %10.5f\n", (double)tally->transmitted / histories);
+    printf("  reflected        %10.5f\n", (double)tally->reflected / histories);
+    printf("  absorbed         %10.5f\n", (double)tally->absorbed / histories);
+    printf("  below cutoff     %10.5f\n", (double)tally->cutoff / histories);
+    printf("  collisions       %10.5f\n", (double)tally->collisions / histories);
+    printf("  energy out       %10.5f\n",
+           tally->transmitted_energy / (histories * options->energy));
+    const char* names[NUM_REACTIONS] = {"coherent", "incoherent", "pair", "photoelectric"};
+    for (int r = 0; r < NUM_REACTIONS; r++)
+        printf("  %-16s %10.5f\n", names[r], (double)tally->reaction[r] / histories);
+}
+// ================================================================================
+// ================================================================================
 
 // Begin code
-int main(int argc, const char * argv[]) {
-	printf("Hello, World\n");
-	return 0;
+int main(int argc, char * argv[]) {
+    options_t options = {
+        .histories = 1000000,
+        .batch = 65536,
+        .energy = 1.0e6f,
+        .cutoff = 1.0e3f,
+        .seed = 1,
+        .directory = DEFAULT_DIRECTORY,
+        .table = DEFAULT_TABLE
+    };
+    int opt;
+    while ((opt = getopt(argc, argv, "n:e:c:s:d:p:m:b:h")) != -1) {
+        switch (opt) {
+            case 'n': options.histories = strtoull(optarg, NULL, 10); break;
+            case 'e': options.energy = strtof(optarg, NULL); break;
+            case 'c': options.cutoff = strtof(optarg, NULL); break;
+            case 's': options.seed = strtoull(optarg, NULL, 10); break;
+            case 'd': options.directory = optarg; break;
+            case 'p': options.table = optarg; break;
+            case 'm': options.event = strcmp(optarg, "event") == 0; break;
+            case 'b': options.batch = strtoull(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    const int num_specs = optind < argc ? argc - optind : 2;
+    const char* const* specs = optind < argc ? (const char* const*)argv + optind : DEFAULT_SLABS;
+    if (options.histories == 0 || options.batch == 0 || !(options.energy > 0.0f) ||
+        !(options.cutoff >= 0.0f) || num_specs > MAX_SLABS) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    double start = now_ns();
+    slab_t slabs[MAX_SLABS] = {0};
+    double x = 0.0;
+    int num_slabs = 0;
+    bool ok = true;
+    for (; num_slabs < num_specs && ok; num_slabs++) {
+        ok = open_slab(slabs + num_slabs, specs[num_slabs], x, &options);
+        x = slabs[num_slabs].x1;
+    }
+    const double setup_s = (now_ns() - start) * 1.0e-9;
+
+    if (ok) {
+        tally_t tally = {0};
+        const double overhead = timer_overhead();
+        start = now_ns();
+        if (options.event) ok = run_events(slabs, num_slabs, &options, &tally);
+        else ok = run_histories(slabs, num_slabs, &options, &tally);
+        const double transport_s = (now_ns() - start) * 1.0e-9;
+        if (ok) report(slabs, num_slabs, &options, &tally, setup_s, transport_s, overhead);
+    }
+    for (int s = 0; s < num_slabs; s++) close_slab(slabs + s);
+    return ok ? 0 : 1;
 }
 // ================================================================================
 // ================================================================================
 // eof
-
@@ -0,0 +1,161 @@
+// ================================================================================
+// ================================================================================
+// - File:    material.c
+// - Purpose: Material handles that read cross sections on first use
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/material.h"
+
+#include <string.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+// ================================================================================
+// ================================================================================
+// LAZY MATERIAL HANDLE
+
+/*
+ * One slot per section of the directory.  A table is published with a
+ * release store once it is fully built, so readers that see a non-NULL
+ * pointer with an acquire load also see its contents.  The mutex is only
+ * taken by the threads that find the slot empty.
+ */
+typedef struct {
+    _Atomic(xsec_t*) xsec;
+    atomic_int error;
+    pthread_mutex_t lock;
+} section_slot;
+
+struct material_t {
+    endf_index_t* index;
+    section_slot* slots;
+    size_t len;
+};
+// --------------------------------------------------------------------------------
+
+material_t* open_material(const char* file_name) {
+    if (!file_name) {
+        CENDF_REPORT(EINVAL, "Null file name passed to open_material");
+        return NULL;
+    }
+    endf_index_t* index = read_endf_index(file_name);
+    if (!index) return NULL;
+
+    const size_t len = endf_index_size(index);
+    material_t* material = malloc(sizeof(material_t));
+    section_slot* slots = material ? malloc(len * sizeof(section_slot)) : NULL;
+    if (!slots) {
+        free(material);
+        free_endf_index(index);
+        CENDF_REPORT(ENOMEM, "material_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    for (size_t i = 0; i < len; i++) {
+        atomic_init(&slots[i].xsec, NULL);
+        atomic_init(&slots[i].error, 0);
+        pthread_mutex_init(&slots[i].lock, NULL);
+    }
+    material->index = index;
+    material->slots = slots;
+    material->len = len;
+    return material;
+}
+// --------------------------------------------------------------------------------
+
+const xsec_t* get_material_xsec(material_t* material, int mf, int mt) {
+    if (!material) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to get_material_xsec");
+        return NULL;
+    }
+    const endfSection* sections = get_endf_sections(material->index);
+    size_t i = 0;
+    while (i < material->len && (sections[i].mf != mf || sections[i].mt != mt)) i++;
+    if (i == material->len) {
+        errno = ENODATA;
+        return NULL;
+    }
+
+    section_slot* slot = &material->slots[i];
+    xsec_t* xsec = atomic_load_explicit(&slot->xsec, memory_order_acquire);
+    if (xsec) return xsec;
+    int error = atomic_load_explicit(&slot->error, memory_order_acquire);
+    if (error != 0) {
+        errno = error;
+        return NULL;
+    }
+
+    // Only one thread parses a section; the others wait for its result
+    pthread_mutex_lock(&slot->lock);
+    xsec = atomic_load_explicit(&slot->xsec, memory_order_relaxed);
+    error = atomic_load_explicit(&slot->error, memory_order_relaxed);
+    if (!xsec && error == 0) {
+        errno = 0;
+        xsec = read_indexed_xsec(material->index, mf, mt);
+        if (xsec) {
+            atomic_store_explicit(&slot->xsec, xsec, memory_order_release);
+        } else {
+            error = errno != 0 ? errno : EINVAL;
+            // A failed allocation may succeed later, so only data errors are kept
+            if (error != ENOMEM)
+                atomic_store_explicit(&slot->error, error, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&slot->lock);
+    if (!xsec) errno = error;
+    return xsec;
+}
+// --------------------------------------------------------------------------------
+
+const endf_index_t* get_material_index(const material_t* material) {
+    if (!material) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return material->index;
+}
+// --------------------------------------------------------------------------------
+
+size_t material_loaded_tables(const material_t* material) {
+    if (!material) {
+        errno = EINVAL;
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < material->len; i++) {
+        if (atomic_load_explicit(&material->slots[i].xsec, memory_order_acquire))
+            count++;
+    }
+    return count;
+}
+// --------------------------------------------------------------------------------
+
+void free_material(material_t* material) {
+    if (!material) return;
+    for (size_t i = 0; i < material->len; i++) {
+        xsec_t* xsec = atomic_load_explicit(&material->slots[i].xsec, memory_order_acquire);
+        if (xsec) free_xsec(xsec);
+        pthread_mutex_destroy(&material->slots[i].lock);
+    }
+    free(material->slots);
+    free_endf_index(material->index);
+    free(material);
+}
+// --------------------------------------------------------------------------------
+
+void _free_material(material_t** material) {
+    if (material && *material) {
+        free_material(*material);
+        *material = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,236 @@
+// ================================================================================
+// ================================================================================
+// - File:    mixture.c
+// - Purpose: Macroscopic cross sections of compounds, alloys and other mixtures
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/mixture.h"
+
+#include <string.h>
+#include <errno.h>
+
+// Square centimeters per barn
+static const double BARN = 1.0e-24;
+// ================================================================================
+// ================================================================================
+
+struct mixture_t {
+    union_grid_t* grid;
+    double* atom_density;   // Atoms per barn-cm of each component
+    size_t num_components;
+    float density;
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * Computes the atom density of every component in atoms per barn-cm.
+ * Returns false if the definition of the mixture is invalid.
+ */
+static bool atom_densities(const mixtureComponent* components, size_t num_components,
+                           mixtureBasis basis, float density, double* atom_density) {
+    double fraction_sum = 0.0;
+    double weight_sum = 0.0;
+    for (size_t c = 0; c < num_components; c++) {
+        const mixtureComponent* component = components + c;
+        if (!component->material || !(component->fraction >= 0.0f) ||
+            !(component->atomic_weight >= 0.0f)) {
+            CENDF_REPORT(EINVAL, "Invalid component %zu passed to build_mixture", c);
+            return false;
+        }
+        // Without a weight of its own the component takes the AWR of its file
+        double weight = component->atomic_weight;
+        if (weight == 0.0)
+            weight = endf_index_awr(get_material_index(component->material)) * CENDF_NEUTRON_MASS;
+        if (!(weight > 0.0)) {
+            CENDF_REPORT(EINVAL, "Unknown atomic weight of component %zu passed to build_mixture", c);
+            return false;
+        }
+        atom_density[c] = weight;
+        fraction_sum += component->fraction;
+        weight_sum += component->fraction * weight;
+    }
+    if (!(fraction_sum > 0.0)) {
+        CENDF_REPORT(EINVAL, "Fractions passed to build_mixture sum to zero");
+        return false;
+    }
+
+    // N = rho * NA * w / A for a mass fraction w, where w = x * A / sum(x * A)
+    // for an atom fraction x
+    const double scale = density * CENDF_AVOGADRO * BARN;
+    for (size_t c = 0; c < num_components; c++) {
+        const double weight = atom_density[c];
+        const double fraction = components[c].fraction;
+        if (basis == MIXTURE_ATOM_FRACTION)
+            atom_density[c] = scale * fraction / weight_sum;
+        else
+            atom_density[c] = scale * fraction / (fraction_sum * weight);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+mixture_t* build_mixture(const mixtureComponent* components, size_t num_components,
+                         mixtureBasis basis, float density, int mf, const int* mt,
+                         size_t num_mt) {
+    if (!components || num_components == 0 || !mt || num_mt == 0 || !(density > 0.0f) ||
+        (basis != MIXTURE_MASS_FRACTION && basis != MIXTURE_ATOM_FRACTION)) {
+        CENDF_REPORT(EINVAL, "Invalid arguments passed to build_mixture");
+        return NULL;
+    }
+    mixture_t* mixture = calloc(1, sizeof(mixture_t));
+    if (!mixture || !(mixture->atom_density = malloc(num_components * sizeof(double)))) {
+        free(mixture);
+        CENDF_REPORT(ENOMEM, "mixture_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    mixture->num_components = num_components;
+    mixture->density = density;
+    if (!atom_densities(components, num_components, basis, density, mixture->atom_density)) {
+        free_mixture(mixture);
+        return NULL;
+    }
+
+    // Column c * num_mt + r of the component grid is reaction r of component c
+    const size_t num_tables = num_components * num_mt;
+    const xsec_t** tables = malloc(num_tables * sizeof(xsec_t*));
+    double* weights = calloc(num_mt * num_tables, sizeof(double));
+    if (!tables || !weights) {
+        free(tables);
+        free(weights);
+        free_mixture(mixture);
+        CENDF_REPORT(ENOMEM, "mixture_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    for (size_t c = 0; c < num_components; c++) {
+        for (size_t r = 0; r < num_mt; r++) {
+            const size_t column = c * num_mt + r;
+            tables[column] = get_material_xsec(components[c].material, mf, mt[r]);
+            if (!tables[column]) {
+                int error = errno;
+                free(tables);
+                free(weights);
+                free_mixture(mixture);
+                CENDF_REPORT(error, "Unable to read MF%d/MT%d of component %zu for a mixture",
+                             mf, mt[r], c);
+                return NULL;
+            }
+            weights[r * num_tables + column] = mixture->atom_density[c];
+        }
+    }
+
+    // The component grid is only needed until its columns are summed
+    union_grid_t* components_grid = init_union_grid(tables, num_tables);
+    if (components_grid)
+        mixture->grid = combine_union_grid(components_grid, weights, num_mt);
+    free_union_grid(components_grid);
+    free(tables);
+    free(weights);
+    if (!mixture->grid) {
+        free_mixture(mixture);
+        return NULL;
+    }
+    return mixture;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_mixture_status(const mixture_t* mixture, float energy, float* xs,
+                           cendfStatus* status) {
+    if (!mixture) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return false;
+    }
+    return interp_union_grid_status(mixture->grid, energy, xs, status);
+}
+// --------------------------------------------------------------------------------
+
+bool interp_mixture(const mixture_t* mixture, float energy, float* xs) {
+    cendfStatus status;
+    if (interp_mixture_status(mixture, energy, xs, &status)) return true;
+    if (status == CENDF_STATUS_INVALID)
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_mixture");
+    else
+        errno = ERANGE;
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_mixture_batch(const mixture_t* mixture, const float* energies, float* xs,
+                          size_t n) {
+    if (!mixture) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_mixture_batch");
+        return false;
+    }
+    return interp_union_grid_batch(mixture->grid, energies, xs, n);
+}
+// --------------------------------------------------------------------------------
+
+size_t mixture_reactions(const mixture_t* mixture) {
+    if (!mixture) {
+        errno = EINVAL;
+        return 0;
+    }
+    return union_grid_reactions(mixture->grid);
+}
+// --------------------------------------------------------------------------------
+
+size_t mixture_components(const mixture_t* mixture) {
+    if (!mixture) {
+        errno = EINVAL;
+        return 0;
+    }
+    return mixture->num_components;
+}
+// --------------------------------------------------------------------------------
+
+float mixture_density(const mixture_t* mixture) {
+    if (!mixture) {
+        errno = EINVAL;
+        return -1.0f;
+    }
+    return mixture->density;
+}
+// --------------------------------------------------------------------------------
+
+double mixture_atom_density(const mixture_t* mixture, size_t component) {
+    if (!mixture || component >= mixture->num_components) {
+        errno = EINVAL;
+        return -1.0;
+    }
+    return mixture->atom_density[component];
+}
+// --------------------------------------------------------------------------------
+
+const union_grid_t* get_mixture_grid(const mixture_t* mixture) {
+    if (!mixture) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return mixture->grid;
+}
+// --------------------------------------------------------------------------------
+
+void free_mixture(mixture_t* mixture) {
+    if (!mixture) return;
+    free_union_grid(mixture->grid);
+    free(mixture->atom_density);
+    free(mixture);
+}
+// --------------------------------------------------------------------------------
+
+void _free_mixture(mixture_t** mixture) {
+    if (mixture && *mixture) {
+        free_mixture(*mixture);
+        *mixture = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -16,18 +16,879 @@
 
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// ENDF records are 80 columns wide; the sequence number in columns 76-80 is
+// optional, so a record is only required to reach the end of the MT field.
+#define ENDF_FIELD_WIDTH 11
+#define ENDF_FIELDS_PER_RECORD 6
+#define ENDF_MF_COLUMN 70
+#define ENDF_MT_COLUMN 72
+#define ENDF_RECORD_MIN 75
+
+// Number of records decoded per call to the batch tokenizer when reading TAB1 data
+#define TAB1_BLOCK_RECORDS 128
+
+// Size of the read buffer of the streaming reader, and the number of
+// interpolation ranges or (x, y) pairs delivered per callback
+#define ENDF_STREAM_BUFFER 65536
+#define ENDF_STREAM_BLOCK (3 * TAB1_BLOCK_RECORDS)
+// ================================================================================ 
+// ================================================================================ 
+// ENDF RECORD HELPERS
+
+typedef struct {
+    const char* data;
+    size_t size;
+} endf_map;
+// --------------------------------------------------------------------------------
+
+static bool map_endf_file(const char* file_name, endf_map* map, int advice) {
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0) {
+        errno = ENOENT;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        errno = ENOENT;
+        return false;
+    }
+    void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping holds its own reference to the file
+    if (ptr == MAP_FAILED) {
+        errno = ENOENT;
+        return false;
+    }
+    madvise(ptr, (size_t)st.st_size, advice);
+    map->data = ptr;
+    map->size = (size_t)st.st_size;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void unmap_endf_file(endf_map* map) {
+    if (map->data) {
+        munmap((void*)map->data, map->size);
+        map->data = NULL;
+        map->size = 0;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static const char* next_record(const char* rec, const char* end) {
+    const char* eol = memchr(rec, '\n', (size_t)(end - rec));
+    return eol ? eol + 1 : end;
+}
+// --------------------------------------------------------------------------------
+
+static bool record_complete(const char* rec, const char* next) {
+    size_t len = (size_t)(next - rec);
+    if (len > 0 && rec[len - 1] == '\n') len--;
+    return len >= ENDF_RECORD_MIN;
+}
+// --------------------------------------------------------------------------------
+
+static int parse_digits(const char* str, size_t len) {
+    int value = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] >= '0' && str[i] <= '9')
+            value = value * 10 + (str[i] - '0');
+    }
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+static bool record_matches(const char* rec, int mf, int mt) {
+    return parse_digits(rec + ENDF_MF_COLUMN, 2) == mf &&
+           parse_digits(rec + ENDF_MT_COLUMN, 3) == mt;
+}
+// --------------------------------------------------------------------------------
+
+static const double pow10_table[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+// --------------------------------------------------------------------------------
+
+static double scale_pow10(double value, int exponent) {
+    // Both operands are exact for small exponents, so a single rounding occurs
+    if (exponent >= -22 && exponent <= 22)
+        return exponent >= 0 ? value * pow10_table[exponent] : value / pow10_table[-exponent];
+
+    // Otherwise build the power of ten in extended precision to limit rounding
+    long double scale = 1.0L;
+    for (int i = exponent < 0 ? -exponent : exponent; i > 0; i -= 22)
+        scale *= (long double)pow10_table[i < 22 ? i : 22];
+    return (double)(exponent >= 0 ? (long double)value * scale : (long double)value / scale);
+}
+// --------------------------------------------------------------------------------
+
+// ================================================================================ 
+// ================================================================================ 
+// ENDF FIELD TOKENIZER
+
+/*
+ * Decodes one 11 character ENDF real field.  Accepts the usual C notation as
+ * well as the FORTRAN shorthand that drops the exponent character
+ * (e.g. 1.36301-4).  A blank field is decoded as zero.
+ */
+static bool parse_field_scalar(const char* field, double* value) {
+    const char* ptr = field;
+    const char* end = field + ENDF_FIELD_WIDTH;
+    while (ptr < end && *ptr == ' ') ptr++;
+    if (ptr == end) {
+        *value = 0.0;
+        return true;
+    }
+
+    bool negative = false;
+    if (*ptr == '+' || *ptr == '-') {
+        negative = *ptr == '-';
+        ptr++;
+    }
+
+    unsigned long long mantissa = 0;
+    int scale = 0;
+    int digits = 0;
+    for (; ptr < end && *ptr >= '0' && *ptr <= '9'; ptr++, digits++)
+        mantissa = mantissa * 10 + (unsigned long long)(*ptr - '0');
+    if (ptr < end && *ptr == '.') {
+        for (ptr++; ptr < end && *ptr >= '0' && *ptr <= '9'; ptr++, digits++, scale--)
+            mantissa = mantissa * 10 + (unsigned long long)(*ptr - '0');
+    }
+    if (digits == 0) return false;
+
+    int exponent = 0;
+    if (ptr < end && *ptr != ' ') {
+        if (*ptr == 'E' || *ptr == 'e' || *ptr == 'D' || *ptr == 'd') ptr++;
+        bool exp_negative = false;
+        if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+            exp_negative = *ptr == '-';
+            ptr++;
+        }
+        if (ptr == end || *ptr < '0' || *ptr > '9') return false;
+        for (; ptr < end && *ptr >= '0' && *ptr <= '9'; ptr++)
+            exponent = exponent * 10 + (*ptr - '0');
+        if (exp_negative) exponent = -exponent;
+    }
+    while (ptr < end && *ptr == ' ') ptr++;
+    if (ptr != end) return false;
+
+    double result = scale_pow10((double)mantissa, exponent + scale);
+    *value = negative ? -result : result;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+#if defined(__SSE2__)
+static const unsigned long long pow10_u64[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * SSE2 version of parse_field_scalar.  The character classes of the field are
+ * found with vector compares, the decimal point is squeezed out with a one
+ * byte shift, and all mantissa digits are converted to an integer with three
+ * multiply-add stages.  The field is loaded 16 bytes at a time, so the caller
+ * must guarantee 5 readable bytes beyond the field, which always holds inside
+ * a complete ENDF record.  Returns false for anything other than the common
+ * layouts, in which case the caller falls back to the scalar parser.
+ */
+static bool parse_field_sse2(const char* field, double* value) {
+    const __m128i chars = _mm_loadu_si128((const __m128i*)field);
+    const unsigned width_mask = (1u << ENDF_FIELD_WIDTH) - 1;
+    unsigned space = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' '))) & width_mask;
+    if (space == width_mask) {
+        *value = 0.0;
+        return true;
+    }
+    unsigned digit = (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                      _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)))) & width_mask;
+    unsigned dot = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('.'))) & width_mask;
+    unsigned minus = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('-'))) & width_mask;
+    unsigned sign = minus | ((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+'))) & width_mask);
+
+    unsigned pos = (unsigned)__builtin_ctz(~space & width_mask);
+    bool negative = false;
+    if ((sign >> pos) & 1u) {
+        negative = (minus >> pos) & 1u;
+        pos++;
+    }
+
+    // The mantissa is the run of digits and at most one decimal point
+    const unsigned m0 = pos;
+    const unsigned m1 = m0 + (unsigned)__builtin_ctz(~((digit | dot) >> m0));
+    const unsigned run = (1u << (m1 - m0)) - 1u;
+    const unsigned dots = (dot >> m0) & run;
+    if (dots & (dots - 1u)) return false;
+    const unsigned ndigits = m1 - m0 - (dots ? 1u : 0u);
+    if (ndigits == 0) return false;
+    const unsigned point = dots ? m0 + (unsigned)__builtin_ctz(dots) : 16u;
+    const int fraction = dots ? (int)(m1 - point - 1u) : 0;
+
+    int exponent = 0;
+    pos = m1;
+    if (pos < ENDF_FIELD_WIDTH && !((space >> pos) & 1u)) {
+        const char c = field[pos];
+        if (c == 'E' || c == 'e' || c == 'D' || c == 'd') pos++;
+        bool exp_negative = false;
+        if (pos < ENDF_FIELD_WIDTH && ((sign >> pos) & 1u)) {
+            exp_negative = (minus >> pos) & 1u;
+            pos++;
+        }
+        const unsigned e1 = pos + (unsigned)__builtin_ctz(~(digit >> pos));
+        if (e1 == pos || e1 > ENDF_FIELD_WIDTH) return false;
+        for (; pos < e1; pos++)
+            exponent = exponent * 10 + (field[pos] - '0');
+        if (exp_negative) exponent = -exponent;
+    }
+    if ((space >> pos) != (width_mask >> pos)) return false;
+
+    // Remove the decimal point by shifting every byte after it down by one,
+    // then keep only the mantissa digits
+    const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i shifted = _mm_srli_si128(chars, 1);
+    const __m128i after_point = _mm_cmpgt_epi8(index, _mm_set1_epi8((char)(point - 1u)));
+    __m128i digits = _mm_or_si128(_mm_and_si128(after_point, shifted),
+                                  _mm_andnot_si128(after_point, chars));
+    const __m128i keep = _mm_and_si128(_mm_cmpgt_epi8(index, _mm_set1_epi8((char)(m0 - 1u))),
+                                       _mm_cmplt_epi8(index, _mm_set1_epi8((char)(m0 + ndigits))));
+    digits = _mm_and_si128(_mm_sub_epi8(digits, _mm_set1_epi8('0')), keep);
+
+    // Positional conversion of 16 digits: pairs, quads, then two 8 digit lanes
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w10 = _mm_setr_epi16(10, 1, 10, 1, 10, 1, 10, 1);
+    const __m128i w100 = _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1);
+    const __m128i w10000 = _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1);
+    __m128i pairs = _mm_packs_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(digits, zero), w10),
+                                    _mm_madd_epi16(_mm_unpackhi_epi8(digits, zero), w10));
+    __m128i quads = _mm_madd_epi16(pairs, w100);
+    quads = _mm_packs_epi32(quads, quads);
+    __m128i octets = _mm_madd_epi16(quads, w10000);
+    unsigned long long high = (unsigned)_mm_cvtsi128_si32(octets);
+    unsigned long long low = (unsigned)_mm_cvtsi128_si32(_mm_srli_si128(octets, 4));
+
+    // The digits sit at the front of a 16 digit integer, so the value carries
+    // trailing zeros that are folded into the power of ten
+    unsigned long long mantissa = high * 100000000ULL + low;
+    const int trailing = 16 - (int)(m0 + ndigits);
+    int scale = exponent - fraction - trailing;
+    if (scale < -22 || scale > 22) {
+        mantissa /= pow10_u64[trailing];
+        scale += trailing;
+    }
+    double result = scale_pow10((double)mantissa, scale);
+    *value = negative ? -result : result;
+    return true;
+}
+#endif
+// --------------------------------------------------------------------------------
+
+static inline bool parse_field(const char* field, double* value) {
+#if defined(__SSE2__)
+    if (parse_field_sse2(field, value)) return true;
+#endif
+    return parse_field_scalar(field, value);
+}
+// --------------------------------------------------------------------------------
+
+static bool decode_record(const char* rec, double* values) {
+    for (int i = 0; i < ENDF_FIELDS_PER_RECORD; i++) {
+        if (!parse_field(rec + i * ENDF_FIELD_WIDTH, &values[i])) return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Decodes up to `count` consecutive records starting at `*cursor`.  When `mf`
+ * is positive every record must also belong to the (MF, MT) section.  The
+ * cursor is advanced past the decoded records.
+ */
+static size_t decode_records(const char** cursor, const char* end, size_t count,
+                             double* values, int mf, int mt) {
+    const char* rec = *cursor;
+    size_t i = 0;
+    for (; i < count && rec < end; i++) {
+        const char* next = next_record(rec, end);
+        if (!record_complete(rec, next) || (mf > 0 && !record_matches(rec, mf, mt)))
+            break;
+        if (!decode_record(rec, values + i * ENDF_FIELDS_PER_RECORD))
+            break;
+        rec = next;
+    }
+    *cursor = rec;
+    return i;
+}
+// --------------------------------------------------------------------------------
+
+static const char* find_section(const char* rec, const char* end, int mf, int mt) {
+    while (rec < end) {
+        const char* next = next_record(rec, end);
+        if (record_complete(rec, next) && record_matches(rec, mf, mt))
+            return rec;
+        rec = next;
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Checks TAB1 interpolation ranges against the rules of set_xsec_interpolation.
+ */
+static bool valid_ranges(const size_t* nbt, const int* law, size_t nr, size_t np) {
+    if (nr == 0 || nbt[nr - 1] != np) return false;
+    for (size_t i = 0; i < nr; i++) {
+        if (law[i] < 1 || law[i] > 5 || nbt[i] == 0 || (i > 0 && nbt[i] <= nbt[i - 1]))
+            return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Reads the control record and the interpolation ranges of the TAB1 section
+ * that starts at `head`, and leaves `*cursor` at its first (x, y) record.
+ * The ranges are allocated here and freed by the caller.
+ */
+static bool parse_tab1_ranges(const char* head, const char* end, int mf, int mt,
+                              const char** cursor, size_t* nr, size_t* np,
+                              size_t** nbt, int** law) {
+    // The TAB1 control record follows the HEAD record and holds NR and NP
+    const char* rec = next_record(head, end);
+    double cont[ENDF_FIELDS_PER_RECORD];
+    if (decode_records(&rec, end, 1, cont, mf, mt) != 1 || cont[4] < 1.0 || cont[5] < 1.0) {
+        errno = EINVAL;
+        return false;
+    }
+    *nr = (size_t)cont[4];
+    *np = (size_t)cont[5];
+
+    // Read the interpolation table, three (NBT, INT) pairs per record
+    *nbt = malloc(*nr * sizeof(size_t));
+    *law = malloc(*nr * sizeof(int));
+    if (!*nbt || !*law) {
+        free(*nbt);
+        free(*law);
+        errno = ENOMEM;
+        return false;
+    }
+    for (size_t i = 0; i < (*nr + 2) / 3; i++) {
+        double pairs[ENDF_FIELDS_PER_RECORD];
+        if (decode_records(&rec, end, 1, pairs, mf, mt) != 1) {
+            free(*nbt);
+            free(*law);
+            errno = EINVAL;
+            return false;
+        }
+        for (size_t j = 0; j < 3 && 3 * i + j < *nr; j++) {
+            (*nbt)[3 * i + j] = (size_t)pairs[2 * j];
+            (*law)[3 * i + j] = (int)pairs[2 * j + 1];
+        }
+    }
+    *cursor = rec;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static xsec_t* parse_tab1_xsec(const char* head, const char* end, int mf, int mt) {
+    const char* rec;
+    size_t nr, np;
+    size_t* nbt;
+    int* law;
+    if (!parse_tab1_ranges(head, end, mf, mt, &rec, &nr, &np, &nbt, &law)) return NULL;
+
+    xsec_t* xsec = init_xsec(np);
+    if (!xsec) {
+        free(nbt);
+        free(law);
+        return NULL;
+    }
+
+    // Decode the (energy, cross section) pairs in blocks of records
+    double values[TAB1_BLOCK_RECORDS * ENDF_FIELDS_PER_RECORD];
+    size_t remaining = (np + 2) / 3;
+    size_t count = 0;
+    while (remaining > 0) {
+        size_t block = remaining < TAB1_BLOCK_RECORDS ? remaining : TAB1_BLOCK_RECORDS;
+        if (decode_records(&rec, end, block, values, mf, mt) != block) break;
+        for (size_t i = 0; i < 3 * block && count < np; i++, count++)
+            push_xsec(xsec, (float)values[2 * i + 1], (float)values[2 * i]);
+        remaining -= block;
+    }
+    // The ranges are checked here so that malformed data fails quietly
+    int error = remaining > 0 || !valid_ranges(nbt, law, nr, np) ? EINVAL : 0;
+    if (error == 0 && !set_xsec_interpolation(xsec, nbt, law, nr)) error = errno;
+    free(nbt);
+    free(law);
+    if (error != 0) {
+        free_xsec(xsec);
+        errno = error;
+        return NULL;
+    }
+    return xsec;
+}
+// ================================================================================ 
+// ================================================================================ 
+// MF1/MT451 DIRECTORY INDEX
+
+struct endf_index_t {
+    endf_map map;
+    size_t record_length;
+    float za;
+    float awr;
+    int mat;
+    endfSection* sections;
+    size_t len;
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * Parses the MF1/MT451 directory of a mapped file.  The HEAD record of MT451
+ * supplies ZA and AWR, the third control record supplies the number of text
+ * records (NWD) and directory entries (NXC), and each directory entry lists
+ * MF, MT and the number of records (NC) in the section.  When every record
+ * has the same length, byte offsets follow directly from the record counts,
+ * since every section is closed by one SEND record and every file by one FEND
+ * record.  Otherwise the offsets are found with a single pass over the file.
+ */
+static bool parse_directory(endf_index_t* index) {
+    const char* data = index->map.data;
+    const char* end = data + index->map.size;
+
+    // The tape identification record may precede the MT451 HEAD record
+    const char* head = data;
+    for (int i = 0; i < 2 && head < end; i++) {
+        const char* next = next_record(head, end);
+        if (record_complete(head, next) && record_matches(head, 1, 451)) break;
+        head = next;
+    }
+    if (head >= end || !record_complete(head, next_record(head, end)) ||
+        !record_matches(head, 1, 451))
+        return false;
+
+    const char* rec = head;
+    double values[4 * ENDF_FIELDS_PER_RECORD];
+    if (decode_records(&rec, end, 4, values, 1, 451) != 4) return false;
+    if (values[22] < 0.0 || values[23] < 1.0) return false;
+    const size_t nwd = (size_t)values[22];
+    const size_t nxc = (size_t)values[23];
+    index->za = (float)values[0];
+    index->awr = (float)values[1];
+    index->mat = parse_digits(head + ENDF_MF_COLUMN - 4, 4);
+
+    for (size_t i = 0; i < nwd && rec < end; i++)
+        rec = next_record(rec, end);
+
+    endfSection* sections = malloc(nxc * sizeof(endfSection));
+    if (!sections) return false;
+    for (size_t i = 0; i < nxc; i++) {
+        if (decode_records(&rec, end, 1, values, 1, 451) != 1 ||
+            values[2] < 1.0 || values[3] < 1.0 || values[4] < 1.0) {
+            free(sections);
+            return false;
+        }
+        sections[i].mf = (int)values[2];
+        sections[i].mt = (int)values[3];
+        sections[i].records = (size_t)values[4];
+        sections[i].offset = 0;
+    }
+
+    const char* first_eol = memchr(data, '\n', index->map.size);
+    size_t length = first_eol ? (size_t)(first_eol - data) + 1 : 0;
+    bool uniform = length > ENDF_RECORD_MIN &&
+                   (index->map.size % length == 0 ||
+                    ((index->map.size + 1) % length == 0 && end[-1] != '\n'));
+    if (uniform) {
+        size_t line = (size_t)(head - data) / length;
+        int mf = sections[0].mf;
+        for (size_t i = 0; i < nxc; i++) {
+            if (sections[i].mf != mf) {
+                line++;  // FEND record closing the previous file
+                mf = sections[i].mf;
+            }
+            sections[i].offset = line * length;
+            line += sections[i].records + 1;  // Section records and SEND record
+        }
+    } else {
+        length = 0;
+        for (size_t i = 0; i < nxc; i++) {
+            const char* start = find_section(head, end, sections[i].mf, sections[i].mt);
+            sections[i].offset = start ? (size_t)(start - data) : index->map.size;
+        }
+    }
+    index->record_length = length;
+    index->sections = sections;
+    index->len = nxc;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool open_endf_index(const char* file_name, endf_index_t* index) {
+    if (!map_endf_file(file_name, &index->map, MADV_RANDOM)) return false;
+    if (!parse_directory(index)) {
+        unmap_endf_file(&index->map);
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void close_endf_index(endf_index_t* index) {
+    free(index->sections);
+    index->sections = NULL;
+    index->len = 0;
+    unmap_endf_file(&index->map);
+}
+// --------------------------------------------------------------------------------
+
+static const endfSection* lookup_section(const endf_index_t* index, int mf, int mt) {
+    for (size_t i = 0; i < index->len; i++) {
+        if (index->sections[i].mf == mf && index->sections[i].mt == mt)
+            return &index->sections[i];
+    }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the HEAD record of a section.  The offset from the directory is
+ * verified against the MF and MT columns, and the file is scanned if the
+ * directory does not describe the layout correctly.
+ */
+static const char* section_head(const endf_index_t* index, const endfSection* section) {
+    const char* data = index->map.data;
+    const char* end = data + index->map.size;
+    if (section->offset < index->map.size) {
+        const char* head = data + section->offset;
+        const char* next = next_record(head, end);
+        if (record_complete(head, next) && record_matches(head, section->mf, section->mt)) {
+            if (index->record_length > 0) {
+                size_t page = (size_t)sysconf(_SC_PAGESIZE);
+                size_t start = section->offset - section->offset % page;
+                // From the page holding the HEAD record to the end of the section,
+                // clamped to the mapping after the lead into that page is added
+                size_t bytes = section->offset % page +
+                               (section->records + 1) * index->record_length;
+                if (bytes > index->map.size - start) bytes = index->map.size - start;
+                madvise((void*)(data + start), bytes, MADV_WILLNEED);
+            }
+            return head;
+        }
+    }
+    return find_section(data, end, section->mf, section->mt);
+}
+// ================================================================================ 
+// ================================================================================ 
+// STREAMING READER
+
+/*
+ * A fixed size line reader.  Lines are returned in place from the buffer,
+ * which is refilled by moving the unread tail to the front, so the memory
+ * used does not depend on the size of the file.
+ */
+typedef struct {
+    FILE* file;
+    size_t start;
+    size_t len;
+    bool eof;
+    char buffer[ENDF_STREAM_BUFFER];
+} line_reader;
+
+typedef enum {
+    STREAM_HEAD,
+    STREAM_CONT,
+    STREAM_RANGES,
+    STREAM_PAIRS,
+    STREAM_RECORDS
+} stream_state;
+
+typedef struct {
+    const endfHandler* handler;
+    stream_state state;
+    int mf;
+    int mt;
+    size_t nr;
+    size_t np;
+    size_t count;
+    size_t fill;
+    size_t nbt[ENDF_STREAM_BLOCK];
+    int law[ENDF_STREAM_BLOCK];
+    double xy[2 * ENDF_STREAM_BLOCK];
+} stream_parser;
+// --------------------------------------------------------------------------------
+
+/*
+ * Returns the next line without its newline, or NULL at the end of the file.
+ * Sets `*error` if a line does not fit in the buffer or the read fails.
+ */
+static const char* read_line(line_reader* reader, size_t* length, bool* error) {
+    for (;;) {
+        const char* start = reader->buffer + reader->start;
+        const char* eol = memchr(start, '\n', reader->len - reader->start);
+        if (eol) {
+            *length = (size_t)(eol - start);
+            reader->start += *length + 1;
+            return start;
+        }
+        if (reader->eof) {
+            *length = reader->len - reader->start;
+            reader->start = reader->len;
+            return *length > 0 ? start : NULL;
+        }
+        memmove(reader->buffer, start, reader->len - reader->start);
+        reader->len -= reader->start;
+        reader->start = 0;
+        if (reader->len == ENDF_STREAM_BUFFER) {
+            *error = true;
+            return NULL;
+        }
+        size_t bytes = fread(reader->buffer + reader->len, 1, ENDF_STREAM_BUFFER - reader->len,
+                             reader->file);
+        reader->len += bytes;
+        if (bytes == 0) {
+            if (ferror(reader->file)) {
+                *error = true;
+                return NULL;
+            }
+            reader->eof = true;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+static bool tab1_file(int mf) {
+    // MF3, MF23 and MF27 sections are a HEAD record followed by one TAB1 record
+    return mf == 3 || mf == 23 || mf == 27;
+}
+// --------------------------------------------------------------------------------
+
+static bool flush_ranges(stream_parser* parser) {
+    const endfHandler* handler = parser->handler;
+    bool ok = !handler->ranges ||
+              handler->ranges(handler->user, parser->mf, parser->mt,
+                              parser->nbt, parser->law, parser->fill);
+    parser->fill = 0;
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+static bool flush_pairs(stream_parser* parser) {
+    const endfHandler* handler = parser->handler;
+    bool ok = !handler->pairs ||
+              handler->pairs(handler->user, parser->mf, parser->mt, parser->xy, parser->fill);
+    parser->fill = 0;
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Advances the parser by one record.  Returns false with errno set to EINVAL
+ * for a malformed record, or ECANCELED if a callback stopped the stream.
+ */
+static bool stream_record(stream_parser* parser, const char* rec) {
+    const endfHandler* handler = parser->handler;
+    const int mf = parse_digits(rec + ENDF_MF_COLUMN, 2);
+    const int mt = parse_digits(rec + ENDF_MT_COLUMN, 3);
+    double values[ENDF_FIELDS_PER_RECORD];
+
+    // SEND, FEND, MEND, TEND and the tape identification all have MT = 0
+    if (mt == 0) {
+        if (parser->state == STREAM_HEAD) return true;
+        if (parser->state != STREAM_RECORDS || mf != parser->mf) {
+            errno = EINVAL;
+            return false;
+        }
+        parser->state = STREAM_HEAD;
+        if (handler->end && !handler->end(handler->user, parser->mf, parser->mt)) {
+            errno = ECANCELED;
+            return false;
+        }
+        return true;
+    }
+    if (parser->state != STREAM_HEAD && (mf != parser->mf || mt != parser->mt)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    bool ok = true;
+    switch (parser->state) {
+        case STREAM_HEAD:
+            if (!decode_record(rec, values)) break;
+            parser->mf = mf;
+            parser->mt = mt;
+            parser->state = tab1_file(mf) ? STREAM_CONT : STREAM_RECORDS;
+            ok = !handler->head ||
+                 handler->head(handler->user, parse_digits(rec + ENDF_MF_COLUMN - 4, 4),
+                               mf, mt, values);
+            errno = ok ? errno : ECANCELED;
+            return ok;
+        case STREAM_CONT:
+            if (!decode_record(rec, values) || values[4] < 1.0 || values[5] < 1.0) break;
+            parser->nr = (size_t)values[4];
+            parser->np = (size_t)values[5];
+            parser->count = 0;
+            parser->fill = 0;
+            parser->state = STREAM_RANGES;
+            ok = !handler->cont || handler->cont(handler->user, mf, mt, values);
+            errno = ok ? errno : ECANCELED;
+            return ok;
+        case STREAM_RANGES:
+            if (!decode_record(rec, values)) break;
+            for (int i = 0; i < 3 && parser->count < parser->nr && ok; i++, parser->count++) {
+                parser->nbt[parser->fill] = (size_t)values[2 * i];
+                parser->law[parser->fill] = (int)values[2 * i + 1];
+                if (++parser->fill == ENDF_STREAM_BLOCK) ok = flush_ranges(parser);
+            }
+            if (ok && parser->count == parser->nr) {
+                if (parser->fill > 0) ok = flush_ranges(parser);
+                parser->count = 0;
+                parser->state = STREAM_PAIRS;
+            }
+            errno = ok ? errno : ECANCELED;
+            return ok;
+        case STREAM_PAIRS:
+            if (!decode_record(rec, values)) break;
+            for (int i = 0; i < 3 && parser->count < parser->np && ok; i++, parser->count++) {
+                parser->xy[2 * parser->fill] = values[2 * i];
+                parser->xy[2 * parser->fill + 1] = values[2 * i + 1];
+                if (++parser->fill == ENDF_STREAM_BLOCK) ok = flush_pairs(parser);
+            }
+            if (ok && parser->count == parser->np) {
+                if (parser->fill > 0) ok = flush_pairs(parser);
+                parser->state = STREAM_RECORDS;
+            }
+            errno = ok ? errno : ECANCELED;
+            return ok;
+        case STREAM_RECORDS:
+            ok = !handler->record || handler->record(handler->user, mf, mt, rec);
+            errno = ok ? errno : ECANCELED;
+            return ok;
+    }
+    errno = EINVAL;
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    int mf;
+    int mt;
+    xsec_t* xsec;
+    size_t* nbt;
+    int* law;
+    size_t nr;
+    size_t num_ranges;
+    bool found;
+    bool complete;
+    int error;
+} xsec_collector;
+
+static bool collect_cont(void* user, int mf, int mt, const double* values) {
+    xsec_collector* collector = user;
+    if (mf != collector->mf || mt != collector->mt) return true;
+    collector->found = true;
+    collector->nr = (size_t)values[4];
+    collector->nbt = malloc(collector->nr * sizeof(size_t));
+    collector->law = malloc(collector->nr * sizeof(int));
+    collector->xsec = collector->nbt && collector->law ? init_xsec((size_t)values[5]) : NULL;
+    collector->error = collector->xsec ? 0 : ENOMEM;
+    return collector->xsec != NULL;
+}
+
+static bool collect_ranges(void* user, int mf, int mt, const size_t* nbt, const int* law,
+                           size_t len) {
+    xsec_collector* collector = user;
+    if (mf != collector->mf || mt != collector->mt) return true;
+    if (collector->num_ranges + len > collector->nr) {
+        collector->error = EINVAL;
+        return false;
+    }
+    memcpy(collector->nbt + collector->num_ranges, nbt, len * sizeof(size_t));
+    memcpy(collector->law + collector->num_ranges, law, len * sizeof(int));
+    collector->num_ranges += len;
+    return true;
+}
+
+static bool collect_pairs(void* user, int mf, int mt, const double* xy, size_t len) {
+    xsec_collector* collector = user;
+    if (mf != collector->mf || mt != collector->mt) return true;
+    for (size_t i = 0; i < len; i++) {
+        // Stop the stream rather than drop a point, keeping the error of push_xsec
+        if (!push_xsec(collector->xsec, (float)xy[2 * i + 1], (float)xy[2 * i])) {
+            collector->error = errno;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool collect_end(void* user, int mf, int mt) {
+    xsec_collector* collector = user;
+    if (mf != collector->mf || mt != collector->mt) return true;
+    collector->complete = true;
+    if (collector->num_ranges != collector->nr ||
+        !valid_ranges(collector->nbt, collector->law, collector->nr, xsec_size(collector->xsec)))
+        collector->error = EINVAL;
+    else if (!set_xsec_interpolation(collector->xsec, collector->nbt, collector->law,
+                                     collector->nr))
+        collector->error = errno;
+    // Stop the stream once the requested section is complete
+    return false;
+}
+// ================================================================================ 
+// ================================================================================ 
+// MF27 FORM FACTORS
+
+static bool form_factor_section(int mt) {
+    // Coherent form factor, incoherent scattering function and anomalous factors
+    return mt == 502 || mt == 504 || mt == 505 || mt == 506;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * MF27 sections are single TAB1 records, so they are parsed with the cross
+ * section readers and copied, along with their interpolation ranges, into an
+ * immutable table.  The xsec_t is freed in every case.
+ */
+static form_factor_t* to_form_factor(xsec_t* xsec, int mt) {
+    if (!xsec) return NULL;
+    form_factor_t* form_factor = init_form_factor(get_xsec_xsArray(xsec),
+                                                  get_xsec_enArray(xsec),
+                                                  xsec_size(xsec), mt);
+    const size_t* nbt;
+    const int* law;
+    const size_t nr = get_xsec_interpolation(xsec, &nbt, &law);
+    if (form_factor && nr > 0 && !set_form_factor_interpolation(form_factor, nbt, law, nr)) {
+        free_form_factor(form_factor);
+        form_factor = NULL;
+    }
+    int error = errno;
+    free_xsec(xsec);
+    errno = error;
+    return form_factor;
+}
 // ================================================================================ 
 // ================================================================================ 
 
 float read_amu(const char *filename, const float neutron_mass) {
     FILE *file = fopen(filename, "r");
     if (!file) {
-        errno = ENOENT;
-        fprintf(stderr, 
-                "Error: Unable to open file %s: %s\n", filename, 
-                strerror(errno)
-        );
+        CENDF_REPORT(ENOENT, "Error: Unable to open file %s: %s", filename, strerror(ENOENT));
         return -1.0f; // Return a negative value to indicate an error.
     }
 
@@ -35,40 +896,475 @@ float read_amu(const char *filename, const float neutron_mass) {
 
     // Skip the first line
     if (!fgets(line, sizeof(line), file)) {
-        errno = ENOEXEC;
-        fprintf(stderr, 
-                "Error: Unable to read the first line from %s with error %s", 
-                filename, 
-                strerror(errno)
-        );
+        CENDF_REPORT(ENOEXEC, "Error: Unable to read the first line from %s with error %s",
+                     filename, strerror(ENOEXEC));
         fclose(file);
         return -1.0f;
     }
 
     // Read the second line
     if (!fgets(line, sizeof(line), file)) {
-        errno = ENOEXEC;
-        fprintf(stderr, 
-                "Error: Unable to read the second line from %s with error %s", 
-                filename, strerror(errno)
-        );
+        CENDF_REPORT(ENOEXEC, "Error: Unable to read the second line from %s with error %s",
+                     filename, strerror(ENOEXEC));
         fclose(file);
         return -1.0f;
     }
 
     // Extract the second floating-point number (atomic mass) from the second line
-    float zaid, atomic_mass;
-    if (sscanf(line, "%f %f", &zaid, &atomic_mass) != 2) {
-        errno = EINVAL;
-        fprintf(stderr, 
-                "Error: Unable to parse atomic mass from the second line\n"
-        );
+    double values[ENDF_FIELDS_PER_RECORD];
+    if (strlen(line) < ENDF_RECORD_MIN || !parse_endf_record(line, values)) {
+        CENDF_REPORT(EINVAL, "Error: Unable to parse atomic mass from the second line");
         fclose(file);
         return -1.0f;
     }
 
     fclose(file);
-    return atomic_mass * neutron_mass;
+    return (float)values[1] * neutron_mass;
+}
+// --------------------------------------------------------------------------------
+
+bool parse_endf_record(const char* record, double* values) {
+    if (!record || !values) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to parse_endf_record");
+        return false;
+    }
+    if (!decode_record(record, values)) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t parse_endf_records(const char* data, size_t length, size_t num_records, double* values) {
+    if (!data || !values) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to parse_endf_records");
+        return 0;
+    }
+    const char* cursor = data;
+    size_t count = decode_records(&cursor, data + length, num_records, values, 0, 0);
+    if (count < num_records) errno = EINVAL;
+    return count;
+}
+// --------------------------------------------------------------------------------
+
+xsec_t* read_xsec(const char* file_name, int mf, int mt) {
+    if (!file_name) {
+        CENDF_REPORT(EINVAL, "Null file name passed to read_xsec");
+        return NULL;
+    }
+
+    // Seek through the MF1/MT451 directory when the file has one
+    endf_index_t index;
+    if (open_endf_index(file_name, &index)) {
+        xsec_t* xsec = read_indexed_xsec(&index, mf, mt);
+        int error = errno;
+        close_endf_index(&index);
+        if (!xsec) {
+            CENDF_REPORT(error, "Error: Unable to read MF%d/MT%d from %s", mf, mt, file_name);
+        }
+        return xsec;
+    }
+
+    // Otherwise stream the file until the section has been read
+    xsec_collector collector = { .mf = mf, .mt = mt };
+    const endfHandler handler = {
+        .user = &collector,
+        .cont = collect_cont,
+        .ranges = collect_ranges,
+        .pairs = collect_pairs,
+        .end = collect_end
+    };
+    FILE* file = fopen(file_name, "r");
+    if (!file) {
+        CENDF_REPORT(ENOENT, "Error: Unable to open file %s: %s", file_name, strerror(ENOENT));
+        return NULL;
+    }
+    const bool streamed = stream_endf(file, &handler);
+    const int stream_error = errno;
+    fclose(file);
+    free(collector.nbt);
+    free(collector.law);
+    if (collector.complete && collector.error == 0)
+        return collector.xsec;  // Stopped by collect_end after the section
+
+    if (collector.xsec) free_xsec(collector.xsec);
+    if (collector.error != 0) errno = collector.error;
+    else if (!streamed && stream_error != ECANCELED) errno = stream_error;  // Malformed file
+    else if (!collector.found) errno = ENODATA;  // A clean end of file without the section
+    else errno = EINVAL;  // The file ended inside the section
+    CENDF_REPORT(errno, "Error: Unable to read MF%d/MT%d from %s: %s",
+                mf, mt, file_name, strerror(errno));
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+bool stream_endf(FILE* file, const endfHandler* handler) {
+    if (!file || !handler) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to stream_endf");
+        return false;
+    }
+    line_reader* reader = malloc(sizeof(line_reader));
+    stream_parser* parser = malloc(sizeof(stream_parser));
+    if (!reader || !parser) {
+        free(reader);
+        free(parser);
+        CENDF_REPORT(ENOMEM, "Failed to allocate memory for stream_endf");
+        return false;
+    }
+    reader->file = file;
+    reader->start = 0;
+    reader->len = 0;
+    reader->eof = false;
+    parser->handler = handler;
+    parser->state = STREAM_HEAD;
+
+    bool ok = true;
+    bool error = false;
+    size_t length;
+    const char* rec;
+    while (ok && (rec = read_line(reader, &length, &error)) != NULL) {
+        if (length > 0 && rec[length - 1] == '\r') length--;
+        if (length < ENDF_RECORD_MIN) {
+            errno = EINVAL;
+            ok = false;
+            break;
+        }
+        ok = stream_record(parser, rec);
+    }
+    if (ok && error) {
+        errno = EIO;
+        ok = false;
+    }
+    // A file may end without a SEND record only between sections
+    if (ok && parser->state != STREAM_HEAD && parser->state != STREAM_RECORDS) {
+        errno = EINVAL;
+        ok = false;
+    }
+    free(reader);
+    free(parser);
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+bool stream_endf_file(const char* file_name, const endfHandler* handler) {
+    if (!file_name || !handler) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to stream_endf_file");
+        return false;
+    }
+    FILE* file = fopen(file_name, "r");
+    if (!file) {
+        CENDF_REPORT(ENOENT, "Error: Unable to open file %s: %s", file_name, strerror(ENOENT));
+        return false;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    bool ok = stream_endf(file, handler);
+    int error = errno;
+    fclose(file);
+    errno = error;
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+endf_index_t* read_endf_index(const char* file_name) {
+    if (!file_name) {
+        CENDF_REPORT(EINVAL, "Null file name passed to read_endf_index");
+        return NULL;
+    }
+    endf_index_t* index = malloc(sizeof(endf_index_t));
+    if (!index) {
+        CENDF_REPORT(ENOMEM, "endf_index_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    if (!open_endf_index(file_name, index)) {
+        CENDF_REPORT(errno, "Error: Unable to index file %s: %s", file_name, strerror(errno));
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+size_t endf_index_size(const endf_index_t* index) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to endf_index_size");
+        return 0;
+    }
+    return index->len;
+}
+// --------------------------------------------------------------------------------
+
+const endfSection* get_endf_sections(const endf_index_t* index) {
+    if (!index || !index->sections) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to get_endf_sections");
+        return NULL;
+    }
+    return index->sections;
+}
+// --------------------------------------------------------------------------------
+
+const endfSection* get_endf_section(const endf_index_t* index, int mf, int mt) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to get_endf_section");
+        return NULL;
+    }
+    const endfSection* section = lookup_section(index, mf, mt);
+    if (!section) errno = ENODATA;
+    return section;
+}
+// --------------------------------------------------------------------------------
+
+float endf_index_za(const endf_index_t* index) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to endf_index_za");
+        return -1.0f;
+    }
+    return index->za;
+}
+// --------------------------------------------------------------------------------
+
+float endf_index_awr(const endf_index_t* index) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to endf_index_awr");
+        return -1.0f;
+    }
+    return index->awr;
+}
+// --------------------------------------------------------------------------------
+
+int endf_index_mat(const endf_index_t* index) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to endf_index_mat");
+        return -1;
+    }
+    return index->mat;
+}
+// --------------------------------------------------------------------------------
+
+xsec_t* read_indexed_xsec(const endf_index_t* index, int mf, int mt) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to read_indexed_xsec");
+        return NULL;
+    }
+    const endfSection* section = lookup_section(index, mf, mt);
+    const char* head = section ? section_head(index, section) : NULL;
+    if (!head) {
+        errno = ENODATA;
+        return NULL;
+    }
+    return parse_tab1_xsec(head, index->map.data + index->map.size, mf, mt);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Defines read_indexed_<name> for a table of xsec_precision.h.  The fields
+ * are decoded to double, so each table is filled at its own precision
+ * rather than through a float xsec_t.
+ */
+#define TAB1_PRECISION_READER(name, energy_t, value_t)                                 \
+    name##_t* read_indexed_##name(const endf_index_t* index, int mf, int mt) {         \
+        if (!index) {                                                                  \
+            CENDF_REPORT(EINVAL, "Null pointer passed to read_indexed_" #name);        \
+            return NULL;                                                               \
+        }                                                                              \
+        const endfSection* section = lookup_section(index, mf, mt);                    \
+        const char* head = section ? section_head(index, section) : NULL;              \
+        if (!head) {                                                                   \
+            errno = ENODATA;                                                           \
+            return NULL;                                                               \
+        }                                                                              \
+        const char* end = index->map.data + index->map.size;                           \
+        const char* rec;                                                               \
+        size_t nr, np;                                                                 \
+        size_t* nbt;                                                                   \
+        int* law;                                                                      \
+        if (!parse_tab1_ranges(head, end, mf, mt, &rec, &nr, &np, &nbt, &law))         \
+            return NULL;                                                               \
+        name##_t* table = init_##name(np);                                             \
+        if (!table) {                                                                  \
+            free(nbt);                                                                 \
+            free(law);                                                                 \
+            return NULL;                                                               \
+        }                                                                              \
+        double values[TAB1_BLOCK_RECORDS * ENDF_FIELDS_PER_RECORD];                    \
+        size_t remaining = (np + 2) / 3;                                               \
+        size_t count = 0;                                                              \
+        bool pushed = true;                                                            \
+        while (remaining > 0 && pushed) {                                              \
+            size_t block = remaining < TAB1_BLOCK_RECORDS ? remaining : TAB1_BLOCK_RECORDS; \
+            if (decode_records(&rec, end, block, values, mf, mt) != block) break;      \
+            for (size_t i = 0; i < 3 * block && count < np && pushed; i++, count++)    \
+                pushed = push_##name(table, (value_t)values[2 * i + 1],                \
+                                     (energy_t)values[2 * i]);                         \
+            remaining -= block;                                                        \
+        }                                                                              \
+        int error = remaining > 0 || !pushed || !valid_ranges(nbt, law, nr, np) ? EINVAL : 0; \
+        if (error == 0 && !set_##name##_interpolation(table, nbt, law, nr)) error = errno; \
+        free(nbt);                                                                     \
+        free(law);                                                                     \
+        if (error != 0) {                                                              \
+            free_##name(table);                                                        \
+            errno = error;                                                             \
+            return NULL;                                                               \
+        }                                                                              \
+        return table;                                                                  \
+    }
+
+TAB1_PRECISION_READER(xsec_f32, float, float)
+TAB1_PRECISION_READER(xsec_f64, double, double)
+TAB1_PRECISION_READER(xsec_mixed, double, float)
+#undef TAB1_PRECISION_READER
+// --------------------------------------------------------------------------------
+
+form_factor_t* read_form_factor(const char* file_name, int mt) {
+    if (!form_factor_section(mt)) {
+        CENDF_REPORT(EINVAL, "MT%d is not an MF27 form factor", mt);
+        return NULL;
+    }
+    return to_form_factor(read_xsec(file_name, 27, mt), mt);
+}
+// --------------------------------------------------------------------------------
+
+form_factor_t* read_indexed_form_factor(const endf_index_t* index, int mt) {
+    if (!form_factor_section(mt)) {
+        CENDF_REPORT(EINVAL, "MT%d is not an MF27 form factor", mt);
+        return NULL;
+    }
+    return to_form_factor(read_indexed_xsec(index, 27, mt), mt);
+}
+// --------------------------------------------------------------------------------
+
+bool read_tab1_range(const endf_index_t* index, int mf, int mt,
+                     size_t* np, float* emin, float* emax) {
+    if (!index || !np || !emin || !emax) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to read_tab1_range");
+        return false;
+    }
+    const endfSection* section = lookup_section(index, mf, mt);
+    const char* head = section ? section_head(index, section) : NULL;
+    if (!head) {
+        errno = ENODATA;
+        return false;
+    }
+
+    const char* end = index->map.data + index->map.size;
+    const char* rec = next_record(head, end);
+    double values[ENDF_FIELDS_PER_RECORD];
+    if (decode_records(&rec, end, 1, values, mf, mt) != 1 || values[4] < 1.0 || values[5] < 1.0) {
+        errno = EINVAL;
+        return false;
+    }
+    const size_t nr = (size_t)values[4];
+    const size_t points = (size_t)values[5];
+    for (size_t i = 0; i < (nr + 2) / 3 && rec < end; i++)
+        rec = next_record(rec, end);
+
+    // The first energy opens the first data record, the last energy is
+    // located from NP without decoding the records in between
+    const char* first = rec;
+    const size_t last_record = (points - 1) / 3;
+    const char* last = first;
+    if (index->record_length > 0 && (size_t)(end - first) > last_record * index->record_length) {
+        last = first + last_record * index->record_length;
+    } else {
+        for (size_t i = 0; i < last_record && last < end; i++)
+            last = next_record(last, end);
+    }
+
+    double first_values[ENDF_FIELDS_PER_RECORD];
+    if (decode_records(&first, end, 1, first_values, mf, mt) != 1 ||
+        decode_records(&last, end, 1, values, mf, mt) != 1) {
+        errno = EINVAL;
+        return false;
+    }
+    *np = points;
+    *emin = (float)first_values[0];
+    *emax = (float)values[2 * ((points - 1) % 3)];
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+int read_endf_material(const char* file_name, endfMaterial* material) {
+    if (!file_name || !material) return EINVAL;
+    *material = (endfMaterial){0};
+    const int saved_errno = errno;
+
+    endf_index_t index;
+    if (!open_endf_index(file_name, &index)) {
+        int error = errno;
+        errno = saved_errno;
+        return error;
+    }
+    // Every section is read, so read ahead through the whole file
+    madvise((void*)index.map.data, index.map.size, MADV_SEQUENTIAL);
+
+    endfTable* tables = malloc((index.len > 0 ? index.len : 1) * sizeof(endfTable));
+    if (!tables) {
+        close_endf_index(&index);
+        errno = saved_errno;
+        return ENOMEM;
+    }
+    const char* end = index.map.data + index.map.size;
+    size_t len = 0;
+    int error = 0;
+    for (size_t i = 0; i < index.len && error == 0; i++) {
+        const endfSection* section = &index.sections[i];
+        // Sections of files that are not TAB1 tables are skipped
+        if (!tab1_file(section->mf)) continue;
+        const char* head = section_head(&index, section);
+        if (!head) {
+            error = EINVAL;
+            break;
+        }
+        // A TAB1 table that can not be read fails the file rather than going missing
+        errno = 0;
+        xsec_t* xsec = parse_tab1_xsec(head, end, section->mf, section->mt);
+        if (!xsec) {
+            error = errno != 0 ? errno : EINVAL;
+            break;
+        }
+        tables[len++] = (endfTable){ .mf = section->mf, .mt = section->mt, .xsec = xsec };
+    }
+
+    material->za = index.za;
+    material->awr = index.awr;
+    material->mat = index.mat;
+    material->tables = tables;
+    material->len = len;
+    close_endf_index(&index);
+    if (error != 0) free_endf_material(material);
+    errno = saved_errno;
+    return error;
+}
+// --------------------------------------------------------------------------------
+
+void free_endf_material(endfMaterial* material) {
+    if (!material) return;
+    for (size_t i = 0; i < material->len; i++)
+        free_xsec(material->tables[i].xsec);
+    free(material->tables);
+    material->tables = NULL;
+    material->len = 0;
+}
+// --------------------------------------------------------------------------------
+
+void free_endf_index(endf_index_t* index) {
+    if (!index) {
+        CENDF_REPORT(EINVAL, "endf_index_t NULL, possible double free");
+        return;
+    }
+    close_endf_index(index);
+    free(index);
+}
+// --------------------------------------------------------------------------------
+
+void _free_endf_index(endf_index_t** index) {
+    if (index && *index) {
+        free_endf_index(*index);
+        *index = NULL;
+    }
 }
 // ================================================================================
 // ================================================================================
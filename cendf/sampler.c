@@ -0,0 +1,239 @@
+// ================================================================================
+// ================================================================================
+// - File:    sampler.c
+// - Purpose: Reaction selection tables for Monte Carlo collisions
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/sampler.h"
+
+#include <string.h>
+#include <errno.h>
+
+// The number of searches that advance in step in a batch
+#define SAMPLER_GROUP 8
+// ================================================================================
+// ================================================================================
+
+struct reaction_sampler_t {
+    float* energy;
+    float* cumulative;  // len rows of num_reactions running sums
+    size_t len;
+    size_t num_reactions;
+};
+// --------------------------------------------------------------------------------
+
+reaction_sampler_t* init_reaction_sampler(const union_grid_t* grid) {
+    if (!grid) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to init_reaction_sampler");
+        return NULL;
+    }
+    const size_t len = union_grid_size(grid);
+    const size_t num_reactions = union_grid_reactions(grid);
+    reaction_sampler_t* sampler = calloc(1, sizeof(reaction_sampler_t));
+    if (sampler) {
+        sampler->energy = malloc(len * sizeof(float));
+        sampler->cumulative = malloc(len * num_reactions * sizeof(float));
+    }
+    if (!sampler || !sampler->energy || !sampler->cumulative) {
+        free_reaction_sampler(sampler);
+        CENDF_REPORT(ENOMEM, "reaction_sampler_t allocation failed with error %s",
+                     strerror(ENOMEM));
+        return NULL;
+    }
+    memcpy(sampler->energy, get_union_energy(grid), len * sizeof(float));
+    for (size_t i = 0; i < len; i++) {
+        const float* values = get_union_values(grid, i);
+        float* sums = sampler->cumulative + i * num_reactions;
+        double sum = 0.0;
+        for (size_t r = 0; r < num_reactions; r++) {
+            if (values[r] > 0.0f) sum += values[r];
+            sums[r] = (float)sum;
+        }
+    }
+    sampler->len = len;
+    sampler->num_reactions = num_reactions;
+    return sampler;
+}
+// --------------------------------------------------------------------------------
+
+reaction_sampler_t* build_material_sampler(material_t* material, int mf, const int* mt,
+                                           size_t num_mt) {
+    union_grid_t* grid = build_material_grid(material, mf, mt, num_mt);
+    if (!grid) return NULL;
+    reaction_sampler_t* sampler = init_reaction_sampler(grid);
+    free_union_grid(grid);
+    return sampler;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Selects the reaction in the interval that starts at grid point `low`, which
+ * is at most len - 2.  The running sums of the interval are interpolated one
+ * at a time, and only until the first that exceeds the target.
+ */
+static inline int select_reaction(const reaction_sampler_t* sampler, size_t low, float energy,
+                                  float random, cendfStatus* status) {
+    const size_t num_reactions = sampler->num_reactions;
+    const float* x = sampler->energy;
+    const float* lower = sampler->cumulative + low * num_reactions;
+    const float* upper = lower + num_reactions;
+    // An energy repeated at an edge takes the sums above the edge
+    const float width = x[low + 1] - x[low];
+    const float weight = width > 0.0f ? (energy - x[low]) / width : 1.0f;
+
+    const size_t last = num_reactions - 1;
+    const float total = lower[last] + (upper[last] - lower[last]) * weight;
+    if (!(total > 0.0f)) {
+        cendf_set_status(status, CENDF_STATUS_NO_DATA);
+        return -1;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    const float target = random * total;
+    float previous = 0.0f;
+    int chosen = -1;
+    for (size_t r = 0; r < num_reactions; r++) {
+        const float sum = lower[r] + (upper[r] - lower[r]) * weight;
+        if (sum > previous) {
+            // A reaction with a zero cross section is never selected
+            chosen = (int)r;
+            if (target < sum) break;
+        }
+        previous = sum;
+    }
+    return chosen;
+}
+// --------------------------------------------------------------------------------
+
+int sample_reaction_status(const reaction_sampler_t* sampler, float energy, float random,
+                           cendfStatus* status) {
+    if (!sampler) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return -1;
+    }
+    const float* x = sampler->energy;
+    const size_t len = sampler->len;
+    if (len < 2 || !(energy >= x[0] && energy <= x[len - 1])) {
+        cendf_set_status(status, CENDF_STATUS_RANGE);
+        return -1;
+    }
+
+    // Find the last interval whose lower energy is not above `energy`
+    size_t low = 0;
+    size_t high = len - 1;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (x[mid] <= energy) low = mid;
+        else high = mid;
+    }
+    return select_reaction(sampler, low, energy, random, status);
+}
+// --------------------------------------------------------------------------------
+
+int sample_reaction(const reaction_sampler_t* sampler, float energy, float random) {
+    cendfStatus status;
+    const int reaction = sample_reaction_status(sampler, energy, random, &status);
+    if (status == CENDF_STATUS_INVALID)
+        CENDF_REPORT(EINVAL, "Null pointer passed to sample_reaction");
+    else if (status != CENDF_STATUS_OK)
+        errno = status;
+    return reaction;
+}
+// --------------------------------------------------------------------------------
+
+bool sample_reaction_batch(const reaction_sampler_t* sampler, const float* energies,
+                           const float* random, int* reaction, size_t n) {
+    if (!sampler || !energies || !random || !reaction) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to sample_reaction_batch");
+        return false;
+    }
+    const float* x = sampler->energy;
+    const size_t len = sampler->len;
+    cendfStatus failure = CENDF_STATUS_OK;
+    for (size_t i = 0; i < n; i += SAMPLER_GROUP) {
+        const size_t count = n - i < SAMPLER_GROUP ? n - i : SAMPLER_GROUP;
+        size_t base[SAMPLER_GROUP];
+        bool inside[SAMPLER_GROUP];
+        for (size_t lane = 0; lane < count; lane++) {
+            const float e = energies[i + lane];
+            inside[lane] = len >= 2 && e >= x[0] && e <= x[len - 1];
+            base[lane] = 0;
+        }
+        // Branchless searches for the last point at or below each energy,
+        // which share their step count and so advance together
+        for (size_t span = len; span > 1; span -= span / 2) {
+            const size_t half = span / 2;
+            for (size_t lane = 0; lane < count; lane++)
+                base[lane] += (x[base[lane] + half] <= energies[i + lane]) ? half : 0;
+        }
+        for (size_t lane = 0; lane < count; lane++) {
+            cendfStatus status = CENDF_STATUS_RANGE;
+            int chosen = -1;
+            if (inside[lane]) {
+                const size_t low = base[lane] < len - 2 ? base[lane] : len - 2;
+                chosen = select_reaction(sampler, low, energies[i + lane], random[i + lane],
+                                         &status);
+            }
+            reaction[i + lane] = chosen;
+            if (status != CENDF_STATUS_OK) failure = status;
+        }
+    }
+    if (failure != CENDF_STATUS_OK) {
+        errno = failure;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t reaction_sampler_size(const reaction_sampler_t* sampler) {
+    if (!sampler) {
+        errno = EINVAL;
+        return 0;
+    }
+    return sampler->len;
+}
+// --------------------------------------------------------------------------------
+
+size_t reaction_sampler_reactions(const reaction_sampler_t* sampler) {
+    if (!sampler) {
+        errno = EINVAL;
+        return 0;
+    }
+    return sampler->num_reactions;
+}
+// --------------------------------------------------------------------------------
+
+const float* get_sampler_cumulative(const reaction_sampler_t* sampler, size_t index) {
+    if (!sampler || index >= sampler->len) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return sampler->cumulative + index * sampler->num_reactions;
+}
+// --------------------------------------------------------------------------------
+
+void free_reaction_sampler(reaction_sampler_t* sampler) {
+    if (!sampler) return;
+    free(sampler->energy);
+    free(sampler->cumulative);
+    free(sampler);
+}
+// --------------------------------------------------------------------------------
+
+void _free_reaction_sampler(reaction_sampler_t** sampler) {
+    if (sampler && *sampler) {
+        free_reaction_sampler(*sampler);
+        *sampler = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
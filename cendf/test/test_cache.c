@@ -0,0 +1,345 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_cache.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_cache.h"
+#include "../include/read_file.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+// ================================================================================
+// ================================================================================
+
+/*
+ * Overwrites one byte of a file in place.
+ */
+static bool corrupt_byte(const char* file_name, long offset) {
+    FILE* file = fopen(file_name, "r+b");
+    if (!file) return false;
+    bool ok = fseek(file, offset, SEEK_SET) == 0;
+    int byte = ok ? fgetc(file) : EOF;
+    ok = ok && byte != EOF && fseek(file, offset, SEEK_SET) == 0;
+    ok = ok && fputc(byte ^ 0xFF, file) != EOF;
+    return (fclose(file) == 0) && ok;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Writes a 4096 byte cache with a valid header checksum and one table whose
+ * NP and NR are both 1008, so its arrays fill the 4032 bytes before the table
+ * of contents and its 12096 bytes of interpolation ranges run past the file.
+ */
+static bool write_oversized_ranges(const char* file_name) {
+    unsigned char data[4096] = {0};
+    const uint64_t num_tables = 1, toc_offset = 4032, file_size = 4096, np = 1008;
+    const uint32_t version = 2, byte_order = 0x01020304u, nr = 1008;
+    memcpy(data, "CENDFBIN", 8);
+    memcpy(data + 8, &version, sizeof(version));
+    memcpy(data + 12, &byte_order, sizeof(byte_order));
+    memcpy(data + 16, &num_tables, sizeof(num_tables));
+    memcpy(data + 24, &toc_offset, sizeof(toc_offset));
+    memcpy(data + 32, &file_size, sizeof(file_size));
+    memcpy(data + toc_offset + 20, &nr, sizeof(nr));
+    memcpy(data + toc_offset + 24, &np, sizeof(np));
+
+    // FNV-1a over the header, with its checksum field zero, and the table of contents
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < file_size; i++) {
+        if (i == 64) i = toc_offset;
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    memcpy(data + 40, &hash, sizeof(hash));
+
+    FILE* file = fopen(file_name, "wb");
+    if (!file) return false;
+    bool ok = fwrite(data, 1, sizeof(data), file) == sizeof(data);
+    return (fclose(file) == 0) && ok;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Overwrites `bytes` bytes of a file in place.
+ */
+static bool overwrite_bytes(const char* file_name, long offset, const void* data, size_t bytes) {
+    FILE* file = fopen(file_name, "r+b");
+    if (!file) return false;
+    bool ok = fseek(file, offset, SEEK_SET) == 0 && fwrite(data, 1, bytes, file) == bytes;
+    return (fclose(file) == 0) && ok;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Finds the offset of the interpolation ranges of table MF/MT in a cache file,
+ * or -1 if the table has none.
+ */
+static long ranges_offset(const char* file_name, int mf, int mt) {
+    FILE* file = fopen(file_name, "rb");
+    if (!file) return -1;
+    uint64_t num_tables = 0, toc_offset = 0;
+    long offset = -1;
+    bool ok = fseek(file, 16, SEEK_SET) == 0 &&
+              fread(&num_tables, sizeof(num_tables), 1, file) == 1 &&
+              fread(&toc_offset, sizeof(toc_offset), 1, file) == 1 &&
+              fseek(file, (long)toc_offset, SEEK_SET) == 0;
+    for (uint64_t i = 0; ok && i < num_tables; i++) {
+        unsigned char entry[64];
+        ok = fread(entry, sizeof(entry), 1, file) == 1;
+        int32_t entry_mf, entry_mt;
+        uint32_t nr;
+        uint64_t interp_offset;
+        memcpy(&entry_mf, entry + 12, sizeof(entry_mf));
+        memcpy(&entry_mt, entry + 16, sizeof(entry_mt));
+        memcpy(&nr, entry + 20, sizeof(nr));
+        memcpy(&interp_offset, entry + 56, sizeof(interp_offset));
+        if (ok && entry_mf == mf && entry_mt == mt && nr > 0) {
+            offset = (long)interp_offset;
+            break;
+        }
+    }
+    fclose(file);
+    return offset;
+}
+// ================================================================================
+// ================================================================================
+
+void test_xsec_cache_nominal(void **state) {
+    (void) state;
+    const char* cache_file = "test_cache_nominal.bin";
+    const char* files[] = {"../../../../data/test/photoat-047_Ag_000.endf"};
+    assert_true(write_xsec_cache(cache_file, files, 1));
+    xsec_cache_t* cache XSEC_CACHE_GBC = open_xsec_cache(cache_file);
+    remove(cache_file);
+    assert_non_null(cache);
+    assert_true(verify_xsec_cache(cache));
+
+    // Every section except the MF1 directory is a TAB1 table
+    assert_int_equal(xsec_cache_size(cache), 26);
+    const cacheTable* tables = get_cache_tables(cache);
+    assert_float_equal(tables[0].za, 47000.0f, 1.0e-3);
+    assert_float_equal(tables[0].awr, 106.941f, 1.0e-3);
+    assert_int_equal(tables[0].mat, 4700);
+    assert_int_equal(tables[0].mf, 23);
+    assert_int_equal(tables[0].mt, 501);
+
+    // Views point at 64 byte aligned arrays identical to a parse of the text
+    const xsec_t* view = get_cached_xsec(cache, 47, 23, 534);
+    assert_non_null(view);
+    xsec_t* xsec XSEC_GBC = read_xsec(files[0], 23, 534);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(view), 450);
+    assert_int_equal((uintptr_t)get_xsec_enArray(view) % 64, 0);
+    assert_int_equal((uintptr_t)get_xsec_xsArray(view) % 64, 0);
+    assert_memory_equal(get_xsec_enArray(view), get_xsec_enArray(xsec), 450 * sizeof(float));
+    assert_memory_equal(get_xsec_xsArray(view), get_xsec_xsArray(xsec), 450 * sizeof(float));
+    assert_float_equal(interp_xsec(view, 1.0e5f), interp_xsec(xsec, 1.0e5f), 1.0e-6);
+
+    errno = 0;
+    assert_null(get_cached_xsec(cache, 47, 23, 999));
+    assert_int_equal(errno, ENODATA);
+    errno = 0;
+    assert_null(get_cached_xsec(cache, 82, 23, 501));
+    assert_int_equal(errno, ENODATA);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_cache_interpolation(void **state) {
+    (void) state;
+    // A copy of the silver file whose K-shell table is log-log
+    const char* cache_file = "test_cache_interpolation.bin";
+    const char* endf_file = "test_cache_log_log.endf";
+    FILE* in = fopen("../../../../data/test/photoat-047_Ag_000.endf", "r");
+    FILE* out = fopen(endf_file, "w");
+    assert_non_null(in);
+    assert_non_null(out);
+    char line[128];
+    for (size_t i = 0; fgets(line, sizeof(line), in); i++) {
+        if (i == 6630) line[21] = '5';
+        fputs(line, out);
+    }
+    fclose(in);
+    fclose(out);
+
+    const char* files[] = {endf_file};
+    assert_true(write_xsec_cache(cache_file, files, 1));
+    xsec_cache_t* cache XSEC_CACHE_GBC = open_xsec_cache(cache_file);
+    xsec_t* xsec XSEC_GBC = read_xsec(endf_file, 23, 534);
+    remove(cache_file);
+    remove(endf_file);
+    assert_non_null(cache);
+    assert_non_null(xsec);
+    assert_true(verify_xsec_cache(cache));
+
+    const xsec_t* view = get_cached_xsec(cache, 47, 23, 534);
+    assert_non_null(view);
+    const size_t* nbt;
+    const int* law;
+    assert_int_equal(get_xsec_interpolation(view, &nbt, &law), 1);
+    assert_int_equal(nbt[0], 450);
+    assert_int_equal(law[0], 5);
+    assert_int_equal(get_xsec_interpolation(get_cached_xsec(cache, 47, 23, 501), NULL, NULL), 0);
+    const float energy = sqrtf(25520.0f * 26100.0f);
+    assert_float_equal(interp_xsec(view, energy), interp_xsec(xsec, energy), 1.0e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_cache_corrupt(void **state) {
+    (void) state;
+    const char* cache_file = "test_cache_corrupt.bin";
+    const char* files[] = {"../../../../data/test/photoat-047_Ag_000.endf"};
+    assert_true(write_xsec_cache(cache_file, files, 1));
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        remove(cache_file);
+        return;
+    }
+    // A damaged array is found by the verifier, not by the loader
+    bool corrupted_data = corrupt_byte(cache_file, 64);
+    xsec_cache_t* cache = open_xsec_cache(cache_file);
+    errno = 0;
+    bool verified = cache ? verify_xsec_cache(cache) : true;
+    int bad_data = errno;
+    free_xsec_cache(cache);
+
+    // A damaged table of contents is found by the loader
+    FILE* file = fopen(cache_file, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = file ? ftell(file) : 0;
+    if (file) fclose(file);
+    bool corrupted_toc = corrupt_byte(cache_file, size - 60);
+    errno = 0;
+    xsec_cache_t* damaged = open_xsec_cache(cache_file);
+    int bad_toc = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    remove(cache_file);
+
+    assert_true(corrupted_data);
+    assert_non_null(cache);
+    assert_false(verified);
+    assert_int_equal(bad_data, EINVAL);
+    assert_true(corrupted_toc);
+    assert_null(damaged);
+    assert_int_equal(bad_toc, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_cache_ranges(void **state) {
+    (void) state;
+    // A copy of the silver file whose K-shell table is log-log, so it stores one range
+    const char* cache_file = "test_cache_ranges.bin";
+    const char* endf_file = "test_cache_ranges.endf";
+    FILE* in = fopen("../../../../data/test/photoat-047_Ag_000.endf", "r");
+    FILE* out = fopen(endf_file, "w");
+    assert_non_null(in);
+    assert_non_null(out);
+    char line[128];
+    for (size_t i = 0; fgets(line, sizeof(line), in); i++) {
+        if (i == 6630) line[21] = '5';
+        fputs(line, out);
+    }
+    fclose(in);
+    fclose(out);
+    const char* files[] = {endf_file};
+    bool written = write_xsec_cache(cache_file, files, 1);
+    remove(endf_file);
+    assert_true(written);
+    const long offset = ranges_offset(cache_file, 23, 534);
+    assert_true(offset > 0);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        remove(cache_file);
+        return;
+    }
+    // The ranges are not covered by the header checksum, so the loader checks their values
+    const uint64_t past_end = 451;
+    bool bad_nbt = overwrite_bytes(cache_file, offset, &past_end, sizeof(past_end));
+    errno = 0;
+    xsec_cache_t* nbt_cache = open_xsec_cache(cache_file);
+    int nbt_error = errno;
+    free_xsec_cache(nbt_cache);
+
+    const uint64_t nbt = 450;
+    const int32_t law = 7;
+    bool bad_law = overwrite_bytes(cache_file, offset, &nbt, sizeof(nbt)) &&
+                   overwrite_bytes(cache_file, offset + 8, &law, sizeof(law));
+    errno = 0;
+    xsec_cache_t* law_cache = open_xsec_cache(cache_file);
+    int law_error = errno;
+    free_xsec_cache(law_cache);
+
+    // Ranges larger than the data region are rejected before they are read
+    bool oversized = write_oversized_ranges(cache_file);
+    errno = 0;
+    xsec_cache_t* oversized_cache = open_xsec_cache(cache_file);
+    int oversized_error = errno;
+    free_xsec_cache(oversized_cache);
+    fclose(stderr);
+    stderr = original_stderr;
+    remove(cache_file);
+
+    assert_true(bad_nbt);
+    assert_null(nbt_cache);
+    assert_int_equal(nbt_error, EINVAL);
+    assert_true(bad_law);
+    assert_null(law_cache);
+    assert_int_equal(law_error, EINVAL);
+    assert_true(oversized);
+    assert_null(oversized_cache);
+    assert_int_equal(oversized_error, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_cache_failure(void **state) {
+    (void) state;
+    const char* cache_file = "test_cache_failure.bin";
+    const char* bad_files[] = {"../../../../data/test/fail_read_mass.endf"};
+    const char* missing_files[] = {"../../../../data/test/no_file.endf"};
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    bool bad_written = write_xsec_cache(cache_file, bad_files, 1);
+    int bad_file = errno;
+    errno = 0;
+    bool missing_written = write_xsec_cache(cache_file, missing_files, 1);
+    int no_file = errno;
+    errno = 0;
+    xsec_cache_t* missing = open_xsec_cache("no_file.bin");
+    int no_cache = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+
+    assert_false(bad_written);
+    assert_int_equal(bad_file, EINVAL);
+    assert_false(missing_written);
+    assert_int_equal(no_file, ENOENT);
+    assert_null(missing);
+    assert_int_equal(no_cache, ENOENT);
+    // A failed write leaves no cache file behind
+    assert_null(fopen(cache_file, "rb"));
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,62 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_cache.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_cache_H
+#define test_cache_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/cache.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test writing a binary cache and reading tables back through views
+ */
+void test_xsec_cache_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that cached tables keep their interpolation ranges
+ */
+void test_xsec_cache_interpolation(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that damaged cache files are rejected by the loader or the verifier
+ */
+void test_xsec_cache_corrupt(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that interpolation ranges out of bounds or with bad values are rejected by the loader
+ */
+void test_xsec_cache_ranges(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test cache failures for bad input files and a missing cache file
+ */
+void test_xsec_cache_failure(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_cache_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,215 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_diagnostics.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_diagnostics.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <float.h>
+#include <string.h>
+#include <pthread.h>
+// ================================================================================
+// ================================================================================
+
+typedef struct {
+    size_t calls;
+    size_t suppressed;
+    int code;
+    char message[CENDF_MESSAGE_SIZE];
+} log_capture;
+// --------------------------------------------------------------------------------
+
+static void capture_log(const cendfError* error, size_t suppressed, void* user) {
+    log_capture* capture = user;
+    capture->calls++;
+    capture->suppressed += suppressed;
+    capture->code = error->code;
+    strcpy(capture->message, error->message);
+}
+// --------------------------------------------------------------------------------
+
+// Puts back the logging of a test binary that has not changed it
+static void restore_log(void) {
+    cendf_set_log_handler(cendf_stderr_log, NULL);
+    cendf_set_log_rate(CENDF_LOG_RATE);
+}
+// --------------------------------------------------------------------------------
+
+static void* report_in_thread(void* arg) {
+    (void) arg;
+    cendf_clear_error();
+    get_vector(NULL, 0);
+    return (void*)(intptr_t)cendf_last_error()->code;
+}
+// ================================================================================
+// ================================================================================
+
+void test_diagnostics_last_error(void **state) {
+    (void) state;
+    cendf_set_log_handler(NULL, NULL);
+    cendf_clear_error();
+    assert_int_equal(cendf_last_error()->code, 0);
+    assert_null(cendf_last_error()->function);
+
+    errno = 0;
+    vector_t* vec VECTOR_GBC = init_vector(2);
+    push_back_vector(vec, 1.f);
+    assert_true(get_vector(vec, 5) == FLT_MAX);
+    assert_int_equal(errno, EINVAL);
+    const cendfError* error = cendf_last_error();
+    assert_int_equal(error->code, EINVAL);
+    assert_string_equal(error->function, "get_vector");
+    assert_non_null(strstr(error->message, "out of bounds"));
+
+    // A success leaves the last error in place
+    assert_float_equal(get_vector(vec, 0), 1.f, 1e-6);
+    assert_int_equal(cendf_last_error()->code, EINVAL);
+    cendf_clear_error();
+    assert_int_equal(cendf_last_error()->code, 0);
+    assert_string_equal(cendf_last_error()->message, "");
+    assert_string_equal(cendf_status_string(CENDF_STATUS_RANGE), "Value out of range");
+    restore_log();
+}
+// --------------------------------------------------------------------------------
+
+void test_diagnostics_threads(void **state) {
+    (void) state;
+    cendf_set_log_handler(NULL, NULL);
+    cendf_clear_error();
+    pthread_t thread;
+    void* code;
+    assert_int_equal(pthread_create(&thread, NULL, report_in_thread, NULL), 0);
+    assert_int_equal(pthread_join(thread, &code), 0);
+    assert_int_equal((int)(intptr_t)code, EINVAL);
+    assert_int_equal(cendf_last_error()->code, 0);
+    restore_log();
+}
+// --------------------------------------------------------------------------------
+
+void test_diagnostics_handler(void **state) {
+    (void) state;
+    log_capture capture = {0};
+    cendf_set_log_handler(capture_log, &capture);
+    cendf_set_log_rate(0);
+    xsec_t* xsec XSEC_GBC = init_xsec(2);
+    push_xsec(xsec, 1.f, 1.f);
+    push_xsec(xsec, 2.f, 2.f);
+    for (int i = 0; i < 3; i++)
+        assert_float_equal(interp_xsec(xsec, 5.f), -1.f, 1e-6);
+    assert_int_equal(capture.calls, 3);
+    assert_int_equal(capture.code, ERANGE);
+    assert_non_null(strstr(capture.message, "out of bounds"));
+    assert_int_equal(errno, ERANGE);
+
+    // Without a handler errors are still recorded
+    cendf_set_log_handler(NULL, NULL);
+    cendf_clear_error();
+    interp_xsec(NULL, 1.f);
+    assert_int_equal(capture.calls, 3);
+    assert_int_equal(cendf_last_error()->code, EINVAL);
+    restore_log();
+}
+// --------------------------------------------------------------------------------
+
+void test_diagnostics_rate_limit(void **state) {
+    (void) state;
+    log_capture capture = {0};
+    cendf_set_log_handler(capture_log, &capture);
+    // Takes the count of errors dropped by earlier tests
+    cendf_set_log_rate(0);
+    get_vector(NULL, 0);
+    capture = (log_capture){0};
+
+    cendf_set_log_rate(2);
+    for (int i = 0; i < 100; i++) get_vector(NULL, 0);
+    // A new second may start during the loop, which allows two more
+    assert_true(capture.calls >= 2 && capture.calls <= 4);
+
+    // The dropped errors are counted with the next error that is logged
+    cendf_set_log_rate(0);
+    get_vector(NULL, 0);
+    assert_int_equal(capture.calls + capture.suppressed, 101);
+    restore_log();
+}
+// --------------------------------------------------------------------------------
+
+void test_diagnostics_status(void **state) {
+    (void) state;
+    log_capture capture = {0};
+    cendf_set_log_handler(capture_log, &capture);
+    cendf_set_log_rate(0);
+    cendf_clear_error();
+    errno = 0;
+
+    xsec_t* xsec XSEC_GBC = init_xsec(3);
+    push_xsec(xsec, 1.f, 1.f);
+    push_xsec(xsec, 2.f, 2.f);
+    push_xsec(xsec, 4.f, 3.f);
+    cendfStatus status;
+    assert_float_equal(interp_xsec_status(xsec, 2.5f, &status), interp_xsec(xsec, 2.5f), 1e-6);
+    assert_int_equal(status, CENDF_STATUS_OK);
+    assert_float_equal(interp_xsec_status(xsec, 5.f, &status), -1.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_RANGE);
+    assert_float_equal(interp_xsec_status(NULL, 1.f, &status), -1.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_INVALID);
+    assert_float_equal(interp_xsec_status(xsec, 0.f, NULL), -1.f, 1e-6);
+    xsecHint hint = {0};
+    assert_float_equal(interp_xsec_hint_status(xsec, 2.5f, &hint, &status), 3.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_OK);
+    assert_float_equal(interp_xsec_hint_status(xsec, 9.f, &hint, &status), -1.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_RANGE);
+    assert_float_equal(get_xsec_status(xsec, 2, &status), 4.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_OK);
+    get_xsec_energy_status(xsec, 3, &status);
+    assert_int_equal(status, CENDF_STATUS_INVALID);
+
+    vector_t* vec VECTOR_GBC = init_vector(1);
+    push_back_vector(vec, 7.f);
+    assert_float_equal(get_vector_status(vec, 0, &status), 7.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_OK);
+    get_vector_status(vec, 1, &status);
+    assert_int_equal(status, CENDF_STATUS_INVALID);
+
+    dict_t* dict DICT_GBC = init_dict();
+    insert_dict(dict, "one", 1.f);
+    assert_float_equal(get_dict_value_status(dict, "one", &status), 1.f, 1e-6);
+    assert_int_equal(status, CENDF_STATUS_OK);
+    get_dict_value_status(dict, "two", &status);
+    assert_int_equal(status, CENDF_STATUS_NO_DATA);
+
+    const xsec_t* tables[] = {xsec};
+    union_grid_t* grid UNION_GRID_GBC = init_union_grid(tables, 1);
+    float xs;
+    assert_true(interp_union_grid_status(grid, 2.5f, &xs, &status));
+    assert_float_equal(xs, 3.f, 1e-6);
+    assert_false(interp_union_grid_status(grid, 0.5f, &xs, &status));
+    assert_int_equal(status, CENDF_STATUS_RANGE);
+
+    const double energy[] = {1.0, 2.0};
+    const double value[] = {1.0, 2.0};
+    xsec_f64_t* f64 XSEC_F64_GBC = init_xsec_f64_from(energy, value, 2);
+    assert_float_equal(interp_xsec_f64_status(f64, 1.5, &status), 1.5, 1e-12);
+    assert_int_equal(status, CENDF_STATUS_OK);
+    interp_xsec_f64_status(f64, 3.0, &status);
+    assert_int_equal(status, CENDF_STATUS_RANGE);
+
+    // None of the failures above reached the log, errno or the last error
+    assert_int_equal(capture.calls, 0);
+    assert_int_equal(errno, 0);
+    assert_int_equal(cendf_last_error()->code, 0);
+    restore_log();
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,64 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_diagnostics.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_diagnostics_H
+#define test_diagnostics_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/diagnostics.h"
+#include "../include/union_grid.h"
+#include "../include/xsec_precision.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test the last error record of a thread
+ */
+void test_diagnostics_last_error(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that each thread keeps its own last error
+ */
+void test_diagnostics_threads(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test a user installed log handler
+ */
+void test_diagnostics_handler(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that the rate limit drops and counts errors
+ */
+void test_diagnostics_rate_limit(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that the _status functions neither log, set errno nor record errors
+ */
+void test_diagnostics_status(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_diagnostics_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -14,6 +14,7 @@
 
 #include "test_dstructures.h"
 
+#include <errno.h>
 #include <float.h>
 // ================================================================================
 // ================================================================================ 
@@ -54,6 +55,37 @@ void test_push_xsec(void **state) {
 }
 // --------------------------------------------------------------------------------
 
+void test_init_xsec_view(void **state) {
+    (void) state;
+    const float xs[3] = {10.0f, 20.0f, 30.0f};
+    const float energy[3] = {1.0f, 2.0f, 3.0f};
+    xsec_t* cross_sec = init_xsec_view(xs, energy, 3);
+    assert_non_null(cross_sec);
+    assert_int_equal(xsec_size(cross_sec), 3);
+    assert_ptr_equal(get_xsec_xsArray(cross_sec), xs);
+    assert_ptr_equal(get_xsec_enArray(cross_sec), energy);
+    assert_float_equal(interp_xsec(cross_sec, 1.5f), 15.0f, 1.0e-3);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        free_xsec(cross_sec);
+        return;
+    }
+    errno = 0;
+    bool pushed = push_xsec(cross_sec, 40.0f, 4.0f);
+    int error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(pushed);
+    assert_int_equal(error, EPERM);
+    assert_int_equal(xsec_size(cross_sec), 3);
+    // Frees the view only, the arrays are owned by this function
+    free_xsec(cross_sec);
+}
+// --------------------------------------------------------------------------------
+
 void test_get_xsec_data(void **state) {
     (void) state;
     xsec_t* cross_sec = init_xsec(4);
@@ -299,6 +331,649 @@ void test_interp_xsec_bounds(void **state) {
 
     free_xsec(xsec);
 }
+// --------------------------------------------------------------------------------
+
+void test_xsec_interpolation_laws(void **state) {
+    (void) state;
+    xsec_t* xsec XSEC_GBC = init_xsec(5);
+    assert_non_null(xsec);
+    const float energy[] = {1.f, 2.f, 4.f, 8.f, 16.f};
+    const float xs[] = {10.f, 40.f, 80.f, 0.f, 30.f};
+    for (int i = 0; i < 5; i++) push_xsec(xsec, xs[i], energy[i]);
+    assert_int_equal(get_xsec_interpolation(xsec, NULL, NULL), 0);
+
+    // log-log, log-lin, histogram and lin-log intervals
+    const size_t nbt[] = {2, 3, 4, 5};
+    const int law[] = {5, 4, 1, 3};
+    assert_true(set_xsec_interpolation(xsec, nbt, law, 4));
+    const size_t* ranges;
+    const int* laws;
+    assert_int_equal(get_xsec_interpolation(xsec, &ranges, &laws), 4);
+    assert_int_equal(ranges[3], 5);
+    assert_int_equal(laws[0], 5);
+    assert_float_equal(interp_xsec(xsec, 1.5f), 22.5f, 1e-4);
+    assert_float_equal(interp_xsec(xsec, 3.f), 56.5685425f, 1e-4);
+    assert_float_equal(interp_xsec(xsec, 6.f), 80.f, 1e-6);
+    assert_float_equal(interp_xsec(xsec, 11.3137085f), 15.f, 1e-4);
+    assert_float_equal(interp_xsec(xsec, 4.f), 80.f, 1e-6);
+
+    // A log-log interval that starts at zero is interpolated lin-lin
+    xsec_t* edge XSEC_GBC = init_xsec(2);
+    push_xsec(edge, 0.f, 1.f);
+    push_xsec(edge, 10.f, 2.f);
+    const size_t edge_nbt[] = {2};
+    const int edge_law[] = {5};
+    assert_true(set_xsec_interpolation(edge, edge_nbt, edge_law, 1));
+    assert_float_equal(interp_xsec(edge, 1.5f), 5.f, 1e-6);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    bool pushed = push_xsec(xsec, 1.f, 32.f);
+    int push_error = errno;
+    const size_t short_nbt[] = {4};
+    const int bad_law[] = {6};
+    errno = 0;
+    bool short_ranges = set_xsec_interpolation(edge, short_nbt, edge_law, 1);
+    int short_error = errno;
+    errno = 0;
+    bool unknown_law = set_xsec_interpolation(edge, edge_nbt, bad_law, 1);
+    int law_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(pushed);
+    assert_int_equal(push_error, EPERM);
+    assert_false(short_ranges);
+    assert_int_equal(short_error, EINVAL);
+    assert_false(unknown_law);
+    assert_int_equal(law_error, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_log_bins(void **state) {
+    (void) state;
+    // A geometric grid from 1 to 1e8 with a repeated energy at an edge
+    xsec_t* xsec XSEC_GBC = init_xsec(1000);
+    xsec_t* plain XSEC_GBC = init_xsec(1000);
+    for (int i = 0; i < 1000; i++) {
+        float energy = powf(10.f, 8.f * (float)i / 999.f);
+        float xs = 1000.f / sqrtf(energy) + (i >= 500 ? 50.f : 0.f);
+        push_xsec(xsec, xs, energy);
+        push_xsec(plain, xs, energy);
+        if (i == 499) {
+            push_xsec(xsec, xs + 50.f, energy);
+            push_xsec(plain, xs + 50.f, energy);
+        }
+    }
+    const size_t len = xsec_size(xsec);
+    const float* x = get_xsec_enArray(xsec);
+    assert_int_equal(xsec_bins(xsec), 0);
+    assert_true(build_xsec_bins(xsec, 64));
+    assert_int_equal(xsec_bins(xsec), 64);
+
+    // The binned lookup matches a full search at, between and around every point
+    for (size_t i = 0; i + 1 < len; i++) {
+        const float probes[] = {x[i], 0.5f * (x[i] + x[i + 1]), nextafterf(x[i + 1], 0.f)};
+        for (int p = 0; p < 3; p++) {
+            size_t index;
+            assert_true(find_xsec_interval(xsec, probes[p], &index));
+            size_t expected = 0;
+            while (expected + 2 < len && x[expected + 1] <= probes[p]) expected++;
+            assert_int_equal(index, expected);
+            const float value = interp_xsec(xsec, probes[p]);
+            assert_float_equal(value, interp_xsec(plain, probes[p]), 0.f);
+            // A repeated energy takes the value above the edge
+            if (expected > 0 && x[expected - 1] == probes[p])
+                assert_float_equal(value, get_xsec(xsec, expected), 0.f);
+        }
+    }
+    size_t index;
+    assert_true(find_xsec_interval(xsec, x[len - 1], &index));
+    assert_int_equal(index, len - 2);
+    assert_true(find_xsec_interval(plain, x[len - 1], &index));
+    assert_int_equal(index, len - 2);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    bool below = find_xsec_interval(xsec, 0.5f, &index);
+    int range_error = errno;
+    errno = 0;
+    bool no_bins = build_xsec_bins(xsec, 0);
+    int bins_error = errno;
+    xsec_t* zero XSEC_GBC = init_xsec(2);
+    push_xsec(zero, 1.f, 0.f);
+    push_xsec(zero, 1.f, 1.f);
+    errno = 0;
+    bool zero_energy = build_xsec_bins(zero, 8);
+    int zero_error = errno;
+    // Pushing a point discards the bins
+    push_xsec(xsec, 1.f, 2e8f);
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(below);
+    assert_int_equal(range_error, ERANGE);
+    assert_false(no_bins);
+    assert_int_equal(bins_error, EINVAL);
+    assert_false(zero_energy);
+    assert_int_equal(zero_error, EINVAL);
+    assert_int_equal(xsec_bins(xsec), 0);
+    assert_float_equal(interp_xsec(xsec, 2e8f), 1.f, 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_interp_xsec_batch(void **state) {
+    (void) state;
+    // A geometric grid with a repeated energy at an edge
+    xsec_t* xsec XSEC_GBC = init_xsec(300);
+    for (int i = 0; i < 300; i++) {
+        float energy = powf(10.f, 6.f * (float)i / 299.f);
+        push_xsec(xsec, 100.f / sqrtf(energy) + (i >= 150 ? 5.f : 0.f), energy);
+        if (i == 149) push_xsec(xsec, 100.f / sqrtf(energy) + 5.f, energy);
+    }
+    const float* x = get_xsec_enArray(xsec);
+    const size_t len = xsec_size(xsec);
+
+    // An odd number of energies, so every kernel also handles a partial group
+    enum { N = 1003 };
+    float energies[N];
+    float expected[N];
+    float out[N];
+    for (size_t i = 0; i < N; i++) {
+        energies[i] = i % 3 == 0 ? x[(11 * i) % len] : powf(10.f, 6.f * (float)((13 * i) % N) / N);
+        expected[i] = interp_xsec(xsec, energies[i]);
+    }
+    const xsecKernel kernels[] = {XSEC_KERNEL_SCALAR, XSEC_KERNEL_SSE, XSEC_KERNEL_AVX2};
+    for (int k = 0; k < 3; k++) {
+        if (kernels[k] > xsec_batch_kernel()) continue;
+        assert_true(interp_xsec_batch_kernel(xsec, energies, out, N, kernels[k]));
+        for (size_t i = 0; i < N; i++)
+            assert_float_equal(out[i], expected[i], 1e-5f * expected[i]);
+    }
+    assert_true(interp_xsec_batch(xsec, energies, out, N));
+    assert_float_equal(out[N - 1], expected[N - 1], 1e-5f * expected[N - 1]);
+
+    // Tables with interpolation ranges are evaluated one energy at a time
+    const size_t nbt[] = {len};
+    const int law[] = {5};
+    assert_true(set_xsec_interpolation(xsec, nbt, law, 1));
+    assert_true(interp_xsec_batch(xsec, energies, out, N));
+    for (size_t i = 0; i < N; i++)
+        assert_float_equal(out[i], interp_xsec(xsec, energies[i]), 1e-5f * out[i]);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    const float outside[] = {0.5f, 2.f, 2e6f, 10.f};
+    float values[4];
+    errno = 0;
+    bool in_range = interp_xsec_batch(xsec, outside, values, 4);
+    int range_error = errno;
+    errno = 0;
+    bool null_out = interp_xsec_batch(xsec, outside, NULL, 4);
+    int null_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(in_range);
+    assert_int_equal(range_error, ERANGE);
+    assert_float_equal(values[0], -1.f, 1e-6);
+    assert_float_equal(values[1], interp_xsec(xsec, 2.f), 1e-6);
+    assert_float_equal(values[2], -1.f, 1e-6);
+    assert_float_equal(values[3], interp_xsec(xsec, 10.f), 1e-6);
+    assert_false(null_out);
+    assert_int_equal(null_error, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_search_tree(void **state) {
+    (void) state;
+    // Every tree shape up to five levels, and a large table with a repeated edge
+    for (size_t len = 2; len <= 1001; len = len < 40 ? len + 1 : len + 1000) {
+        xsec_t* xsec = init_xsec(len + 1);
+        xsec_t* plain = init_xsec(len + 1);
+        assert_non_null(xsec);
+        assert_non_null(plain);
+        for (size_t i = 0; i < len; i++) {
+            float energy = 1.f + 3.f * (float)i;
+            push_xsec(xsec, 2.f * energy, energy);
+            push_xsec(plain, 2.f * energy, energy);
+            if (len > 40 && i == 500) {
+                push_xsec(xsec, 5.f * energy, energy);
+                push_xsec(plain, 5.f * energy, energy);
+            }
+        }
+        const size_t size = xsec_size(xsec);
+        const float* x = get_xsec_enArray(xsec);
+        assert_false(xsec_has_tree(xsec));
+        assert_true(build_xsec_tree(xsec));
+        assert_true(xsec_has_tree(xsec));
+        for (size_t i = 0; i + 1 < size; i++) {
+            const float probes[] = {x[i], x[i] + 1.f, x[i + 1]};
+            for (int p = 0; p < 3; p++) {
+                size_t index, expected;
+                assert_true(find_xsec_interval(xsec, probes[p], &index));
+                assert_true(find_xsec_interval(plain, probes[p], &expected));
+                assert_int_equal(index, expected);
+                assert_float_equal(interp_xsec(xsec, probes[p]), interp_xsec(plain, probes[p]), 0.f);
+            }
+        }
+        free_xsec(xsec);
+        free_xsec(plain);
+    }
+
+    xsec_t* xsec XSEC_GBC = init_xsec(2);
+    push_xsec(xsec, 1.f, 1.f);
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    bool single = build_xsec_tree(xsec);
+    int single_error = errno;
+    push_xsec(xsec, 2.f, 2.f);
+    bool built = build_xsec_tree(xsec);
+    // Pushing a point discards the tree
+    push_xsec(xsec, 3.f, 3.f);
+    float above = interp_xsec(xsec, 0.5f);
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(single);
+    assert_int_equal(single_error, EINVAL);
+    assert_true(built);
+    assert_false(xsec_has_tree(xsec));
+    assert_float_equal(above, -1.f, 1e-6);
+    assert_float_equal(interp_xsec(xsec, 2.5f), 2.5f, 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_pack_xsec(void **state) {
+    (void) state;
+    // A geometric grid with repeated energies at an edge and at the end
+    xsec_t* xsec XSEC_GBC = init_xsec(500);
+    xsec_t* plain XSEC_GBC = init_xsec(500);
+    for (int i = 0; i < 400; i++) {
+        float energy = powf(10.f, 6.f * (float)i / 399.f);
+        float xs = 100.f / sqrtf(energy) + (i >= 200 ? 5.f : 0.f);
+        push_xsec(xsec, xs, energy);
+        push_xsec(plain, xs, energy);
+        if (i == 199 || i == 399) {
+            push_xsec(xsec, xs + 5.f, energy);
+            push_xsec(plain, xs + 5.f, energy);
+        }
+    }
+    const float* x = get_xsec_enArray(xsec);
+    const size_t len = xsec_size(xsec);
+    assert_false(xsec_is_packed(xsec));
+    assert_true(pack_xsec(xsec));
+    assert_true(xsec_is_packed(xsec));
+    assert_true(pack_xsec(xsec));
+
+    // Packing with and without a search tree matches the unpacked table
+    for (int tree = 0; tree < 2; tree++) {
+        if (tree) assert_true(build_xsec_tree(xsec));
+        for (size_t i = 0; i + 1 < len; i++) {
+            const float probes[] = {x[i], 0.3f * x[i] + 0.7f * x[i + 1]};
+            for (int p = 0; p < 2; p++) {
+                const float expected = interp_xsec(plain, probes[p]);
+                assert_float_equal(interp_xsec(xsec, probes[p]), expected, 1e-5f * expected);
+            }
+        }
+    }
+    assert_float_equal(interp_xsec(xsec, x[len - 1]), get_xsec(xsec, len - 1), 1e-6);
+    assert_float_equal(get_xsec(xsec, 10), get_xsec(plain, 10), 0.f);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    bool pushed = push_xsec(xsec, 1.f, 2e6f);
+    int push_error = errno;
+    const size_t nbt[] = {len};
+    const int law[] = {5};
+    errno = 0;
+    bool ranges = set_xsec_interpolation(xsec, nbt, law, 1);
+    int ranges_error = errno;
+    assert_true(set_xsec_interpolation(plain, nbt, law, 1));
+    errno = 0;
+    bool log_log = pack_xsec(plain);
+    int log_log_error = errno;
+    float above = interp_xsec(xsec, 2e6f);
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(pushed);
+    assert_int_equal(push_error, EPERM);
+    assert_false(ranges);
+    assert_int_equal(ranges_error, EPERM);
+    assert_false(log_log);
+    assert_int_equal(log_log_error, EINVAL);
+    assert_float_equal(above, -1.f, 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_search_consistency(void **state) {
+    (void) state;
+    // Small tables with a repeated energy at the start, in the middle and at the end
+    const float x4[] = {1.f, 1.f, 2.f, 3.f};
+    const float y4[] = {10.f, 20.f, 30.f, 40.f};
+    const float x5[] = {1.f, 2.f, 2.f, 3.f, 4.f};
+    const float y5[] = {1.f, 2.f, 5.f, 6.f, 7.f};
+    const float x7[] = {1.f, 2.f, 3.f, 3.f, 4.f, 5.f, 6.f};
+    const float y7[] = {10.f, 20.f, 30.f, 40.f, 50.f, 60.f, 70.f};
+    const float x6[] = {1.f, 2.f, 3.f, 4.f, 5.f, 5.f};
+    const float y6[] = {1.f, 2.f, 3.f, 4.f, 5.f, 9.f};
+    const float* energies[] = {x4, x5, x7, x6};
+    const float* values[] = {y4, y5, y7, y6};
+    const size_t sizes[] = {4, 5, 7, 6};
+
+    for (size_t t = 0; t < 4; t++) {
+        const float* x = energies[t];
+        const size_t len = sizes[t];
+        // Plain, search tree, packed, and packed with a search tree
+        xsec_t* tables[4];
+        for (size_t k = 0; k < 4; k++) {
+            tables[k] = init_xsec(len);
+            assert_non_null(tables[k]);
+            for (size_t i = 0; i < len; i++)
+                push_xsec(tables[k], values[t][i], x[i]);
+        }
+        assert_true(build_xsec_tree(tables[1]));
+        assert_true(pack_xsec(tables[2]));
+        assert_true(pack_xsec(tables[3]));
+        assert_true(build_xsec_tree(tables[3]));
+
+        for (size_t i = 0; i < len; i++) {
+            // Every search gives the value above the edge at a repeated energy
+            const float expected = interp_xsec(tables[0], x[i]);
+            if (i + 1 < len && x[i + 1] == x[i])
+                assert_float_equal(expected, values[t][i + 1], 0.f);
+            for (size_t k = 1; k < 4; k++)
+                assert_float_equal(interp_xsec(tables[k], x[i]), expected, 0.f);
+            if (i + 1 == len) continue;
+            const float middle = 0.5f * (x[i] + x[i + 1]);
+            for (size_t k = 1; k < 4; k++)
+                assert_float_equal(interp_xsec(tables[k], middle), interp_xsec(tables[0], middle),
+                                   1e-6f);
+        }
+        for (size_t k = 0; k < 4; k++)
+            free_xsec(tables[k]);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_interp_xsec_hint(void **state) {
+    (void) state;
+    xsec_t* xsec XSEC_GBC = init_xsec(500);
+    xsec_t* other XSEC_GBC = init_xsec(2);
+    for (int i = 0; i < 400; i++) {
+        float energy = powf(10.f, 6.f * (float)i / 399.f);
+        push_xsec(xsec, 100.f / sqrtf(energy) + (i >= 200 ? 5.f : 0.f), energy);
+        if (i == 199) push_xsec(xsec, 100.f / sqrtf(energy) + 5.f, energy);
+    }
+    push_xsec(other, 1.f, 1.f);
+    push_xsec(other, 3.f, 3.f);
+    const float* x = get_xsec_enArray(xsec);
+    const size_t len = xsec_size(xsec);
+
+    // A chain that loses energy in small steps, then jumps up and down
+    xsecHint hint = {0};
+    srand(7);
+    float energy = x[len - 1];
+    for (int step = 0; step < 5000; step++) {
+        if (step % 500 == 499) energy = x[(size_t)rand() % len];
+        else energy *= 1.f - 0.02f * (float)rand() / (float)RAND_MAX;
+        if (energy < x[0]) energy = x[len - 1];
+        size_t expected;
+        assert_true(find_xsec_interval(xsec, energy, &expected));
+        float value = interp_xsec_hint(xsec, energy, &hint);
+        assert_ptr_equal(hint.table, xsec);
+        assert_int_equal(hint.index, expected);
+        if (x[expected] == x[expected + 1] || (expected > 0 && x[expected - 1] == energy)) continue;
+        assert_float_equal(value, interp_xsec(xsec, energy), 0.f);
+    }
+
+    // The same hint moved to another table starts over
+    assert_float_equal(interp_xsec_hint(other, 2.f, &hint), 2.f, 1e-6);
+    assert_ptr_equal(hint.table, other);
+    assert_int_equal(hint.index, 0);
+    assert_float_equal(interp_xsec_hint(xsec, x[len - 1], &hint), get_xsec(xsec, len - 1), 1e-6);
+    assert_int_equal(hint.index, len - 2);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    float below = interp_xsec_hint(xsec, 0.5f, &hint);
+    int range_error = errno;
+    errno = 0;
+    float no_hint = interp_xsec_hint(xsec, 2.f, NULL);
+    int hint_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_float_equal(below, -1.f, 1e-6);
+    assert_int_equal(range_error, ERANGE);
+    assert_int_equal(hint.index, len - 2);
+    assert_float_equal(no_hint, -1.f, 1e-6);
+    assert_int_equal(hint_error, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+static int compare_floats(const void* a, const void* b) {
+    const float x = *(const float*)a;
+    const float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+// --------------------------------------------------------------------------------
+
+void test_interp_xsec_sorted(void **state) {
+    (void) state;
+    xsec_t* xsec XSEC_GBC = init_xsec(300);
+    for (int i = 0; i < 300; i++) {
+        float energy = powf(10.f, 6.f * (float)i / 299.f);
+        push_xsec(xsec, 100.f / sqrtf(energy) + (i >= 150 ? 5.f : 0.f), energy);
+        if (i == 149) push_xsec(xsec, 100.f / sqrtf(energy) + 5.f, energy);
+    }
+    const float* x = get_xsec_enArray(xsec);
+    const size_t len = xsec_size(xsec);
+
+    // A sweep that is denser than the grid, holds every grid energy and
+    // repeats some energies, bracketed by energies outside of the table
+    enum { N = 2000 };
+    float energies[N + 2 * 301];
+    size_t n = 0;
+    for (size_t i = 0; i < N; i++) energies[n++] = powf(10.f, 6.f * (float)i / N);
+    for (size_t i = 0; i < len; i++) energies[n++] = x[i];
+    for (size_t i = 0; i < N; i += 97) energies[n++] = energies[i];
+    energies[n++] = 0.5f;
+    energies[n++] = 2e6f;
+    qsort(energies, n, sizeof(float), compare_floats);
+
+    float sorted[N + 2 * 301];
+    float batch[N + 2 * 301];
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    bool sorted_ok = interp_xsec_sorted(xsec, energies, sorted, n);
+    int sorted_error = errno;
+    bool batch_ok = interp_xsec_batch(xsec, energies, batch, n);
+    const float unordered[] = {1.f, 10.f, 5.f};
+    float values[3];
+    errno = 0;
+    bool unordered_ok = interp_xsec_sorted(xsec, unordered, values, 3);
+    int unordered_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+
+    assert_false(sorted_ok);
+    assert_int_equal(sorted_error, ERANGE);
+    assert_false(batch_ok);
+    assert_float_equal(sorted[0], -1.f, 1e-6);
+    assert_float_equal(sorted[n - 1], -1.f, 1e-6);
+    for (size_t i = 0; i < n; i++)
+        assert_float_equal(sorted[i], batch[i], 1e-5f * fabsf(batch[i]));
+    assert_false(unordered_ok);
+    assert_int_equal(unordered_error, EINVAL);
+    assert_float_equal(values[1], interp_xsec(xsec, 10.f), 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_thin_xsec(void **state) {
+    (void) state;
+    // Collinear points are removed at any tolerance
+    xsec_t* line XSEC_GBC = init_xsec(100);
+    for (int i = 0; i < 100; i++)
+        push_xsec(line, 2.f * (float)i + 1.f, (float)i);
+    size_t removed = 0;
+    assert_true(thin_xsec(line, 0.f, &removed));
+    assert_int_equal(removed, 98);
+    assert_int_equal(xsec_size(line), 2);
+    assert_int_equal(xsec_alloc(line), 2);
+    assert_float_equal(interp_xsec(line, 42.5f), 86.f, 1e-5);
+
+    // A curve with an absorption edge keeps both points of the edge, and
+    // every original point is reproduced within the tolerance
+    xsec_t* curve XSEC_GBC = init_xsec(500);
+    xsec_t* original XSEC_GBC = init_xsec(500);
+    for (int i = 0; i < 400; i++) {
+        float energy = powf(10.f, 6.f * (float)i / 399.f);
+        float xs = 100.f / sqrtf(energy) + (i >= 200 ? 5.f : 0.f);
+        push_xsec(curve, xs, energy);
+        push_xsec(original, xs, energy);
+        if (i == 199) {
+            push_xsec(curve, xs + 5.f, energy);
+            push_xsec(original, xs + 5.f, energy);
+        }
+    }
+    assert_true(build_xsec_tree(curve));
+    assert_true(thin_xsec(curve, 1.0e-3f, &removed));
+    assert_true(removed > 0);
+    assert_int_equal(xsec_size(curve) + removed, xsec_size(original));
+    assert_false(xsec_has_tree(curve));
+    const float* x = get_xsec_enArray(original);
+    const float* thinned = get_xsec_enArray(curve);
+    size_t edges = 0;
+    for (size_t i = 0; i + 1 < xsec_size(curve); i++) {
+        if (thinned[i] == thinned[i + 1]) {
+            edges++;
+            assert_float_equal(thinned[i], x[199], 0.f);
+            assert_float_equal(get_xsec(curve, i), get_xsec(original, 199), 0.f);
+            assert_float_equal(get_xsec(curve, i + 1), get_xsec(original, 200), 0.f);
+        }
+    }
+    assert_int_equal(edges, 1);
+    for (size_t i = 0; i < xsec_size(original); i++) {
+        if (x[i] == x[199]) continue;
+        const float expected = get_xsec(original, i);
+        assert_float_equal(interp_xsec(curve, x[i]), expected, 1.0e-3f * expected);
+    }
+
+    // A power law is exact under log-log from its first point at 11, while
+    // the lin-lin range below it keeps its points and both ranges keep their laws
+    xsec_t* ranges XSEC_GBC = init_xsec(60);
+    for (int i = 0; i < 60; i++) {
+        float energy = (float)(i + 1);
+        push_xsec(ranges, i < 10 ? 100.f - (float)(i * i) : 1.0e4f / (energy * energy), energy);
+    }
+    const size_t nbt[] = {10, 60};
+    const int law[] = {2, 5};
+    assert_true(set_xsec_interpolation(ranges, nbt, law, 2));
+    assert_true(thin_xsec(ranges, 1.0e-5f, &removed));
+    assert_int_equal(xsec_size(ranges), 12);
+    const size_t* new_nbt;
+    const int* new_law;
+    assert_int_equal(get_xsec_interpolation(ranges, &new_nbt, &new_law), 2);
+    assert_int_equal(new_nbt[0], 10);
+    assert_int_equal(new_nbt[1], 12);
+    assert_int_equal(new_law[1], 5);
+    assert_float_equal(interp_xsec(ranges, 25.f), 16.f, 1e-4);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    const float view_x[] = {1.f, 2.f, 3.f};
+    const float view_y[] = {1.f, 2.f, 3.f};
+    xsec_t* view XSEC_GBC = init_xsec_view(view_y, view_x, 3);
+    errno = 0;
+    bool negative = thin_xsec(original, -1.f, NULL);
+    int negative_error = errno;
+    errno = 0;
+    bool read_only = thin_xsec(view, 0.1f, NULL);
+    int read_only_error = errno;
+    assert_true(pack_xsec(line));
+    errno = 0;
+    bool packed = thin_xsec(line, 0.1f, NULL);
+    int packed_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_false(negative);
+    assert_int_equal(negative_error, EINVAL);
+    assert_int_equal(xsec_size(original), 401);
+    assert_false(read_only);
+    assert_int_equal(read_only_error, EPERM);
+    assert_int_equal(xsec_size(view), 3);
+    assert_false(packed);
+    assert_int_equal(packed_error, EPERM);
+}
+// --------------------------------------------------------------------------------
+
+void test_interp_form_factor(void **state) {
+    (void) state;
+    const float x[] = {0.0f, 1.0f, 2.0f, 4.0f};
+    const float value[] = {47.0f, 46.0f, 44.0f, 40.0f};
+    form_factor_t* form_factor FORM_FACTOR_GBC = init_form_factor(value, x, 4, 502);
+    assert_non_null(form_factor);
+    assert_int_equal(form_factor_size(form_factor), 4);
+    assert_int_equal(form_factor_mt(form_factor), 502);
+    assert_float_equal(get_form_factor_x(form_factor, 3), 4.0f, 1e-6);
+    assert_float_equal(get_form_factor(form_factor, 3), 40.0f, 1e-6);
+    assert_float_equal(interp_form_factor(form_factor, 0.0f), 47.0f, 1e-6);
+    assert_float_equal(interp_form_factor(form_factor, 1.5f), 45.0f, 1e-6);
+    assert_float_equal(interp_form_factor(form_factor, 3.0f), 42.0f, 1e-6);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    float above = interp_form_factor(form_factor, 5.0f);
+    int range_error = errno;
+    errno = 0;
+    form_factor_t* empty = init_form_factor(value, x, 0, 502);
+    int empty_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_float_equal(above, -1.0f, 1e-6);
+    assert_int_equal(range_error, ERANGE);
+    assert_null(empty);
+    assert_int_equal(empty_error, EINVAL);
+}
 // ================================================================================
 // ================================================================================ 
 
@@ -46,6 +46,12 @@ void test_init_xsec(void **state);
 void test_push_xsec(void **state);
 // --------------------------------------------------------------------------------
 
+/*
+ * Test a read-only xsec_t view over caller owned arrays
+ */
+void test_init_xsec_view(void **state);
+// --------------------------------------------------------------------------------
+
 /*
  * Test the ability to extract data into the xsecData struct
  */
@@ -95,6 +101,66 @@ void test_interp_xsec_null_pointer(void **state);
 // --------------------------------------------------------------------------------
 
 void test_interp_xsec_bounds(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the TAB1 interpolation laws of xsec_t
+ */
+void test_xsec_interpolation_laws(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the logarithmic search bins of xsec_t
+ */
+void test_xsec_log_bins(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the Eytzinger search tree of xsec_t
+ */
+void test_xsec_search_tree(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the packed record layout of xsec_t
+ */
+void test_pack_xsec(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that packing and the search tree leave interp_xsec unchanged, repeated energies included
+ */
+void test_xsec_search_consistency(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test interpolation of xsec_t from a search hint
+ */
+void test_interp_xsec_hint(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the batched interpolation of xsec_t with every available kernel
+ */
+void test_interp_xsec_batch(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the merge-walk interpolation of xsec_t over ascending energies
+ */
+void test_interp_xsec_sorted(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test thinning of xsec_t tables with edges and interpolation ranges
+ */
+void test_thin_xsec(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test construction and interpolation of a form_factor_t table
+ */
+void test_interp_form_factor(void **state);
 // ================================================================================ 
 // ================================================================================
 // TEST STRING 
@@ -0,0 +1,323 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_library.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_library.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+// ================================================================================
+// ================================================================================
+
+/*
+ * Copies a file so that tests can modify a directory without touching the
+ * data that ships with the repository.
+ */
+static bool copy_file(const char* source, const char* destination) {
+    FILE* in = fopen(source, "rb");
+    if (!in) return false;
+    FILE* out = fopen(destination, "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+    char buffer[4096];
+    size_t bytes;
+    while ((bytes = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        fwrite(buffer, 1, bytes, out);
+    fclose(in);
+    return fclose(out) == 0;
+}
+// ================================================================================
+// ================================================================================
+
+void test_library_index_nominal(void **state) {
+    (void) state;
+    const char* index_file = "test_library_nominal.idx";
+    assert_true(build_library_index("../../../../data/xsec/photoat-version.VIII.1", index_file, 4));
+    library_index_t* index LIBRARY_INDEX_GBC = open_library_index(index_file);
+    remove(index_file);
+    assert_non_null(index);
+    assert_int_equal(library_index_size(index), 100);
+    assert_false(library_index_stale(index));
+
+    // Materials are sorted by ZA
+    const libraryMaterial* materials = get_library_materials(index);
+    assert_float_equal(materials[0].za, 1000.0f, 1.0e-3);
+    assert_float_equal(materials[99].za, 100000.0f, 1.0e-3);
+
+    const libraryMaterial* lead = find_library_material(index, 82);
+    assert_non_null(lead);
+    assert_int_equal(lead->mat, 8200);
+    assert_float_equal(lead->awr, 205.42f, 1.0e-2);
+    assert_int_equal(lead->num_sections, 36);
+    assert_non_null(strstr(lead->file_name, "photoat-082_Pb_000.endf"));
+
+    const librarySection* section = find_library_section(index, 82, 27, 504);
+    assert_non_null(section);
+    assert_int_equal(section->np, 434);
+    assert_float_equal(section->emin, 0.0f, 1.0e-6);
+    assert_float_equal(section->emax, 1.0e9f, 1.0f);
+
+    // The index must agree with a read of the section itself
+    endf_index_t* endf ENDF_INDEX_GBC = read_endf_index(lead->file_name);
+    assert_non_null(endf);
+    assert_int_equal(get_endf_section(endf, 27, 504)->offset, section->offset);
+    xsec_t* xsec XSEC_GBC = read_indexed_xsec(endf, 27, 504);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(xsec), section->np);
+    assert_float_equal(get_xsec_energy(xsec, section->np - 1), section->emax, 1.0f);
+
+    assert_float_equal(library_amu(index, 47, 1.00866), 107.867104, 1.0e-3);
+    errno = 0;
+    assert_null(find_library_section(index, 82, 27, 999));
+    assert_int_equal(errno, ENODATA);
+    errno = 0;
+    assert_null(find_library_material(index, 101));
+    assert_int_equal(errno, ENODATA);
+}
+// --------------------------------------------------------------------------------
+
+void test_library_index_skips_bad_file(void **state) {
+    (void) state;
+    const char* index_file = "test_library_skip.idx";
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    bool built = build_library_index("../../../../data/test", index_file, 2);
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_true(built);
+
+    library_index_t* index = open_library_index(index_file);
+    remove(index_file);
+    assert_non_null(index);
+    assert_int_equal(library_index_size(index), 1);
+    assert_false(library_index_stale(index));
+    const librarySection* section = find_library_section(index, 47, 23, 534);
+    assert_non_null(section);
+    assert_int_equal(section->offset, 6628 * 76);
+    assert_int_equal(section->np, 450);
+    assert_float_equal(section->emin, 25520.0f, 1.0e-3);
+    free_library_index(index);
+}
+// --------------------------------------------------------------------------------
+
+void test_library_index_stale(void **state) {
+    (void) state;
+    char directory[] = "/tmp/cendf_library_XXXXXX";
+    assert_non_null(mkdtemp(directory));
+    char data_file[64];
+    char index_file[64];
+    char extra_file[64];
+    snprintf(data_file, sizeof(data_file), "%s/photoat-047_Ag_000.endf", directory);
+    snprintf(index_file, sizeof(index_file), "%s/library.idx", directory);
+    snprintf(extra_file, sizeof(extra_file), "%s/photoat-082_Pb_000.endf", directory);
+    assert_true(copy_file("../../../../data/test/photoat-047_Ag_000.endf", data_file));
+
+    assert_true(build_library_index(directory, index_file, 1));
+    library_index_t* index = open_library_index(index_file);
+    assert_non_null(index);
+    assert_false(library_index_stale(index));
+
+    // A new material in the directory makes the index stale
+    assert_true(copy_file("../../../../data/xsec/photoat-version.VIII.1/photoat-082_Pb_000.endf",
+                          extra_file));
+    assert_true(library_index_stale(index));
+    remove(extra_file);
+    assert_false(library_index_stale(index));
+
+    // So does a change to the size of an indexed file
+    FILE* file = fopen(data_file, "a");
+    assert_non_null(file);
+    fputs("\n", file);
+    fclose(file);
+    assert_true(library_index_stale(index));
+    free_library_index(index);
+
+    remove(data_file);
+    remove(index_file);
+    rmdir(directory);
+}
+// --------------------------------------------------------------------------------
+
+void test_library_index_failure(void **state) {
+    (void) state;
+    const char* index_file = "test_library_damaged.idx";
+    FILE* file = fopen(index_file, "wb");
+    assert_non_null(file);
+    fputs("CENDFIDX but not an index", file);
+    fclose(file);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        remove(index_file);
+        return;
+    }
+    errno = 0;
+    bool built = build_library_index("../../../../data/no_directory", "unused.idx", 1);
+    int no_directory = errno;
+    errno = 0;
+    library_index_t* damaged = open_library_index(index_file);
+    int bad_index = errno;
+    errno = 0;
+    library_index_t* missing = open_library_index("no_file.idx");
+    int no_file = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    remove(index_file);
+
+    assert_false(built);
+    assert_int_equal(no_directory, ENOENT);
+    assert_null(damaged);
+    assert_int_equal(bad_index, EINVAL);
+    assert_null(missing);
+    assert_int_equal(no_file, ENOENT);
+}
+// --------------------------------------------------------------------------------
+
+void test_load_xsec_library_nominal(void **state) {
+    (void) state;
+    const char* files[] = {
+        "../../../../data/xsec/photoat-version.VIII.1/photoat-082_Pb_000.endf",
+        "../../../../data/test/photoat-047_Ag_000.endf"
+    };
+    xsec_library_t* library XSEC_LIBRARY_GBC = load_xsec_library(files, 2, 2);
+    assert_non_null(library);
+    assert_int_equal(xsec_library_size(library), 61);
+    assert_int_equal(xsec_library_files(library), 2);
+
+    // Results keep the order of the input, tables are sorted by ZA, MF and MT
+    const loadResult* results = get_load_results(library);
+    assert_string_equal(results[0].file_name, files[0]);
+    assert_int_equal(results[0].error, 0);
+    assert_int_equal(results[0].num_tables, 35);
+    assert_int_equal(results[1].num_tables, 26);
+    assert_true(results[1].seconds > 0.0);
+    const libraryTable* tables = get_library_tables(library);
+    assert_float_equal(tables[0].za, 47000.0f, 1.0e-3);
+    assert_int_equal(tables[0].mt, 501);
+    assert_float_equal(tables[60].za, 82000.0f, 1.0e-3);
+    assert_int_equal(tables[60].mf, 27);
+    assert_int_equal(tables[60].mt, 506);
+
+    const xsec_t* xsec = get_library_xsec(library, 47, 23, 534);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(xsec), 450);
+    assert_float_equal(get_xsec(xsec, 1), 8241.68669f, 1.0e-2);
+    errno = 0;
+    assert_null(get_library_xsec(library, 82, 23, 999));
+    assert_int_equal(errno, ENODATA);
+}
+// --------------------------------------------------------------------------------
+
+void test_load_xsec_library_bad_table(void **state) {
+    (void) state;
+    // A copy of the silver file with a malformed record in the K-shell table
+    const char* endf_file = "test_library_bad_table.endf";
+    FILE* in = fopen("../../../../data/test/photoat-047_Ag_000.endf", "r");
+    FILE* out = fopen(endf_file, "w");
+    assert_non_null(in);
+    assert_non_null(out);
+    char line[128];
+    for (size_t i = 0; fgets(line, sizeof(line), in); i++) {
+        if (i == 6640) memcpy(line, " 41624.0x36", 11);
+        fputs(line, out);
+    }
+    fclose(in);
+    fclose(out);
+
+    // The file fails as a whole rather than loading without the table
+    const char* files[] = {endf_file};
+    errno = 0;
+    xsec_library_t* library XSEC_LIBRARY_GBC = load_xsec_library(files, 1, 1);
+    remove(endf_file);
+    assert_int_equal(errno, 0);
+    assert_non_null(library);
+    const loadResult* results = get_load_results(library);
+    assert_int_equal(results[0].error, EINVAL);
+    assert_int_equal(results[0].num_tables, 0);
+    assert_int_equal(xsec_library_size(library), 0);
+}
+// --------------------------------------------------------------------------------
+
+void test_load_xsec_library_errors(void **state) {
+    (void) state;
+    const char* files[] = {
+        "../../../../data/test/fail_read_mass.endf",
+        "../../../../data/test/no_file.endf",
+        "../../../../data/test/photoat-047_Ag_000.endf"
+    };
+    // Failures are reported per file, without touching errno or stderr
+    errno = 0;
+    xsec_library_t* library = load_xsec_library(files, 3, 3);
+    assert_int_equal(errno, 0);
+    assert_non_null(library);
+    const loadResult* results = get_load_results(library);
+    assert_int_equal(results[0].error, EINVAL);
+    assert_int_equal(results[0].num_tables, 0);
+    assert_int_equal(results[1].error, ENOENT);
+    assert_int_equal(results[2].error, 0);
+    assert_int_equal(xsec_library_size(library), 26);
+    free_xsec_library(library);
+
+    xsec_library_t* directory = load_xsec_directory("../../../../data/test", 0);
+    assert_non_null(directory);
+    assert_int_equal(xsec_library_files(directory), 2);
+    assert_int_equal(xsec_library_size(directory), 26);
+
+    // Thinning keeps every table and shrinks the silver total
+    const size_t total_len = xsec_size(get_library_xsec(directory, 47, 23, 501));
+    size_t removed = 0;
+    assert_true(thin_xsec_library(directory, 1.0e-3f, &removed));
+    assert_true(removed > 0);
+    assert_int_equal(xsec_library_size(directory), 26);
+    assert_true(xsec_size(get_library_xsec(directory, 47, 23, 501)) < total_len);
+    free_xsec_library(directory);
+}
+// --------------------------------------------------------------------------------
+
+void test_load_xsec_elements(void **state) {
+    (void) state;
+    const char* index_file = "test_library_elements.idx";
+    assert_true(build_library_index("../../../../data/xsec/photoat-version.VIII.1", index_file, 0));
+    library_index_t* index = open_library_index(index_file);
+    remove(index_file);
+    assert_non_null(index);
+
+    const int z[] = {82, 200, 1};
+    xsec_library_t* library = load_xsec_elements(index, z, 3, 2);
+    free_library_index(index);
+    assert_non_null(library);
+
+    // File names remain valid after the index is freed
+    const loadResult* results = get_load_results(library);
+    assert_non_null(strstr(results[0].file_name, "photoat-082_Pb_000.endf"));
+    assert_null(results[1].file_name);
+    assert_int_equal(results[1].error, ENODATA);
+    assert_non_null(strstr(results[2].file_name, "photoat-001_H_000.endf"));
+    assert_non_null(get_library_xsec(library, 1, 23, 501));
+    assert_non_null(get_library_xsec(library, 82, 27, 505));
+    free_xsec_library(library);
+}
+// ================================================================================
+// ================================================================================
+// eof
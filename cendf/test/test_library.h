@@ -0,0 +1,80 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_library.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_library_H
+#define test_library_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/library.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test building and querying an index of the full photo-atomic library
+ */
+void test_library_index_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that files which cannot be indexed are left out of the library index
+ */
+void test_library_index_skips_bad_file(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the staleness check after a file in the directory changes
+ */
+void test_library_index_stale(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test library index failures for a bad directory and damaged index files
+ */
+void test_library_index_failure(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test loading a list of files into a library on a pool of threads
+ */
+void test_load_xsec_library_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that a file with a malformed TAB1 table fails to load rather than losing the table
+ */
+void test_load_xsec_library_bad_table(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that load failures are reported per file, and loading a directory
+ */
+void test_load_xsec_library_errors(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test loading a list of elements found through a library index
+ */
+void test_load_xsec_elements(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_library_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,127 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_material.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_material.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+// ================================================================================
+// ================================================================================
+
+void test_material_lazy_load(void **state) {
+    (void) state;
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    material_t* material MATERIAL_GBC = open_material(filename);
+    assert_non_null(material);
+    assert_int_equal(material_loaded_tables(material), 0);
+    assert_float_equal(endf_index_za(get_material_index(material)), 47000.0f, 1.0e-3);
+
+    const xsec_t* first = get_material_xsec(material, 23, 534);
+    assert_non_null(first);
+    assert_int_equal(material_loaded_tables(material), 1);
+    assert_ptr_equal(get_material_xsec(material, 23, 534), first);
+    assert_int_equal(material_loaded_tables(material), 1);
+
+    xsec_t* xsec XSEC_GBC = read_xsec(filename, 23, 534);
+    assert_int_equal(xsec_size(first), xsec_size(xsec));
+    assert_memory_equal(get_xsec_enArray(first), get_xsec_enArray(xsec), xsec_size(xsec) * sizeof(float));
+    assert_memory_equal(get_xsec_xsArray(first), get_xsec_xsArray(xsec), xsec_size(xsec) * sizeof(float));
+
+    assert_non_null(get_material_xsec(material, 23, 501));
+    assert_non_null(get_material_xsec(material, 27, 502));
+    assert_int_equal(material_loaded_tables(material), 3);
+}
+// --------------------------------------------------------------------------------
+
+void test_material_errors(void **state) {
+    (void) state;
+    material_t* material = open_material("../../../../data/test/photoat-047_Ag_000.endf");
+    assert_non_null(material);
+    errno = 0;
+    assert_null(get_material_xsec(material, 23, 999));
+    assert_int_equal(errno, ENODATA);
+
+    // The MF1 directory is not a TAB1 table, and the failure is remembered
+    errno = 0;
+    assert_null(get_material_xsec(material, 1, 451));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_null(get_material_xsec(material, 1, 451));
+    assert_int_equal(errno, EINVAL);
+    assert_int_equal(material_loaded_tables(material), 0);
+    free_material(material);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    material_t* bad = open_material("../../../../data/test/fail_read_mass.endf");
+    int bad_directory = errno;
+    errno = 0;
+    material_t* missing = open_material("../../../../data/test/no_file.endf");
+    int no_file = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(bad);
+    assert_int_equal(bad_directory, EINVAL);
+    assert_null(missing);
+    assert_int_equal(no_file, ENOENT);
+}
+// --------------------------------------------------------------------------------
+
+#define MATERIAL_TEST_THREADS 8
+
+typedef struct {
+    material_t* material;
+    int mt;
+    const xsec_t* xsec;
+} material_request;
+
+static void* request_xsec(void* arg) {
+    material_request* request = arg;
+    request->xsec = get_material_xsec(request->material, 23, request->mt);
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+void test_material_threads(void **state) {
+    (void) state;
+    material_t* material MATERIAL_GBC = open_material("../../../../data/test/photoat-047_Ag_000.endf");
+    assert_non_null(material);
+
+    // Half of the threads race for MT501 and half for MT522
+    pthread_t threads[MATERIAL_TEST_THREADS];
+    material_request requests[MATERIAL_TEST_THREADS];
+    for (size_t i = 0; i < MATERIAL_TEST_THREADS; i++) {
+        requests[i] = (material_request){ .material = material, .mt = i % 2 ? 522 : 501 };
+        assert_int_equal(pthread_create(&threads[i], NULL, request_xsec, &requests[i]), 0);
+    }
+    for (size_t i = 0; i < MATERIAL_TEST_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    for (size_t i = 0; i < MATERIAL_TEST_THREADS; i++) {
+        assert_non_null(requests[i].xsec);
+        assert_ptr_equal(requests[i].xsec, requests[i % 2].xsec);
+    }
+    assert_int_equal(xsec_size(requests[0].xsec), 9287);
+    assert_int_equal(material_loaded_tables(material), 2);
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,50 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_material.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_material_H
+#define test_material_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/material.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test that a material reads each cross section once, on first use
+ */
+void test_material_lazy_load(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test material requests for missing and non-TAB1 sections and a bad file
+ */
+void test_material_errors(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test concurrent first requests from many threads
+ */
+void test_material_threads(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_material_H */
+// ================================================================================
+// ================================================================================
+// eof
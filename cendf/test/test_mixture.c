@@ -0,0 +1,169 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_mixture.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_mixture.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+// ================================================================================
+// ================================================================================
+
+static const char* HYDROGEN = "../../../../data/xsec/photoat-version.VIII.1/photoat-001_H_000.endf";
+static const char* OXYGEN = "../../../../data/xsec/photoat-version.VIII.1/photoat-008_O_000.endf";
+// --------------------------------------------------------------------------------
+
+void test_mixture_water(void **state) {
+    (void) state;
+    material_t* hydrogen MATERIAL_GBC = open_material(HYDROGEN);
+    material_t* oxygen MATERIAL_GBC = open_material(OXYGEN);
+    assert_non_null(hydrogen);
+    assert_non_null(oxygen);
+    // H2O with the atomic weights of the ENDF files
+    const mixtureComponent water[] = {
+        {.material = hydrogen, .fraction = 2.0f},
+        {.material = oxygen, .fraction = 1.0f}
+    };
+    const int mt[] = {501, 502, 504, 522};
+    mixture_t* mixture MIXTURE_GBC = build_mixture(water, 2, MIXTURE_ATOM_FRACTION, 1.0f,
+                                                   23, mt, 4);
+    assert_non_null(mixture);
+    assert_int_equal(mixture_reactions(mixture), 4);
+    assert_int_equal(mixture_components(mixture), 2);
+    assert_float_equal(mixture_density(mixture), 1.0f, 1e-6);
+    const double hydrogen_density = mixture_atom_density(mixture, 0);
+    const double oxygen_density = mixture_atom_density(mixture, 1);
+    assert_float_equal(hydrogen_density, 0.066856, 1.0e-5);
+    assert_float_equal(oxygen_density, 0.5 * hydrogen_density, 1.0e-9);
+
+    // Each reaction is the sum over the elements of atom density times cross section
+    const union_grid_t* grid = get_mixture_grid(mixture);
+    const float* energy = get_union_energy(grid);
+    const size_t len = union_grid_size(grid);
+    const material_t* elements[] = {hydrogen, oxygen};
+    const double density[] = {hydrogen_density, oxygen_density};
+    float xs[4];
+    for (size_t i = 0; i + 1 < len; i += 11) {
+        if (energy[i + 1] == energy[i]) continue;
+        float e = 0.5f * (energy[i] + energy[i + 1]);
+        assert_true(interp_mixture(mixture, e, xs));
+        for (size_t r = 0; r < 4; r++) {
+            double expected = 0.0;
+            for (size_t c = 0; c < 2; c++) {
+                const xsec_t* table = get_material_xsec((material_t*)elements[c], 23, mt[r]);
+                if (e >= get_xsec_energy(table, 0) && e <= get_xsec_energy(table, xsec_size(table) - 1))
+                    expected += density[c] * interp_xsec(table, e);
+            }
+            assert_float_equal(xs[r], expected, 1.0e-5 * fabs(expected) + 1.0e-30);
+        }
+    }
+
+    // The mass attenuation coefficient of water at 1 MeV is 0.0707 cm^2/g
+    assert_true(interp_mixture(mixture, 1.0e6f, xs));
+    assert_float_equal(xs[0], 0.0707, 0.0707 * 0.01);
+
+    // A batch matches single lookups
+    const float batch_energies[] = {1.0e3f, 3.0e4f, 1.0e6f};
+    float batch[3 * 4];
+    assert_true(interp_mixture_batch(mixture, batch_energies, batch, 3));
+    for (size_t i = 0; i < 3; i++) {
+        assert_true(interp_mixture(mixture, batch_energies[i], xs));
+        assert_memory_equal(batch + 4 * i, xs, sizeof(xs));
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_mixture_basis(void **state) {
+    (void) state;
+    material_t* hydrogen MATERIAL_GBC = open_material(HYDROGEN);
+    material_t* oxygen MATERIAL_GBC = open_material(OXYGEN);
+    assert_non_null(hydrogen);
+    assert_non_null(oxygen);
+    const float weight_h = 1.008f;
+    const float weight_o = 15.999f;
+    const float molar_mass = 2.0f * weight_h + weight_o;
+    const mixtureComponent atoms[] = {
+        {.material = hydrogen, .atomic_weight = weight_h, .fraction = 2.0f},
+        {.material = oxygen, .atomic_weight = weight_o, .fraction = 1.0f}
+    };
+    // Mass fractions in percent, which are normalized by their sum
+    const mixtureComponent mass[] = {
+        {.material = hydrogen, .atomic_weight = weight_h, .fraction = 200.0f * weight_h / molar_mass},
+        {.material = oxygen, .atomic_weight = weight_o, .fraction = 100.0f * weight_o / molar_mass}
+    };
+    const int mt[] = {501};
+    mixture_t* by_atom MIXTURE_GBC = build_mixture(atoms, 2, MIXTURE_ATOM_FRACTION, 0.5f, 23, mt, 1);
+    mixture_t* by_mass MIXTURE_GBC = build_mixture(mass, 2, MIXTURE_MASS_FRACTION, 0.5f, 23, mt, 1);
+    assert_non_null(by_atom);
+    assert_non_null(by_mass);
+    for (size_t c = 0; c < 2; c++)
+        assert_float_equal(mixture_atom_density(by_atom, c), mixture_atom_density(by_mass, c), 1.0e-7);
+
+    const float energies[] = {1.0e3f, 3.0e4f, 1.0e6f, 5.0e7f};
+    for (size_t i = 0; i < 4; i++) {
+        float xs_atom;
+        float xs_mass;
+        assert_true(interp_mixture(by_atom, energies[i], &xs_atom));
+        assert_true(interp_mixture(by_mass, energies[i], &xs_mass));
+        assert_float_equal(xs_atom, xs_mass, 1.0e-5 * xs_atom);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_mixture_errors(void **state) {
+    (void) state;
+    material_t* oxygen MATERIAL_GBC = open_material(OXYGEN);
+    assert_non_null(oxygen);
+    const mixtureComponent negative[] = {{.material = oxygen, .fraction = -1.0f}};
+    const mixtureComponent valid[] = {{.material = oxygen, .fraction = 1.0f}};
+    const int missing[] = {501, 999};
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    mixture_t* bad_fraction = build_mixture(negative, 1, MIXTURE_MASS_FRACTION, 1.0f, 23, missing, 1);
+    int fraction_error = errno;
+    errno = 0;
+    mixture_t* bad_density = build_mixture(valid, 1, MIXTURE_MASS_FRACTION, 0.0f, 23, missing, 1);
+    int density_error = errno;
+    errno = 0;
+    mixture_t* bad_reaction = build_mixture(valid, 1, MIXTURE_MASS_FRACTION, 1.0f, 23, missing, 2);
+    int reaction_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(bad_fraction);
+    assert_int_equal(fraction_error, EINVAL);
+    assert_null(bad_density);
+    assert_int_equal(density_error, EINVAL);
+    assert_null(bad_reaction);
+    assert_int_equal(reaction_error, ENODATA);
+
+    mixture_t* mixture MIXTURE_GBC = build_mixture(valid, 1, MIXTURE_MASS_FRACTION, 1.0f, 23, missing, 1);
+    assert_non_null(mixture);
+    float xs;
+    cendfStatus status;
+    assert_false(interp_mixture_status(mixture, 1.0e-3f, &xs, &status));
+    assert_int_equal(status, CENDF_STATUS_RANGE);
+    assert_false(interp_mixture_status(NULL, 1.0e6f, &xs, &status));
+    assert_int_equal(status, CENDF_STATUS_INVALID);
+    errno = 0;
+    assert_float_equal(mixture_atom_density(mixture, 1), -1.0, 1e-12);
+    assert_int_equal(errno, EINVAL);
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,50 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_mixture.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_mixture_H
+#define test_mixture_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/mixture.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test the macroscopic cross sections of water against its elements
+ */
+void test_mixture_water(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that mass and atom fractions of the same compound agree
+ */
+void test_mixture_basis(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test mixture errors
+ */
+void test_mixture_errors(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_mixture_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -18,6 +18,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <string.h>
+#include <math.h>
 // ================================================================================
 // ================================================================================
 
@@ -77,6 +78,467 @@ void test_read_amu_no_file(void **state) {
     assert_float_equal(mass, -1.0, 1.0e-3);
     assert_int_equal(errno, 2);
 }
+// --------------------------------------------------------------------------------
+
+void test_parse_endf_record_nominal(void **state) {
+    (void) state;
+    const char* record =
+        " 1.00000000 1.36301E-4 1.05924839-1.75146+04 .002000000 46.9944008470023501";
+    double values[6];
+    assert_true(parse_endf_record(record, values));
+    assert_float_equal(values[0], 1.0, 1.0e-12);
+    assert_float_equal(values[1], 1.36301e-4, 1.0e-16);
+    assert_float_equal(values[2], 1.05924839, 1.0e-12);
+    assert_float_equal(values[3], -1.75146e4, 1.0e-8);
+    assert_float_equal(values[4], 0.002, 1.0e-15);
+    assert_float_equal(values[5], 46.9944008, 1.0e-10);
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_endf_record_integers(void **state) {
+    (void) state;
+    const char* record =
+        " 0.0        0.0                 0         -3          1       9287470023501";
+    double values[6];
+    assert_true(parse_endf_record(record, values));
+    assert_float_equal(values[0], 0.0, 1.0e-12);
+    assert_float_equal(values[2], 0.0, 1.0e-12);
+    assert_float_equal(values[3], -3.0, 1.0e-12);
+    assert_float_equal(values[4], 1.0, 1.0e-12);
+    assert_float_equal(values[5], 9287.0, 1.0e-12);
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_endf_record_blank(void **state) {
+    (void) state;
+    const char* record =
+        " 9.6182E+10 15.3734942 1.0000E+11 15.3735022                      470023501";
+    double values[6];
+    assert_true(parse_endf_record(record, values));
+    assert_float_equal(values[0], 9.6182e10, 1.0);
+    assert_float_equal(values[2], 1.0e11, 1.0);
+    assert_float_equal(values[4], 0.0, 1.0e-12);
+    assert_float_equal(values[5], 0.0, 1.0e-12);
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_endf_record_invalid(void **state) {
+    (void) state;
+    const char* record =
+        " 1.00000000 1.363x1E-4 1.05924839 1.75146E-4 1.10597719 2.05788E-4470023501";
+    double values[6];
+    errno = 0;
+    assert_false(parse_endf_record(record, values));
+    assert_int_equal(errno, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_parse_endf_records_batch(void **state) {
+    (void) state;
+    const char* data =
+        " 1.00000000 1.36301E-4 1.05924839 1.75146E-4 1.10597719 2.05788E-4470023501\n"
+        " 1.12500000 2.18264E-4 1.14237171 2.34508E-4 1.19922131 2.87671E-4470023501\n"
+        " 1.25890000 3.43487E-4 1.26562500 3.49778-4  1.33350268 4.40383E-4470023501\n";
+    double values[18];
+    assert_int_equal(parse_endf_records(data, strlen(data), 3, values), 3);
+    assert_float_equal(values[6], 1.125, 1.0e-12);
+    assert_float_equal(values[15], 3.49778e-4, 1.0e-16);
+    assert_float_equal(values[17], 4.40383e-4, 1.0e-16);
+
+    // A request for more records than the block holds stops at the end
+    errno = 0;
+    assert_int_equal(parse_endf_records(data, strlen(data), 4, values), 3);
+    assert_int_equal(errno, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_xsec_nominal(void **state) {
+    (void) state;
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    xsec_t* xsec = read_xsec(filename, 23, 501);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(xsec), 9287);
+    assert_int_equal(xsec_alloc(xsec), 9287);
+    assert_float_equal(get_xsec_energy(xsec, 0), 1.0f, 1.0e-6);
+    assert_float_equal(get_xsec(xsec, 0), 1.36301e-4f, 1.0e-9);
+    assert_float_equal(get_xsec_energy(xsec, 1), 1.05924839f, 1.0e-6);
+    assert_float_equal(get_xsec(xsec, 1), 1.75146e-4f, 1.0e-9);
+    assert_float_equal(get_xsec_energy(xsec, 9286), 1.0e11f, 1.0e3);
+    assert_float_equal(get_xsec(xsec, 9286), 15.3735022f, 1.0e-5);
+    free_xsec(xsec);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_xsec_subshell(void **state) {
+    (void) state;
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    xsec_t* xsec = read_xsec(filename, 23, 534);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(xsec), 450);
+    assert_float_equal(get_xsec_energy(xsec, 0), 25520.0f, 1.0e-3);
+    assert_float_equal(get_xsec(xsec, 0), 0.0f, 1.0e-6);
+    assert_float_equal(get_xsec(xsec, 1), 8241.68669f, 1.0e-2);
+    free_xsec(xsec);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_xsec_no_section(void **state) {
+    (void) state;
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    errno = 0;
+    xsec_t* xsec = read_xsec(filename, 23, 999);
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(xsec);
+    assert_int_equal(errno, ENODATA);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_xsec_no_file(void **state) {
+    (void) state;
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    const char *filename = "../../../../data/test/no_file.endf";
+    errno = 0;
+    xsec_t* xsec = read_xsec(filename, 23, 501);
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(xsec);
+    assert_int_equal(errno, ENOENT);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_endf_index_nominal(void **state) {
+    (void) state;
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    endf_index_t* index = read_endf_index(filename);
+    assert_non_null(index);
+    assert_int_equal(endf_index_size(index), 27);
+    assert_float_equal(endf_index_za(index), 47000.0f, 1.0e-3);
+    assert_float_equal(endf_index_awr(index), 106.941f, 1.0e-3);
+    assert_int_equal(endf_index_mat(index), 4700);
+
+    const endfSection* sections = get_endf_sections(index);
+    assert_int_equal(sections[0].mf, 1);
+    assert_int_equal(sections[0].mt, 451);
+    assert_int_equal(sections[0].records, 197);
+
+    // MF23/MT534 starts on line 6629 of a file with 76 byte records
+    const endfSection* section = get_endf_section(index, 23, 534);
+    assert_non_null(section);
+    assert_int_equal(section->records, 153);
+    assert_int_equal(section->offset, 6628 * 76);
+    free_endf_index(index);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_indexed_xsec(void **state) {
+    (void) state;
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    endf_index_t* index ENDF_INDEX_GBC = read_endf_index(filename);
+    assert_non_null(index);
+    xsec_t* xsec = read_indexed_xsec(index, 23, 534);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(xsec), 450);
+    assert_float_equal(get_xsec_energy(xsec, 0), 25520.0f, 1.0e-3);
+    assert_float_equal(get_xsec(xsec, 1), 8241.68669f, 1.0e-2);
+    free_xsec(xsec);
+
+    errno = 0;
+    assert_null(get_endf_section(index, 23, 999));
+    assert_int_equal(errno, ENODATA);
+    errno = 0;
+    assert_null(read_indexed_xsec(index, 23, 999));
+    assert_int_equal(errno, ENODATA);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_endf_index_failure(void **state) {
+    (void) state;
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    endf_index_t* index = read_endf_index("../../../../data/test/fail_read_mass.endf");
+    int bad_directory = errno;
+    errno = 0;
+    endf_index_t* missing = read_endf_index("../../../../data/test/no_file.endf");
+    int no_file = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(index);
+    assert_int_equal(bad_directory, EINVAL);
+    assert_null(missing);
+    assert_int_equal(no_file, ENOENT);
+}
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    size_t heads;
+    size_t conts;
+    size_t ranges;
+    size_t pairs;
+    size_t records;
+    size_t ends;
+    size_t largest_block;
+    double first_pair[2];
+} stream_counts;
+
+static bool count_head(void* user, int mat, int mf, int mt, const double* values) {
+    (void) mat; (void) mf; (void) mt; (void) values;
+    ((stream_counts*)user)->heads++;
+    return true;
+}
+
+static bool count_cont(void* user, int mf, int mt, const double* values) {
+    (void) mf; (void) mt; (void) values;
+    ((stream_counts*)user)->conts++;
+    return true;
+}
+
+static bool count_ranges(void* user, int mf, int mt, const size_t* nbt, const int* law, size_t len) {
+    (void) mf; (void) mt; (void) nbt; (void) law;
+    ((stream_counts*)user)->ranges += len;
+    return true;
+}
+
+static bool count_pairs(void* user, int mf, int mt, const double* xy, size_t len) {
+    stream_counts* counts = user;
+    if (mf == 23 && mt == 534 && counts->first_pair[0] == 0.0) {
+        counts->first_pair[0] = xy[2];
+        counts->first_pair[1] = xy[3];
+    }
+    if (len > counts->largest_block) counts->largest_block = len;
+    counts->pairs += len;
+    return true;
+}
+
+static bool count_record(void* user, int mf, int mt, const char* record) {
+    (void) mf; (void) mt; (void) record;
+    ((stream_counts*)user)->records++;
+    return true;
+}
+
+static bool count_end(void* user, int mf, int mt) {
+    (void) mf; (void) mt;
+    ((stream_counts*)user)->ends++;
+    return true;
+}
+
+static bool stop_stream(void* user, int mat, int mf, int mt, const double* values) {
+    (void) mat; (void) mf; (void) mt; (void) values;
+    ((stream_counts*)user)->heads++;
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+void test_stream_endf_events(void **state) {
+    (void) state;
+    stream_counts counts = {0};
+    const endfHandler handler = {
+        .user = &counts,
+        .head = count_head,
+        .cont = count_cont,
+        .ranges = count_ranges,
+        .pairs = count_pairs,
+        .record = count_record,
+        .end = count_end
+    };
+    assert_true(stream_endf_file("../../../../data/test/photoat-047_Ag_000.endf", &handler));
+    // 27 sections, of which the MF1 directory holds 196 records after its HEAD
+    assert_int_equal(counts.heads, 27);
+    assert_int_equal(counts.ends, 27);
+    assert_int_equal(counts.conts, 26);
+    assert_int_equal(counts.ranges, 26);
+    assert_int_equal(counts.records, 196);
+    assert_int_equal(counts.pairs, 31723);
+    assert_int_equal(counts.largest_block, 384);
+    // The K-shell table starts with an absorption edge
+    assert_float_equal(counts.first_pair[0], 25520.0, 1.0e-3);
+    assert_float_equal(counts.first_pair[1], 8241.68669, 1.0e-4);
+}
+// --------------------------------------------------------------------------------
+
+void test_stream_endf_cancel(void **state) {
+    (void) state;
+    stream_counts counts = {0};
+    const endfHandler handler = { .user = &counts, .head = stop_stream };
+    errno = 0;
+    assert_false(stream_endf_file("../../../../data/test/photoat-047_Ag_000.endf", &handler));
+    assert_int_equal(errno, ECANCELED);
+    assert_int_equal(counts.heads, 1);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_xsec_stream(void **state) {
+    (void) state;
+    // A file holding only the K-shell section has no directory, so it is streamed
+    const char* source = "../../../../data/test/photoat-047_Ag_000.endf";
+    const char* section_file = "test_read_xsec_stream.endf";
+    const char* truncated_file = "test_read_xsec_truncated.endf";
+    const char* malformed_file = "test_read_xsec_malformed.endf";
+    FILE* in = fopen(source, "r");
+    FILE* out = fopen(section_file, "w");
+    FILE* cut = fopen(truncated_file, "w");
+    FILE* bad = fopen(malformed_file, "w");
+    assert_non_null(in);
+    assert_non_null(out);
+    assert_non_null(cut);
+    assert_non_null(bad);
+    char line[128];
+    for (size_t i = 0; fgets(line, sizeof(line), in); i++) {
+        if (i >= 6628 && i < 6628 + 154) fputs(line, out);
+        if (i >= 6628 && i < 6628 + 100) fputs(line, cut);
+        // The K-shell section behind a record too short to parse
+        if (i == 6628) fputs("1.0 2.0\n", bad);
+        if (i >= 6628 && i < 6628 + 154) fputs(line, bad);
+    }
+    fclose(in);
+    fclose(out);
+    fclose(cut);
+    fclose(bad);
+
+    xsec_t* xsec = read_xsec(section_file, 23, 534);
+    assert_non_null(xsec);
+    assert_int_equal(xsec_size(xsec), 450);
+    assert_float_equal(get_xsec_energy(xsec, 0), 25520.0f, 1.0e-3);
+    assert_float_equal(get_xsec(xsec, 1), 8241.68669f, 1.0e-2);
+    free_xsec(xsec);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        remove(section_file);
+        remove(truncated_file);
+        remove(malformed_file);
+        return;
+    }
+    errno = 0;
+    xsec_t* missing = read_xsec(section_file, 23, 501);
+    int no_section = errno;
+    errno = 0;
+    xsec_t* truncated = read_xsec(truncated_file, 23, 534);
+    int bad_section = errno;
+    errno = 0;
+    xsec_t* malformed = read_xsec(malformed_file, 23, 534);
+    int bad_record = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    remove(section_file);
+    remove(truncated_file);
+    remove(malformed_file);
+    assert_null(missing);
+    assert_int_equal(no_section, ENODATA);
+    assert_null(truncated);
+    assert_int_equal(bad_section, EINVAL);
+    // A parse failure is not reported as a missing section
+    assert_null(malformed);
+    assert_int_equal(bad_record, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_form_factor(void **state) {
+    (void) state;
+    const char *filename = "../../../../data/test/photoat-047_Ag_000.endf";
+    form_factor_t* coherent FORM_FACTOR_GBC = read_form_factor(filename, 502);
+    assert_non_null(coherent);
+    assert_int_equal(form_factor_size(coherent), 1098);
+    assert_float_equal(get_form_factor_x(coherent, 0), 0.0f, 1.0e-6);
+    assert_float_equal(interp_form_factor(coherent, 0.0f), 47.0f, 1.0e-5);
+    assert_float_equal(interp_form_factor(coherent, 0.0015f), 46.9972004f, 1.0e-4);
+
+    endf_index_t* index ENDF_INDEX_GBC = read_endf_index(filename);
+    assert_non_null(index);
+    form_factor_t* incoherent FORM_FACTOR_GBC = read_indexed_form_factor(index, 504);
+    assert_non_null(incoherent);
+    assert_int_equal(form_factor_size(incoherent), 443);
+    assert_float_equal(get_form_factor(incoherent, 442), 47.0f, 1.0e-5);
+    form_factor_t* real FORM_FACTOR_GBC = read_indexed_form_factor(index, 506);
+    assert_non_null(real);
+    assert_int_equal(form_factor_size(real), 376);
+    assert_float_equal(interp_form_factor(real, 1.0f), -47.014255f, 1.0e-4);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    form_factor_t* wrong_mt = read_indexed_form_factor(index, 501);
+    int mt_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(wrong_mt);
+    assert_int_equal(mt_error, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Copies lines [first, last) of the silver file, or the whole file when last
+ * is zero, and marks the K-shell table as log-log.
+ */
+static void write_log_log_copy(const char* file_name, size_t first, size_t last) {
+    FILE* in = fopen("../../../../data/test/photoat-047_Ag_000.endf", "r");
+    FILE* out = fopen(file_name, "w");
+    assert_non_null(in);
+    assert_non_null(out);
+    char line[128];
+    for (size_t i = 0; fgets(line, sizeof(line), in); i++) {
+        if (i < first || (last > 0 && i >= last)) continue;
+        if (i == 6630) line[21] = '5';  // INT of the single MF23/MT534 range
+        fputs(line, out);
+    }
+    fclose(in);
+    fclose(out);
+}
+// --------------------------------------------------------------------------------
+
+void test_read_xsec_interpolation(void **state) {
+    (void) state;
+    const char* full_file = "test_read_xsec_log_log.endf";
+    const char* section_file = "test_read_xsec_log_log_section.endf";
+    write_log_log_copy(full_file, 0, 0);
+    write_log_log_copy(section_file, 6628, 6628 + 154);
+    xsec_t* indexed XSEC_GBC = read_xsec(full_file, 23, 534);
+    xsec_t* streamed XSEC_GBC = read_xsec(section_file, 23, 534);
+    xsec_t* total XSEC_GBC = read_xsec(full_file, 23, 501);
+    remove(full_file);
+    remove(section_file);
+    assert_non_null(indexed);
+    assert_non_null(streamed);
+    assert_non_null(total);
+
+    // The total cross section is lin-lin throughout and is stored without ranges
+    assert_int_equal(get_xsec_interpolation(total, NULL, NULL), 0);
+    const xsec_t* tables[] = {indexed, streamed};
+    for (size_t i = 0; i < 2; i++) {
+        const size_t* nbt;
+        const int* law;
+        assert_int_equal(get_xsec_interpolation(tables[i], &nbt, &law), 1);
+        assert_int_equal(nbt[0], 450);
+        assert_int_equal(law[0], 5);
+        // Log-log between (25520, 8241.68669) and (26100, 7835.28)
+        float energy = sqrtf(25520.0f * 26100.0f);
+        assert_float_equal(interp_xsec(tables[i], energy), sqrtf(8241.68669f * 7835.28f), 1.0e-2);
+        // The table starts with a repeated energy at the edge, which takes the value above it
+        assert_float_equal(interp_xsec(tables[i], 25520.0f), 8241.68669f, 1.0e-2);
+    }
+}
 // ================================================================================
 // ================================================================================
 // eof
@@ -42,6 +42,108 @@ void test_read_amu_failure(void **state);
  * Test read_amu with bas file name
  */
 void test_read_amu_no_file(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test parse_endf_record with standard and FORTRAN shorthand notation
+ */
+void test_parse_endf_record_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test parse_endf_record with the integer fields of a control record
+ */
+void test_parse_endf_record_integers(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test parse_endf_record with blank fields
+ */
+void test_parse_endf_record_blank(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test parse_endf_record with a field that can not be decoded
+ */
+void test_parse_endf_record_invalid(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test parse_endf_records with a block of records
+ */
+void test_parse_endf_records_batch(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_xsec with the MF23/MT501 total cross section
+ */
+void test_read_xsec_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_xsec with a subshell cross section that starts at an edge
+ */
+void test_read_xsec_subshell(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_xsec with a section that does not exist
+ */
+void test_read_xsec_no_section(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_xsec with a bad file name
+ */
+void test_read_xsec_no_file(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_endf_index with the MF1/MT451 directory of the silver file
+ */
+void test_read_endf_index_nominal(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test reading a subshell cross section through an ENDF index
+ */
+void test_read_indexed_xsec(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_endf_index with a damaged directory and a bad file name
+ */
+void test_read_endf_index_failure(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the events reported by stream_endf for the silver file
+ */
+void test_stream_endf_events(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that a callback returning false stops stream_endf
+ */
+void test_stream_endf_cancel(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test read_xsec on files without a directory, which are streamed
+ */
+void test_read_xsec_stream(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test reading the MF27 form factors of the silver file
+ */
+void test_read_form_factor(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that read_xsec keeps the TAB1 interpolation ranges of a table
+ */
+void test_read_xsec_interpolation(void **state);
 // ================================================================================
 // ================================================================================
 #endif /* test_read_files_H */
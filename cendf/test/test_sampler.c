@@ -0,0 +1,204 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_sampler.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_sampler.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+// ================================================================================
+// ================================================================================
+
+static const char* OXYGEN = "../../../../data/xsec/photoat-version.VIII.1/photoat-008_O_000.endf";
+// Coherent, incoherent, pair production and photoelectric
+static const int PARTIALS[] = {502, 504, 516, 522};
+// --------------------------------------------------------------------------------
+
+/*
+ * Fills a test sampler from three tables: a constant 1, a constant 2, and a
+ * reaction with a threshold at 2.5 and an edge at 3.
+ */
+static reaction_sampler_t* edge_sampler(void) {
+    xsec_t* first XSEC_GBC = init_xsec(2);
+    xsec_t* second XSEC_GBC = init_xsec(2);
+    xsec_t* edge XSEC_GBC = init_xsec(4);
+    push_xsec(first, 1.f, 1.f);
+    push_xsec(first, 1.f, 4.f);
+    push_xsec(second, 2.f, 1.f);
+    push_xsec(second, 2.f, 4.f);
+    const float edge_energy[] = {2.5f, 3.f, 3.f, 4.f};
+    const float edge_xs[] = {0.f, 1.f, 5.f, 6.f};
+    for (int i = 0; i < 4; i++)
+        push_xsec(edge, edge_xs[i], edge_energy[i]);
+    const xsec_t* tables[] = {first, second, edge};
+    union_grid_t* grid UNION_GRID_GBC = init_union_grid(tables, 3);
+    if (!grid) return NULL;
+    return init_reaction_sampler(grid);
+}
+// --------------------------------------------------------------------------------
+
+void test_sampler_frequencies(void **state) {
+    (void) state;
+    material_t* oxygen MATERIAL_GBC = open_material(OXYGEN);
+    assert_non_null(oxygen);
+    reaction_sampler_t* sampler REACTION_SAMPLER_GBC = build_material_sampler(oxygen, 23,
+                                                                             PARTIALS, 4);
+    assert_non_null(sampler);
+    assert_int_equal(reaction_sampler_reactions(sampler), 4);
+    assert_true(reaction_sampler_size(sampler) >= xsec_size(get_material_xsec(oxygen, 23, 522)));
+
+    // Evenly spaced random numbers select each reaction in proportion to its share
+    const float energies[] = {2.0e4f, 1.0e5f, 3.0e6f, 5.0e7f};
+    const int samples = 100000;
+    for (size_t i = 0; i < 4; i++) {
+        double xs[4];
+        double total = 0.0;
+        for (size_t r = 0; r < 4; r++) {
+            const xsec_t* table = get_material_xsec(oxygen, 23, PARTIALS[r]);
+            xs[r] = 0.0;
+            if (energies[i] >= get_xsec_energy(table, 0))
+                xs[r] = interp_xsec(table, energies[i]);
+            total += xs[r];
+        }
+        int counts[4] = {0, 0, 0, 0};
+        for (int k = 0; k < samples; k++) {
+            int reaction = sample_reaction(sampler, energies[i], (k + 0.5f) / samples);
+            assert_true(reaction >= 0 && reaction < 4);
+            counts[reaction]++;
+        }
+        for (size_t r = 0; r < 4; r++)
+            assert_float_equal((double)counts[r] / samples, xs[r] / total, 1.0e-3);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_sampler_boundaries(void **state) {
+    (void) state;
+    reaction_sampler_t* sampler REACTION_SAMPLER_GBC = edge_sampler();
+    assert_non_null(sampler);
+    assert_int_equal(reaction_sampler_size(sampler), 5);
+    const float sums[] = {1.f, 3.f, 8.f};
+    assert_memory_equal(get_sampler_cumulative(sampler, 3), sums, sizeof(sums));
+
+    // Below the threshold the sums are {1, 3, 3}, and the third reaction is never selected
+    assert_int_equal(sample_reaction(sampler, 1.5f, 0.f), 0);
+    assert_int_equal(sample_reaction(sampler, 1.5f, 0.3f), 0);
+    assert_int_equal(sample_reaction(sampler, 1.5f, 1.f / 3.f + 1.0e-6f), 1);
+    assert_int_equal(sample_reaction(sampler, 1.5f, 0.999999f), 1);
+    assert_int_equal(sample_reaction(sampler, 1.5f, 1.f), 1);
+    assert_int_equal(sample_reaction(sampler, 1.5f, -1.f), 0);
+
+    // At the edge the sums above it, {1, 3, 8}, apply
+    assert_int_equal(sample_reaction(sampler, 3.f, 0.3f), 1);
+    assert_int_equal(sample_reaction(sampler, 3.f, 0.4f), 2);
+    // Halfway above the edge the sums are {1, 3, 8.5}
+    assert_int_equal(sample_reaction(sampler, 3.5f, 3.f / 8.5f - 1.0e-6f), 1);
+    assert_int_equal(sample_reaction(sampler, 3.5f, 3.f / 8.5f + 1.0e-6f), 2);
+    assert_int_equal(sample_reaction(sampler, 4.f, 1.f), 2);
+    assert_int_equal(sample_reaction(sampler, 1.f, 0.5f), 1);
+}
+// --------------------------------------------------------------------------------
+
+void test_sampler_batch(void **state) {
+    (void) state;
+    material_t* oxygen MATERIAL_GBC = open_material(OXYGEN);
+    assert_non_null(oxygen);
+    reaction_sampler_t* sampler REACTION_SAMPLER_GBC = build_material_sampler(oxygen, 23,
+                                                                             PARTIALS, 4);
+    assert_non_null(sampler);
+
+    // An odd count leaves a partial group, and log-uniform energies cover the grid
+    enum { COUNT = 1003 };
+    float energies[COUNT];
+    float random[COUNT];
+    int reaction[COUNT];
+    unsigned int seed = 12345u;
+    for (size_t i = 0; i < COUNT; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        energies[i] = powf(10.f, 1.f + 10.f * (seed >> 8) / 16777216.f);
+        seed = seed * 1664525u + 1013904223u;
+        random[i] = (seed >> 8) / 16777216.f;
+    }
+    assert_true(sample_reaction_batch(sampler, energies, random, reaction, COUNT));
+    for (size_t i = 0; i < COUNT; i++)
+        assert_int_equal(reaction[i], sample_reaction(sampler, energies[i], random[i]));
+
+    // Out of range collisions give -1 and the others are still sampled
+    energies[5] = 1.0e-3f;
+    energies[900] = 1.0e20f;
+    errno = 0;
+    assert_false(sample_reaction_batch(sampler, energies, random, reaction, COUNT));
+    assert_int_equal(errno, ERANGE);
+    assert_int_equal(reaction[5], -1);
+    assert_int_equal(reaction[900], -1);
+    assert_int_equal(reaction[6], sample_reaction(sampler, energies[6], random[6]));
+}
+// --------------------------------------------------------------------------------
+
+void test_sampler_errors(void **state) {
+    (void) state;
+    reaction_sampler_t* sampler REACTION_SAMPLER_GBC = edge_sampler();
+    assert_non_null(sampler);
+    cendfStatus status;
+    assert_int_equal(sample_reaction_status(sampler, 0.5f, 0.5f, &status), -1);
+    assert_int_equal(status, CENDF_STATUS_RANGE);
+    assert_int_equal(sample_reaction_status(NULL, 2.f, 0.5f, &status), -1);
+    assert_int_equal(status, CENDF_STATUS_INVALID);
+    errno = 0;
+    assert_int_equal(sample_reaction(sampler, 5.f, 0.5f), -1);
+    assert_int_equal(errno, ERANGE);
+    errno = 0;
+    assert_null(get_sampler_cumulative(sampler, 5));
+    assert_int_equal(errno, EINVAL);
+
+    // A reaction that is zero everywhere can not be sampled
+    xsec_t* zero XSEC_GBC = init_xsec(2);
+    push_xsec(zero, 0.f, 1.f);
+    push_xsec(zero, 0.f, 2.f);
+    const xsec_t* tables[] = {zero};
+    union_grid_t* grid UNION_GRID_GBC = init_union_grid(tables, 1);
+    reaction_sampler_t* empty REACTION_SAMPLER_GBC = init_reaction_sampler(grid);
+    assert_non_null(empty);
+    assert_int_equal(sample_reaction_status(empty, 1.5f, 0.5f, &status), -1);
+    assert_int_equal(status, CENDF_STATUS_NO_DATA);
+    int reaction;
+    float energy = 1.5f;
+    float random = 0.5f;
+    errno = 0;
+    assert_false(sample_reaction_batch(empty, &energy, &random, &reaction, 1));
+    assert_int_equal(errno, ENODATA);
+    assert_int_equal(reaction, -1);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    reaction_sampler_t* missing = init_reaction_sampler(NULL);
+    int missing_error = errno;
+    errno = 0;
+    bool batch = sample_reaction_batch(sampler, NULL, &random, &reaction, 1);
+    int batch_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(missing);
+    assert_int_equal(missing_error, EINVAL);
+    assert_false(batch);
+    assert_int_equal(batch_error, EINVAL);
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,56 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_sampler.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_sampler_H
+#define test_sampler_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/sampler.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test that reactions are sampled in proportion to their cross sections
+ */
+void test_sampler_frequencies(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the reaction selected at the boundaries of the running sums
+ */
+void test_sampler_boundaries(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that batches of collisions match single collisions
+ */
+void test_sampler_batch(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test sampler errors
+ */
+void test_sampler_errors(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_sampler_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,311 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_union_grid.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_union_grid.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+// ================================================================================
+// ================================================================================
+
+void test_union_grid_merge(void **state) {
+    (void) state;
+    xsec_t* smooth XSEC_GBC = init_xsec(4);
+    xsec_t* edge XSEC_GBC = init_xsec(4);
+    const float smooth_energy[] = {1.f, 2.f, 3.f, 4.f};
+    const float smooth_xs[] = {10.f, 20.f, 30.f, 40.f};
+    // A reaction with a threshold at 2.5 and an edge at 3
+    const float edge_energy[] = {2.5f, 3.f, 3.f, 4.f};
+    const float edge_xs[] = {0.f, 1.f, 5.f, 6.f};
+    for (int i = 0; i < 4; i++) {
+        push_xsec(smooth, smooth_xs[i], smooth_energy[i]);
+        push_xsec(edge, edge_xs[i], edge_energy[i]);
+    }
+    const xsec_t* tables[] = {smooth, edge};
+    union_grid_t* grid UNION_GRID_GBC = init_union_grid(tables, 2);
+    assert_non_null(grid);
+    assert_int_equal(union_grid_reactions(grid), 2);
+
+    // Shared energies are stored once and the edge is stored twice
+    const float energy[] = {1.f, 2.f, 2.5f, 3.f, 3.f, 4.f};
+    const float values[] = {10.f, 0.f, 20.f, 0.f, 25.f, 0.f, 30.f, 1.f, 30.f, 5.f, 40.f, 6.f};
+    assert_int_equal(union_grid_size(grid), 6);
+    assert_memory_equal(get_union_energy(grid), energy, sizeof(energy));
+    for (size_t i = 0; i < 6; i++)
+        assert_memory_equal(get_union_values(grid, i), values + 2 * i, 2 * sizeof(float));
+
+    float xs[2];
+    assert_true(interp_union_grid(grid, 1.5f, xs));
+    assert_float_equal(xs[0], 15.f, 1e-5);
+    assert_float_equal(xs[1], 0.f, 1e-6);
+    assert_true(interp_union_grid(grid, 2.75f, xs));
+    assert_float_equal(xs[0], 27.5f, 1e-5);
+    assert_float_equal(xs[1], 0.5f, 1e-6);
+    assert_true(interp_union_grid(grid, 3.5f, xs));
+    assert_float_equal(xs[0], 35.f, 1e-5);
+    assert_float_equal(xs[1], 5.5f, 1e-6);
+    assert_true(interp_union_grid(grid, 4.f, xs));
+    assert_float_equal(xs[0], 40.f, 1e-5);
+    assert_float_equal(xs[1], 6.f, 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_union_grid_material(void **state) {
+    (void) state;
+    material_t* material MATERIAL_GBC = open_material("../../../../data/test/photoat-047_Ag_000.endf");
+    assert_non_null(material);
+    // Total, coherent, incoherent, pair production and photoelectric
+    const int mt[] = {501, 502, 504, 516, 522};
+    union_grid_t* grid UNION_GRID_GBC = build_material_grid(material, 23, mt, 5);
+    assert_non_null(grid);
+    assert_int_equal(union_grid_reactions(grid), 5);
+    assert_true(union_grid_size(grid) >= xsec_size(get_material_xsec(material, 23, 501)));
+
+    // Every reaction matches its own table at energies across the grid
+    const float* energy = get_union_energy(grid);
+    const size_t len = union_grid_size(grid);
+    float xs[5];
+    for (size_t i = 0; i + 1 < len; i += 7) {
+        if (energy[i + 1] == energy[i]) continue;
+        float e = 0.5f * (energy[i] + energy[i + 1]);
+        assert_true(interp_union_grid(grid, e, xs));
+        for (size_t r = 0; r < 5; r++) {
+            const xsec_t* table = get_material_xsec(material, 23, mt[r]);
+            float expected = 0.0f;
+            if (e >= get_xsec_energy(table, 0) && e <= get_xsec_energy(table, xsec_size(table) - 1))
+                expected = interp_xsec(table, e);
+            assert_float_equal(xs[r], expected, 1.0e-5 * fabs(expected) + 1.0e-30);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void test_union_grid_errors(void **state) {
+    (void) state;
+    material_t* material MATERIAL_GBC = open_material("../../../../data/test/photoat-047_Ag_000.endf");
+    assert_non_null(material);
+    const int mt[] = {501, 999};
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    union_grid_t* missing = build_material_grid(material, 23, mt, 2);
+    int missing_error = errno;
+    errno = 0;
+    union_grid_t* empty = init_union_grid(NULL, 0);
+    int empty_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(missing);
+    assert_int_equal(missing_error, ENODATA);
+    assert_null(empty);
+    assert_int_equal(empty_error, EINVAL);
+
+    union_grid_t* grid UNION_GRID_GBC = build_material_grid(material, 23, mt, 1);
+    assert_non_null(grid);
+    float xs[1];
+    errno = 0;
+    assert_false(interp_union_grid(grid, 0.1f, xs));
+    assert_int_equal(errno, ERANGE);
+    errno = 0;
+    assert_null(get_union_values(grid, union_grid_size(grid)));
+    assert_int_equal(errno, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_union_grid_combine(void **state) {
+    (void) state;
+    xsec_t* first XSEC_GBC = init_xsec(3);
+    xsec_t* second XSEC_GBC = init_xsec(3);
+    push_xsec(first, 1.f, 1.f);
+    push_xsec(first, 2.f, 2.f);
+    push_xsec(first, 3.f, 3.f);
+    push_xsec(second, 10.f, 2.f);
+    push_xsec(second, 20.f, 2.f);
+    push_xsec(second, 30.f, 3.f);
+    const xsec_t* tables[] = {first, second};
+    union_grid_t* grid UNION_GRID_GBC = init_union_grid(tables, 2);
+    assert_non_null(grid);
+
+    // The sum and the difference of the two reactions
+    const double weights[] = {1.0, 1.0, 2.0, -0.5};
+    union_grid_t* combined UNION_GRID_GBC = combine_union_grid(grid, weights, 2);
+    assert_non_null(combined);
+    assert_int_equal(union_grid_reactions(combined), 2);
+    assert_int_equal(union_grid_size(combined), union_grid_size(grid));
+    assert_memory_equal(get_union_energy(combined), get_union_energy(grid),
+                        union_grid_size(grid) * sizeof(float));
+
+    // The rows of the grid are combined, so the second table rises from zero
+    // below its first energy as it does on the grid, and its edge at 2 is kept
+    float xs[2];
+    float source[2];
+    assert_true(interp_union_grid(combined, 1.5f, xs));
+    assert_true(interp_union_grid(grid, 1.5f, source));
+    assert_float_equal(xs[0], source[0] + source[1], 1e-6);
+    assert_float_equal(xs[1], 2.f * source[0] - 0.5f * source[1], 1e-6);
+    assert_true(interp_union_grid(combined, 2.f, xs));
+    assert_float_equal(xs[0], 22.f, 1e-6);
+    assert_float_equal(xs[1], -6.f, 1e-6);
+    assert_true(interp_union_grid(combined, 2.5f, xs));
+    assert_float_equal(xs[0], 27.5f, 1e-5);
+    assert_float_equal(xs[1], -7.5f, 1e-5);
+
+    FILE *original_stderr = stderr;
+    stderr = fopen("/dev/null", "w");
+    if (!stderr) {
+        fprintf(original_stderr, "Failed to redirect stderr\n");
+        return;
+    }
+    errno = 0;
+    union_grid_t* empty = combine_union_grid(grid, weights, 0);
+    int empty_error = errno;
+    fclose(stderr);
+    stderr = original_stderr;
+    assert_null(empty);
+    assert_int_equal(empty_error, EINVAL);
+}
+// --------------------------------------------------------------------------------
+
+void test_union_grid_batch(void **state) {
+    (void) state;
+    material_t* material MATERIAL_GBC = open_material("../../../../data/test/photoat-047_Ag_000.endf");
+    assert_non_null(material);
+    const int mt[] = {501, 502, 504, 516, 522};
+    union_grid_t* grid UNION_GRID_GBC = build_material_grid(material, 23, mt, 5);
+    assert_non_null(grid);
+
+    // Grid energies, edges included, and points between them, in a count
+    // that leaves a partial group
+    const float* energy = get_union_energy(grid);
+    const size_t len = union_grid_size(grid);
+    enum { COUNT = 1001 };
+    float energies[COUNT];
+    float xs[COUNT * 5];
+    for (size_t i = 0; i < COUNT; i++) {
+        const size_t j = (i * 7919) % len;
+        energies[i] = (i % 2 == 0 || j + 1 == len) ? energy[j]
+                                                    : 0.5f * (energy[j] + energy[j + 1]);
+    }
+    assert_true(interp_union_grid_batch(grid, energies, xs, COUNT));
+    float expected[5];
+    for (size_t i = 0; i < COUNT; i++) {
+        assert_true(interp_union_grid(grid, energies[i], expected));
+        assert_memory_equal(xs + 5 * i, expected, sizeof(expected));
+    }
+
+    // Energies outside of the grid give rows of -1 and the others are still evaluated
+    energies[3] = 0.5f * energy[0];
+    energies[1000] = 2.0f * energy[len - 1];
+    errno = 0;
+    assert_false(interp_union_grid_batch(grid, energies, xs, COUNT));
+    assert_int_equal(errno, ERANGE);
+    for (size_t r = 0; r < 5; r++) {
+        assert_float_equal(xs[5 * 3 + r], -1.f, 1e-6);
+        assert_float_equal(xs[5 * 1000 + r], -1.f, 1e-6);
+    }
+    assert_true(interp_union_grid(grid, energies[4], expected));
+    assert_memory_equal(xs + 5 * 4, expected, sizeof(expected));
+}
+// --------------------------------------------------------------------------------
+
+void test_global_grid_outside(void **state) {
+    (void) state;
+    xsec_t* wide XSEC_GBC = init_xsec(3);
+    xsec_t* narrow XSEC_GBC = init_xsec(2);
+    push_xsec(wide, 1.f, 1.f);
+    push_xsec(wide, 2.f, 2.f);
+    push_xsec(wide, 4.f, 4.f);
+    push_xsec(narrow, 10.f, 2.f);
+    push_xsec(narrow, 20.f, 3.f);
+    const xsec_t* wide_table[] = {wide};
+    const xsec_t* narrow_table[] = {narrow};
+    union_grid_t* first UNION_GRID_GBC = init_union_grid(wide_table, 1);
+    union_grid_t* second UNION_GRID_GBC = init_union_grid(narrow_table, 1);
+    const union_grid_t* grids[] = {first, second};
+    global_grid_t* grid GLOBAL_GRID_GBC = init_global_grid(grids, 2);
+    assert_non_null(grid);
+    assert_int_equal(global_grid_size(grid), 4);
+    assert_int_equal(global_grid_materials(grid), 2);
+    assert_int_equal(global_grid_values(grid), 2);
+    assert_int_equal(global_grid_offset(grid, 1), 1);
+
+    float xs[2];
+    assert_true(interp_global_grid(grid, 1.5f, xs));
+    assert_float_equal(xs[0], 1.5f, 1e-6);
+    assert_float_equal(xs[1], 0.f, 1e-6);
+    assert_true(interp_global_grid(grid, 2.5f, xs));
+    assert_float_equal(xs[0], 2.5f, 1e-6);
+    assert_float_equal(xs[1], 15.f, 1e-6);
+    assert_true(interp_global_grid(grid, 3.f, xs));
+    assert_float_equal(xs[1], 20.f, 1e-6);
+    assert_true(interp_global_grid(grid, 3.5f, xs));
+    assert_float_equal(xs[0], 3.5f, 1e-6);
+    assert_float_equal(xs[1], 0.f, 1e-6);
+    assert_true(interp_global_grid(grid, 4.f, xs));
+    assert_float_equal(xs[0], 4.f, 1e-6);
+    errno = 0;
+    assert_false(interp_global_grid(grid, 4.5f, xs));
+    assert_int_equal(errno, ERANGE);
+}
+// --------------------------------------------------------------------------------
+
+void test_global_grid_library(void **state) {
+    (void) state;
+    const char* files[] = {
+        "../../../../data/xsec/photoat-version.VIII.1/photoat-001_H_000.endf",
+        "../../../../data/xsec/photoat-version.VIII.1/photoat-008_O_000.endf",
+        "../../../../data/xsec/photoat-version.VIII.1/photoat-047_Ag_000.endf",
+        "../../../../data/xsec/photoat-version.VIII.1/photoat-082_Pb_000.endf"
+    };
+    const int mt[] = {501, 502, 504, 516, 522};
+    material_t* materials[4] = {NULL};
+    union_grid_t* grids[4] = {NULL};
+    for (size_t m = 0; m < 4; m++) {
+        materials[m] = open_material(files[m]);
+        assert_non_null(materials[m]);
+        grids[m] = build_material_grid(materials[m], 23, mt, 5);
+        assert_non_null(grids[m]);
+    }
+    global_grid_t* grid = init_global_grid((const union_grid_t* const*)grids, 4);
+    assert_non_null(grid);
+    assert_int_equal(global_grid_values(grid), 20);
+    assert_true(global_grid_size(grid) >= union_grid_size(grids[3]));
+
+    // One global search gives the same values as a search on each material grid
+    const float* energy = get_union_energy(grids[2]);
+    const size_t len = union_grid_size(grids[2]);
+    float xs[20];
+    float expected[5];
+    for (size_t i = 0; i + 1 < len; i += 5) {
+        float e = 0.5f * (energy[i] + energy[i + 1]);
+        assert_true(interp_global_grid(grid, e, xs));
+        for (size_t m = 0; m < 4; m++) {
+            assert_true(interp_union_grid(grids[m], e, expected));
+            assert_memory_equal(xs + global_grid_offset(grid, m), expected, sizeof(expected));
+        }
+    }
+    free_global_grid(grid);
+    for (size_t m = 0; m < 4; m++) {
+        free_union_grid(grids[m]);
+        free_material(materials[m]);
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,74 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_union_grid.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_union_grid_H
+#define test_union_grid_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/union_grid.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test the merge of overlapping tables with a threshold and an edge
+ */
+void test_union_grid_merge(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test a unionized grid of the silver reactions against interp_xsec
+ */
+void test_union_grid_material(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test unionized grid errors
+ */
+void test_union_grid_errors(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test linear combinations of the reactions of a grid
+ */
+void test_union_grid_combine(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test that a batch of energies matches single lookups on a material grid
+ */
+void test_union_grid_batch(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test a global grid over materials that cover different energy ranges
+ */
+void test_global_grid_outside(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test a global grid over four elements against their material grids
+ */
+void test_global_grid_library(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_union_grid_H */
+// ================================================================================
+// ================================================================================
+// eof
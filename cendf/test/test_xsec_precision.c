@@ -0,0 +1,185 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_xsec_precision.c
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "test_xsec_precision.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+// ================================================================================
+// ================================================================================
+
+void test_xsec_precision_resolution(void **state) {
+    (void) state;
+    // Floats near 1e11 are 8192 eV apart, so these points share one float
+    const double energy[] = {1.0e11, 1.0e11 + 1000.0, 1.0e11 + 2000.0};
+    const double xs64[] = {1.0, 2.0, 3.0};
+    const float xs32[] = {1.f, 2.f, 3.f};
+    assert_true((float)energy[0] == (float)energy[1]);
+
+    xsec_f64_t* f64 XSEC_F64_GBC = init_xsec_f64_from(energy, xs64, 3);
+    xsec_mixed_t* mixed XSEC_MIXED_GBC = init_xsec_mixed_from(energy, xs32, 3);
+    xsec_f32_t* f32 XSEC_F32_GBC = init_xsec_f32(3);
+    assert_non_null(f64);
+    assert_non_null(mixed);
+    assert_non_null(f32);
+    for (int i = 0; i < 3; i++)
+        assert_true(push_xsec_f32(f32, xs32[i], (float)energy[i]));
+    assert_int_equal(xsec_f64_size(f64), 3);
+    assert_int_equal(xsec_mixed_size(mixed), 3);
+
+    // Double energies keep both intervals
+    size_t index;
+    assert_true(find_xsec_f64_interval(f64, 1.0e11 + 500.0, &index));
+    assert_int_equal(index, 0);
+    assert_true(find_xsec_mixed_interval(mixed, 1.0e11 + 1500.0, &index));
+    assert_int_equal(index, 1);
+    assert_float_equal(interp_xsec_f64(f64, 1.0e11 + 500.0), 1.5, 1e-12);
+    assert_float_equal(interp_xsec_f64(f64, 1.0e11 + 1500.0), 2.5, 1e-12);
+    assert_float_equal(interp_xsec_mixed(mixed, 1.0e11 + 500.0), 1.5f, 1e-6);
+    assert_float_equal(interp_xsec_mixed(mixed, 1.0e11 + 1500.0), 2.5f, 1e-6);
+
+    // In float the points collapse onto one energy, and the intervals with them
+    const float* x = get_xsec_f32_enArray(f32);
+    assert_true(x[0] == x[1]);
+    assert_true(x[1] == x[2]);
+    assert_float_equal(interp_xsec_f32(f32, 1.0e11f), 3.f, 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_precision_laws(void **state) {
+    (void) state;
+    // A histogram interval followed by two log-log intervals
+    const double energy[] = {1.0, 2.0, 4.0, 8.0};
+    const double xs[] = {3.0, 3.0, 4.0, 16.0};
+    xsec_f64_t* table XSEC_F64_GBC = init_xsec_f64_from(energy, xs, 4);
+    assert_non_null(table);
+    const size_t nbt[] = {2, 4};
+    const int law[] = {1, 5};
+    assert_true(set_xsec_f64_interpolation(table, nbt, law, 2));
+    assert_float_equal(interp_xsec_f64(table, 1.5), 3.0, 1e-12);
+    assert_float_equal(interp_xsec_f64(table, 3.0), 3.0 * pow(1.5, log(4.0 / 3.0) / log(2.0)), 1e-12);
+    assert_float_equal(interp_xsec_f64(table, 6.0), 9.0, 1e-12);
+    assert_float_equal(interp_xsec_f64(table, 8.0), 16.0, 1e-12);
+
+    // The ranges become lin-lin ranges again
+    const size_t lin_nbt[] = {4};
+    const int lin_law[] = {2};
+    assert_true(set_xsec_f64_interpolation(table, lin_nbt, lin_law, 1));
+    assert_float_equal(interp_xsec_f64(table, 6.0), 10.0, 1e-12);
+
+    // An edge takes the value above it, in the middle and at the end of a table
+    const double edge_energy[] = {1.0, 2.0, 2.0, 3.0};
+    const float edge_xs[] = {1.f, 2.f, 5.f, 6.f};
+    xsec_mixed_t* edge XSEC_MIXED_GBC = init_xsec_mixed_from(edge_energy, edge_xs, 4);
+    assert_non_null(edge);
+    assert_float_equal(interp_xsec_mixed(edge, 1.5), 1.5f, 1e-6);
+    assert_float_equal(interp_xsec_mixed(edge, 2.0), 5.f, 1e-6);
+    assert_float_equal(interp_xsec_mixed(edge, 2.5), 5.5f, 1e-6);
+    xsec_mixed_t* last XSEC_MIXED_GBC = init_xsec_mixed_from(edge_energy, edge_xs, 3);
+    assert_float_equal(interp_xsec_mixed(last, 2.0), 5.f, 1e-6);
+
+    // Every point of a longer table is reproduced
+    xsec_f32_t* wide XSEC_F32_GBC = init_xsec_f32(1);
+    for (int i = 0; i < 1000; i++)
+        assert_true(push_xsec_f32(wide, (float)(i % 7), (float)i));
+    for (int i = 0; i < 1000; i++)
+        assert_float_equal(interp_xsec_f32(wide, (float)i), (float)(i % 7), 1e-6);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_precision_errors(void **state) {
+    (void) state;
+    const double energy[] = {1.0, 2.0, 3.0};
+    const double xs[] = {1.0, 2.0, 3.0};
+    const double descending[] = {1.0, 3.0, 2.0};
+    errno = 0;
+    assert_null(init_xsec_f64_from(descending, xs, 3));
+    assert_int_equal(errno, EINVAL);
+    assert_null(init_xsec_f64_from(NULL, xs, 3));
+
+    xsec_f64_t* table XSEC_F64_GBC = init_xsec_f64_from(energy, xs, 3);
+    assert_non_null(table);
+    errno = 0;
+    assert_false(push_xsec_f64(table, 4.0, 2.5));
+    assert_int_equal(errno, EINVAL);
+    errno = 0;
+    assert_float_equal(interp_xsec_f64(table, 3.5), -1.0, 1e-12);
+    assert_int_equal(errno, ERANGE);
+    size_t index;
+    assert_false(find_xsec_f64_interval(table, 0.5, &index));
+
+    // Ranges must end at the last point, and fix the number of points
+    const size_t bad_nbt[] = {2};
+    const size_t nbt[] = {3};
+    const int law[] = {5};
+    assert_false(set_xsec_f64_interpolation(table, bad_nbt, law, 1));
+    assert_true(set_xsec_f64_interpolation(table, nbt, law, 1));
+    errno = 0;
+    assert_false(push_xsec_f64(table, 4.0, 4.0));
+    assert_int_equal(errno, EPERM);
+
+    xsec_f32_t* empty XSEC_F32_GBC = init_xsec_f32(0);
+    errno = 0;
+    assert_float_equal(interp_xsec_f32(empty, 1.f), -1.f, 1e-6);
+    assert_int_equal(errno, EINVAL);
+    assert_int_equal(xsec_mixed_size(NULL), 0);
+}
+// --------------------------------------------------------------------------------
+
+void test_xsec_precision_read(void **state) {
+    (void) state;
+    endf_index_t* index ENDF_INDEX_GBC = read_endf_index("../../../../data/test/photoat-047_Ag_000.endf");
+    assert_non_null(index);
+    xsec_t* reference XSEC_GBC = read_indexed_xsec(index, 23, 501);
+    xsec_f32_t* f32 XSEC_F32_GBC = read_indexed_xsec_f32(index, 23, 501);
+    xsec_f64_t* f64 XSEC_F64_GBC = read_indexed_xsec_f64(index, 23, 501);
+    xsec_mixed_t* mixed XSEC_MIXED_GBC = read_indexed_xsec_mixed(index, 23, 501);
+    assert_non_null(reference);
+    assert_non_null(f32);
+    assert_non_null(f64);
+    assert_non_null(mixed);
+    const size_t len = xsec_size(reference);
+    assert_int_equal(xsec_f32_size(f32), len);
+    assert_int_equal(xsec_f64_size(f64), len);
+    assert_int_equal(xsec_mixed_size(mixed), len);
+
+    // The float table holds the same data as xsec_t, and the others round to it
+    const float* x = get_xsec_enArray(reference);
+    const float* y = get_xsec_xsArray(reference);
+    assert_memory_equal(get_xsec_f32_enArray(f32), x, len * sizeof(float));
+    assert_memory_equal(get_xsec_f32_xsArray(f32), y, len * sizeof(float));
+    const double* x64 = get_xsec_f64_enArray(f64);
+    for (size_t i = 0; i < len; i++) {
+        assert_true((float)x64[i] == x[i]);
+        assert_true((float)get_xsec_f64_xsArray(f64)[i] == y[i]);
+        assert_true(get_xsec_mixed_enArray(mixed)[i] == x64[i]);
+    }
+
+    // Lookups between the points agree to the precision of the float table
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (!(x64[i + 1] > x64[i])) continue;
+        const double energy = 0.5 * (x64[i] + x64[i + 1]);
+        const double expected = interp_xsec_f64(f64, energy);
+        assert_float_equal(interp_xsec_mixed(mixed, energy), expected, 1e-5 * expected);
+        assert_float_equal(interp_xsec_f32(f32, (float)energy),
+                           interp_xsec(reference, (float)energy), 1e-5 * expected);
+        assert_float_equal(interp_xsec_f32(f32, (float)energy), expected, 1e-4 * expected);
+    }
+    assert_null(read_indexed_xsec_f64(index, 23, 999));
+    assert_int_equal(errno, ENODATA);
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,57 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_xsec_precision.h
+// - Purpose: Describe the file purpose here
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#ifndef test_xsec_precision_H
+#define test_xsec_precision_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include "../include/read_file.h"
+#include "../include/xsec_precision.h"
+// ================================================================================
+// ================================================================================
+
+/*
+ * Test energies near 1e11 eV that are closer together than a float can resolve
+ */
+void test_xsec_precision_resolution(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the interpolation laws and edges of the double precision table
+ */
+void test_xsec_precision_laws(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test errors of the precision-generic tables
+ */
+void test_xsec_precision_errors(void **state);
+// --------------------------------------------------------------------------------
+
+/*
+ * Test the silver tables read in every precision against read_indexed_xsec
+ */
+void test_xsec_precision_read(void **state);
+// ================================================================================
+// ================================================================================
+#endif /* test_xsec_precision_H */
+// ================================================================================
+// ================================================================================
+// eof
@@ -21,6 +21,14 @@
 
 #include "test_read_files.h"
 #include "test_dstructures.h"
+#include "test_library.h"
+#include "test_cache.h"
+#include "test_material.h"
+#include "test_union_grid.h"
+#include "test_xsec_precision.h"
+#include "test_diagnostics.h"
+#include "test_mixture.h"
+#include "test_sampler.h"
 // ================================================================================
 // ================================================================================
 // Begin code
@@ -29,6 +37,23 @@ const struct CMUnitTest test_read_files[] = {
 	cmocka_unit_test(test_read_amu_nominal),
     cmocka_unit_test(test_read_amu_failure),
     cmocka_unit_test(test_read_amu_no_file),
+    cmocka_unit_test(test_parse_endf_record_nominal),
+    cmocka_unit_test(test_parse_endf_record_integers),
+    cmocka_unit_test(test_parse_endf_record_blank),
+    cmocka_unit_test(test_parse_endf_record_invalid),
+    cmocka_unit_test(test_parse_endf_records_batch),
+    cmocka_unit_test(test_read_xsec_nominal),
+    cmocka_unit_test(test_read_xsec_subshell),
+    cmocka_unit_test(test_read_xsec_no_section),
+    cmocka_unit_test(test_read_xsec_no_file),
+    cmocka_unit_test(test_read_endf_index_nominal),
+    cmocka_unit_test(test_read_indexed_xsec),
+    cmocka_unit_test(test_read_endf_index_failure),
+    cmocka_unit_test(test_stream_endf_events),
+    cmocka_unit_test(test_stream_endf_cancel),
+    cmocka_unit_test(test_read_xsec_stream),
+    cmocka_unit_test(test_read_form_factor),
+    cmocka_unit_test(test_read_xsec_interpolation),
 };
 // -------------------------------------------------------------------------------- 
 
@@ -38,6 +63,7 @@ const struct CMUnitTest test_data_structures[] = {
         cmocka_unit_test(test_init_xsec_gbc),
     #endif
     cmocka_unit_test(test_push_xsec),
+    cmocka_unit_test(test_init_xsec_view),
     cmocka_unit_test(test_get_xsec_data),
     cmocka_unit_test(test_xsec_resize),
     cmocka_unit_test(test_xsec_size_alloc),
@@ -49,6 +75,16 @@ const struct CMUnitTest test_data_structures[] = {
     cmocka_unit_test(test_interp_xsec_single_point),
     cmocka_unit_test(test_interp_xsec_null_pointer),
     cmocka_unit_test(test_interp_xsec_bounds),
+    cmocka_unit_test(test_xsec_interpolation_laws),
+    cmocka_unit_test(test_xsec_log_bins),
+    cmocka_unit_test(test_xsec_search_tree),
+    cmocka_unit_test(test_pack_xsec),
+    cmocka_unit_test(test_xsec_search_consistency),
+    cmocka_unit_test(test_interp_xsec_hint),
+    cmocka_unit_test(test_interp_xsec_batch),
+    cmocka_unit_test(test_interp_xsec_sorted),
+    cmocka_unit_test(test_thin_xsec),
+    cmocka_unit_test(test_interp_form_factor),
     cmocka_unit_test(test_init_string),
     cmocka_unit_test(test_init_string_strcmp),
     #if defined(__GNUC__) || defined(__clang__)
@@ -100,6 +136,77 @@ const struct CMUnitTest test_data_structures[] = {
     cmocka_unit_test(test_fetch_element_fusion_heat),
     cmocka_unit_test(test_fetch_element_electron_config)
 };
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_library[] = {
+    cmocka_unit_test(test_library_index_nominal),
+    cmocka_unit_test(test_library_index_skips_bad_file),
+    cmocka_unit_test(test_library_index_stale),
+    cmocka_unit_test(test_library_index_failure),
+    cmocka_unit_test(test_load_xsec_library_nominal),
+    cmocka_unit_test(test_load_xsec_library_bad_table),
+    cmocka_unit_test(test_load_xsec_library_errors),
+    cmocka_unit_test(test_load_xsec_elements),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_cache[] = {
+    cmocka_unit_test(test_xsec_cache_nominal),
+    cmocka_unit_test(test_xsec_cache_corrupt),
+    cmocka_unit_test(test_xsec_cache_interpolation),
+    cmocka_unit_test(test_xsec_cache_ranges),
+    cmocka_unit_test(test_xsec_cache_failure),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_material[] = {
+    cmocka_unit_test(test_material_lazy_load),
+    cmocka_unit_test(test_material_errors),
+    cmocka_unit_test(test_material_threads),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_union_grid[] = {
+    cmocka_unit_test(test_union_grid_merge),
+    cmocka_unit_test(test_union_grid_material),
+    cmocka_unit_test(test_union_grid_errors),
+    cmocka_unit_test(test_union_grid_combine),
+    cmocka_unit_test(test_union_grid_batch),
+    cmocka_unit_test(test_global_grid_outside),
+    cmocka_unit_test(test_global_grid_library),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_xsec_precision[] = {
+    cmocka_unit_test(test_xsec_precision_resolution),
+    cmocka_unit_test(test_xsec_precision_laws),
+    cmocka_unit_test(test_xsec_precision_errors),
+    cmocka_unit_test(test_xsec_precision_read),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_diagnostics[] = {
+    cmocka_unit_test(test_diagnostics_last_error),
+    cmocka_unit_test(test_diagnostics_threads),
+    cmocka_unit_test(test_diagnostics_handler),
+    cmocka_unit_test(test_diagnostics_rate_limit),
+    cmocka_unit_test(test_diagnostics_status),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_mixture[] = {
+    cmocka_unit_test(test_mixture_water),
+    cmocka_unit_test(test_mixture_basis),
+    cmocka_unit_test(test_mixture_errors),
+};
+// -------------------------------------------------------------------------------- 
+
+const struct CMUnitTest test_sampler[] = {
+    cmocka_unit_test(test_sampler_frequencies),
+    cmocka_unit_test(test_sampler_boundaries),
+    cmocka_unit_test(test_sampler_batch),
+    cmocka_unit_test(test_sampler_errors),
+};
 // ================================================================================ 
 // ================================================================================ 
 
@@ -110,6 +217,30 @@ int main(int argc, const char * argv[]) {
     if (status != 0) 
         return status;
     status = cmocka_run_group_tests(test_data_structures, NULL, NULL); 
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_library, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_cache, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_material, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_union_grid, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_xsec_precision, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_diagnostics, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_mixture, NULL, NULL);
+    if (status != 0) 
+        return status;
+    status = cmocka_run_group_tests(test_sampler, NULL, NULL);
 	return status;
 }
 // ================================================================================
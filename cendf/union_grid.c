@@ -0,0 +1,580 @@
+// ================================================================================
+// ================================================================================
+// - File:    union_grid.c
+// - Purpose: Unionized energy grids for materials and sets of materials
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/union_grid.h"
+
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+// The number of searches that advance in step in a batch
+#define UNION_GRID_GROUP 8
+// ================================================================================
+// ================================================================================
+// UNIONIZED GRID
+
+struct union_grid_t {
+    float* energy;
+    float* values;      // len rows of num_reactions values
+    size_t len;
+    size_t num_reactions;
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * State of the k-way merge of the energy arrays.  `cursor[t]` is the next
+ * point of table t that has not been placed on the grid, and `count[t]` is
+ * the number of copies of the current grid energy in table t.
+ */
+typedef struct {
+    const xsec_t* const* tables;
+    const float** energy;
+    size_t* length;
+    size_t* cursor;
+    size_t* count;
+    size_t num_tables;
+} grid_merge;
+// --------------------------------------------------------------------------------
+
+/*
+ * Finds the smallest energy that has not been placed on the grid and the
+ * number of times it must be repeated, which is the largest number of copies
+ * of it in any one table.  Returns 0 once every table is exhausted.
+ */
+static size_t next_energy(grid_merge* merge, float* energy) {
+    bool found = false;
+    for (size_t t = 0; t < merge->num_tables; t++) {
+        if (merge->cursor[t] < merge->length[t]) {
+            float e = merge->energy[t][merge->cursor[t]];
+            if (!found || e < *energy) *energy = e;
+            found = true;
+        }
+    }
+    if (!found) return 0;
+
+    size_t copies = 0;
+    for (size_t t = 0; t < merge->num_tables; t++) {
+        size_t count = 0;
+        while (merge->cursor[t] + count < merge->length[t] &&
+               merge->energy[t][merge->cursor[t] + count] == *energy)
+            count++;
+        merge->count[t] = count;
+        if (count > copies) copies = count;
+    }
+    return copies;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Value of table t at copy `copy` of the current grid energy.  Tables are
+ * zero outside of their own energy range.
+ */
+static float table_value(const grid_merge* merge, size_t t, size_t copy, float energy) {
+    const size_t cursor = merge->cursor[t];
+    const size_t count = merge->count[t];
+    if (count > 0) {
+        size_t point = cursor + (copy < count ? copy : count - 1);
+        return get_xsec(merge->tables[t], point);
+    }
+    if (cursor == 0 || cursor == merge->length[t]) return 0.0f;
+    // The energy lies strictly inside the table, so the lookup can not fail
+    return interp_xsec(merge->tables[t], energy);
+}
+// --------------------------------------------------------------------------------
+
+static void advance_merge(grid_merge* merge) {
+    for (size_t t = 0; t < merge->num_tables; t++)
+        merge->cursor[t] += merge->count[t];
+}
+// --------------------------------------------------------------------------------
+
+union_grid_t* init_union_grid(const xsec_t* const* tables, size_t num_tables) {
+    if (!tables || num_tables == 0) {
+        CENDF_REPORT(EINVAL, "Invalid tables passed to init_union_grid");
+        return NULL;
+    }
+    for (size_t t = 0; t < num_tables; t++) {
+        if (!tables[t] || xsec_size(tables[t]) == 0) {
+            CENDF_REPORT(EINVAL, "Empty table %zu passed to init_union_grid", t);
+            return NULL;
+        }
+    }
+
+    grid_merge merge = { .tables = tables, .num_tables = num_tables };
+    merge.energy = malloc(num_tables * sizeof(float*));
+    merge.length = malloc(num_tables * sizeof(size_t));
+    merge.cursor = calloc(num_tables, sizeof(size_t));
+    merge.count = calloc(num_tables, sizeof(size_t));
+    union_grid_t* grid = calloc(1, sizeof(union_grid_t));
+    bool ok = merge.energy && merge.length && merge.cursor && merge.count && grid;
+    for (size_t t = 0; ok && t < num_tables; t++) {
+        merge.energy[t] = get_xsec_enArray(tables[t]);
+        merge.length[t] = xsec_size(tables[t]);
+    }
+
+    // The first pass counts the grid energies and the second fills the grid
+    size_t len = 0;
+    float energy = 0.0f;
+    if (ok) {
+        for (size_t copies; (copies = next_energy(&merge, &energy)) > 0; advance_merge(&merge))
+            len += copies;
+        memset(merge.cursor, 0, num_tables * sizeof(size_t));
+        grid->energy = malloc(len * sizeof(float));
+        grid->values = malloc(len * num_tables * sizeof(float));
+        ok = grid->energy && grid->values;
+    }
+    if (ok) {
+        size_t row = 0;
+        for (size_t copies; (copies = next_energy(&merge, &energy)) > 0; advance_merge(&merge)) {
+            for (size_t copy = 0; copy < copies; copy++, row++) {
+                grid->energy[row] = energy;
+                float* values = grid->values + row * num_tables;
+                for (size_t t = 0; t < num_tables; t++)
+                    values[t] = table_value(&merge, t, copy, energy);
+            }
+        }
+        grid->len = len;
+        grid->num_reactions = num_tables;
+    }
+
+    free(merge.energy);
+    free(merge.length);
+    free(merge.cursor);
+    free(merge.count);
+    if (!ok) {
+        free_union_grid(grid);
+        CENDF_REPORT(ENOMEM, "union_grid_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    return grid;
+}
+// --------------------------------------------------------------------------------
+
+union_grid_t* build_material_grid(material_t* material, int mf, const int* mt, size_t num_mt) {
+    if (!material || !mt || num_mt == 0) {
+        CENDF_REPORT(EINVAL, "Invalid arguments passed to build_material_grid");
+        return NULL;
+    }
+    const xsec_t** tables = malloc(num_mt * sizeof(xsec_t*));
+    if (!tables) {
+        CENDF_REPORT(ENOMEM, "union_grid_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    for (size_t i = 0; i < num_mt; i++) {
+        tables[i] = get_material_xsec(material, mf, mt[i]);
+        if (!tables[i]) {
+            int error = errno;
+            free(tables);
+            CENDF_REPORT(error, "Unable to read MF%d/MT%d for a unionized grid", mf, mt[i]);
+            return NULL;
+        }
+    }
+    union_grid_t* grid = init_union_grid(tables, num_mt);
+    free(tables);
+    return grid;
+}
+// --------------------------------------------------------------------------------
+
+union_grid_t* combine_union_grid(const union_grid_t* grid, const double* weights,
+                                 size_t num_reactions) {
+    if (!grid || !weights || num_reactions == 0) {
+        CENDF_REPORT(EINVAL, "Invalid arguments passed to combine_union_grid");
+        return NULL;
+    }
+    union_grid_t* combined = calloc(1, sizeof(union_grid_t));
+    if (combined) {
+        combined->energy = malloc(grid->len * sizeof(float));
+        combined->values = malloc(grid->len * num_reactions * sizeof(float));
+    }
+    if (!combined || !combined->energy || !combined->values) {
+        free_union_grid(combined);
+        CENDF_REPORT(ENOMEM, "union_grid_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    memcpy(combined->energy, grid->energy, grid->len * sizeof(float));
+    const size_t num_tables = grid->num_reactions;
+    for (size_t row = 0; row < grid->len; row++) {
+        const float* values = grid->values + row * num_tables;
+        float* sums = combined->values + row * num_reactions;
+        for (size_t r = 0; r < num_reactions; r++) {
+            const double* weight = weights + r * num_tables;
+            double sum = 0.0;
+            for (size_t t = 0; t < num_tables; t++)
+                sum += weight[t] * values[t];
+            sums[r] = (float)sum;
+        }
+    }
+    combined->len = grid->len;
+    combined->num_reactions = num_reactions;
+    return combined;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Interpolates every reaction of a grid in the interval that starts at grid
+ * point `low`.  The last point of the grid is returned as it is.
+ */
+static inline void interp_row(const union_grid_t* grid, size_t low, float energy, float* xs) {
+    const size_t num_reactions = grid->num_reactions;
+    const float* lower = grid->values + low * num_reactions;
+    if (low + 1 == grid->len) {
+        memcpy(xs, lower, num_reactions * sizeof(float));
+        return;
+    }
+    const float width = grid->energy[low + 1] - grid->energy[low];
+    const float weight = width > 0.0f ? (energy - grid->energy[low]) / width : 0.0f;
+    const float* upper = lower + num_reactions;
+    for (size_t r = 0; r < num_reactions; r++)
+        xs[r] = lower[r] + (upper[r] - lower[r]) * weight;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_union_grid_status(const union_grid_t* grid, float energy, float* xs,
+                              cendfStatus* status) {
+    if (!grid || !xs) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return false;
+    }
+    const float* grid_energy = grid->energy;
+    const size_t len = grid->len;
+    if (!(energy >= grid_energy[0] && energy <= grid_energy[len - 1])) {
+        cendf_set_status(status, CENDF_STATUS_RANGE);
+        return false;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+    if (len == 1) {
+        interp_row(grid, 0, energy, xs);
+        return true;
+    }
+
+    // Find the last interval whose lower energy is not above `energy`
+    size_t low = 0;
+    size_t high = len - 1;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (grid_energy[mid] <= energy) low = mid;
+        else high = mid;
+    }
+    interp_row(grid, low, energy, xs);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_union_grid(const union_grid_t* grid, float energy, float* xs) {
+    cendfStatus status;
+    if (interp_union_grid_status(grid, energy, xs, &status)) return true;
+    if (status == CENDF_STATUS_INVALID)
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_union_grid");
+    else
+        errno = ERANGE;
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_union_grid_batch(const union_grid_t* grid, const float* energies, float* xs,
+                             size_t n) {
+    if (!grid || !energies || !xs) {
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_union_grid_batch");
+        return false;
+    }
+    const float* grid_energy = grid->energy;
+    const size_t len = grid->len;
+    const size_t num_reactions = grid->num_reactions;
+    bool inside_all = true;
+    for (size_t i = 0; i < n; i += UNION_GRID_GROUP) {
+        const size_t count = n - i < UNION_GRID_GROUP ? n - i : UNION_GRID_GROUP;
+        size_t base[UNION_GRID_GROUP];
+        for (size_t lane = 0; lane < count; lane++) base[lane] = 0;
+        // Branchless searches for the last point at or below each energy,
+        // which share their step count and so advance together
+        for (size_t span = len; span > 1; span -= span / 2) {
+            const size_t half = span / 2;
+            for (size_t lane = 0; lane < count; lane++)
+                base[lane] += (grid_energy[base[lane] + half] <= energies[i + lane]) ? half : 0;
+        }
+        for (size_t lane = 0; lane < count; lane++) {
+            const float energy = energies[i + lane];
+            float* row = xs + (i + lane) * num_reactions;
+            if (!(energy >= grid_energy[0] && energy <= grid_energy[len - 1])) {
+                for (size_t r = 0; r < num_reactions; r++) row[r] = -1.0f;
+                inside_all = false;
+                continue;
+            }
+            // The last interval starts at len - 2, as for the scalar search
+            const size_t low = len > 1 && base[lane] > len - 2 ? len - 2 : base[lane];
+            interp_row(grid, low, energy, row);
+        }
+    }
+    if (!inside_all) {
+        errno = ERANGE;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t union_grid_size(const union_grid_t* grid) {
+    if (!grid) {
+        errno = EINVAL;
+        return 0;
+    }
+    return grid->len;
+}
+// --------------------------------------------------------------------------------
+
+size_t union_grid_reactions(const union_grid_t* grid) {
+    if (!grid) {
+        errno = EINVAL;
+        return 0;
+    }
+    return grid->num_reactions;
+}
+// --------------------------------------------------------------------------------
+
+const float* get_union_energy(const union_grid_t* grid) {
+    if (!grid) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return grid->energy;
+}
+// --------------------------------------------------------------------------------
+
+const float* get_union_values(const union_grid_t* grid, size_t index) {
+    if (!grid || index >= grid->len) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return grid->values + index * grid->num_reactions;
+}
+// --------------------------------------------------------------------------------
+
+void free_union_grid(union_grid_t* grid) {
+    if (!grid) return;
+    free(grid->energy);
+    free(grid->values);
+    free(grid);
+}
+// --------------------------------------------------------------------------------
+
+void _free_union_grid(union_grid_t** grid) {
+    if (grid && *grid) {
+        free_union_grid(*grid);
+        *grid = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// DOUBLE-INDEXED GLOBAL GRID
+
+// Index of a global energy that lies outside of a material grid
+#define GLOBAL_GRID_OUTSIDE UINT32_MAX
+
+struct global_grid_t {
+    float* energy;
+    uint32_t* index;    // len rows of num_grids material grid points
+    size_t len;
+    const union_grid_t** grids;
+    size_t* offset;
+    size_t num_grids;
+    size_t num_values;
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * Merges the distinct energies of every material grid.  With `energy` NULL
+ * the energies are only counted.
+ */
+static size_t merge_global_energy(const union_grid_t* const* grids, size_t num_grids,
+                                  size_t* cursor, float* energy) {
+    memset(cursor, 0, num_grids * sizeof(size_t));
+    size_t len = 0;
+    for (;;) {
+        bool found = false;
+        float next = 0.0f;
+        for (size_t m = 0; m < num_grids; m++) {
+            if (cursor[m] < grids[m]->len && (!found || grids[m]->energy[cursor[m]] < next)) {
+                next = grids[m]->energy[cursor[m]];
+                found = true;
+            }
+        }
+        if (!found) return len;
+        for (size_t m = 0; m < num_grids; m++) {
+            while (cursor[m] < grids[m]->len && grids[m]->energy[cursor[m]] == next)
+                cursor[m]++;
+        }
+        if (energy) energy[len] = next;
+        len++;
+    }
+}
+// --------------------------------------------------------------------------------
+
+global_grid_t* init_global_grid(const union_grid_t* const* grids, size_t num_grids) {
+    if (!grids || num_grids == 0) {
+        CENDF_REPORT(EINVAL, "Invalid grids passed to init_global_grid");
+        return NULL;
+    }
+    for (size_t m = 0; m < num_grids; m++) {
+        if (!grids[m] || grids[m]->len >= GLOBAL_GRID_OUTSIDE) {
+            CENDF_REPORT(EINVAL, "Invalid grid %zu passed to init_global_grid", m);
+            return NULL;
+        }
+    }
+
+    global_grid_t* grid = calloc(1, sizeof(global_grid_t));
+    size_t* cursor = malloc(num_grids * sizeof(size_t));
+    bool ok = grid && cursor;
+    if (ok) {
+        grid->len = merge_global_energy(grids, num_grids, cursor, NULL);
+        grid->energy = malloc(grid->len * sizeof(float));
+        grid->index = malloc(grid->len * num_grids * sizeof(uint32_t));
+        grid->grids = malloc(num_grids * sizeof(union_grid_t*));
+        grid->offset = malloc(num_grids * sizeof(size_t));
+        ok = grid->energy && grid->index && grid->grids && grid->offset;
+    }
+    if (!ok) {
+        free(cursor);
+        free_global_grid(grid);
+        CENDF_REPORT(ENOMEM, "global_grid_t allocation failed with error %s", strerror(ENOMEM));
+        return NULL;
+    }
+    merge_global_energy(grids, num_grids, cursor, grid->energy);
+
+    grid->num_grids = num_grids;
+    for (size_t m = 0; m < num_grids; m++) {
+        grid->grids[m] = grids[m];
+        grid->offset[m] = grid->num_values;
+        grid->num_values += grids[m]->num_reactions;
+
+        // Each global energy maps to the last point of the material grid at or
+        // below it, which is the upper copy of a repeated edge energy
+        const float* energy = grids[m]->energy;
+        const size_t len = grids[m]->len;
+        size_t point = 0;
+        for (size_t k = 0; k < grid->len; k++) {
+            const float e = grid->energy[k];
+            while (point + 1 < len && energy[point + 1] <= e) point++;
+            const bool outside = e < energy[0] || e > energy[len - 1];
+            grid->index[k * num_grids + m] = outside ? GLOBAL_GRID_OUTSIDE : (uint32_t)point;
+        }
+    }
+    free(cursor);
+    return grid;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_global_grid_status(const global_grid_t* grid, float energy, float* xs,
+                               cendfStatus* status) {
+    if (!grid || !xs) {
+        cendf_set_status(status, CENDF_STATUS_INVALID);
+        return false;
+    }
+    const float* global_energy = grid->energy;
+    const size_t len = grid->len;
+    if (!(energy >= global_energy[0] && energy <= global_energy[len - 1])) {
+        cendf_set_status(status, CENDF_STATUS_RANGE);
+        return false;
+    }
+    cendf_set_status(status, CENDF_STATUS_OK);
+
+    // One search on the global grid locates the energy in every material grid
+    size_t low = 0;
+    size_t high = len;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (global_energy[mid] <= energy) low = mid;
+        else high = mid;
+    }
+    const uint32_t* index = grid->index + low * grid->num_grids;
+    for (size_t m = 0; m < grid->num_grids; m++) {
+        const union_grid_t* material = grid->grids[m];
+        float* values = xs + grid->offset[m];
+        // Between the last energy of a material and the next global energy
+        // the material is outside of its grid as well
+        if (index[m] == GLOBAL_GRID_OUTSIDE ||
+            (index[m] + 1 == material->len && energy > material->energy[index[m]]))
+            memset(values, 0, material->num_reactions * sizeof(float));
+        else
+            interp_row(material, index[m], energy, values);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool interp_global_grid(const global_grid_t* grid, float energy, float* xs) {
+    cendfStatus status;
+    if (interp_global_grid_status(grid, energy, xs, &status)) return true;
+    if (status == CENDF_STATUS_INVALID)
+        CENDF_REPORT(EINVAL, "Null pointer passed to interp_global_grid");
+    else
+        errno = ERANGE;
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+size_t global_grid_size(const global_grid_t* grid) {
+    if (!grid) {
+        errno = EINVAL;
+        return 0;
+    }
+    return grid->len;
+}
+// --------------------------------------------------------------------------------
+
+size_t global_grid_materials(const global_grid_t* grid) {
+    if (!grid) {
+        errno = EINVAL;
+        return 0;
+    }
+    return grid->num_grids;
+}
+// --------------------------------------------------------------------------------
+
+size_t global_grid_values(const global_grid_t* grid) {
+    if (!grid) {
+        errno = EINVAL;
+        return 0;
+    }
+    return grid->num_values;
+}
+// --------------------------------------------------------------------------------
+
+size_t global_grid_offset(const global_grid_t* grid, size_t material) {
+    if (!grid || material >= grid->num_grids) {
+        errno = EINVAL;
+        return 0;
+    }
+    return grid->offset[material];
+}
+// --------------------------------------------------------------------------------
+
+void free_global_grid(global_grid_t* grid) {
+    if (!grid) return;
+    free(grid->energy);
+    free(grid->index);
+    free(grid->grids);
+    free(grid->offset);
+    free(grid);
+}
+// --------------------------------------------------------------------------------
+
+void _free_global_grid(global_grid_t** grid) {
+    if (grid && *grid) {
+        free_global_grid(*grid);
+        *grid = NULL;
+    }
+}
+// ================================================================================
+// ================================================================================
+// eof
@@ -0,0 +1,60 @@
+// ================================================================================
+// ================================================================================
+// - File:    xsec_precision.c
+// - Purpose: Cross section tables in single, double and mixed precision
+//
+// Source Metadata
+// - Author:  Jonathan A. Webb
+// - Date:    December 17, 2024
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jon Webb Inc.
+// ================================================================================
+// ================================================================================
+// Include modules here
+
+#include "include/xsec_precision.h"
+#include "interp_laws.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ================================================================================
+// ================================================================================
+// XSEC_F32_T DATA TYPE
+
+#define XSEC_NAME xsec_f32
+#define XSEC_ENERGY_T float
+#define XSEC_VALUE_T float
+#define XSEC_REAL_T float
+#define XSEC_LOG logf
+#define XSEC_EXP expf
+#include "xsec_template.inc"
+// ================================================================================
+// ================================================================================
+// XSEC_F64_T DATA TYPE
+
+#define XSEC_NAME xsec_f64
+#define XSEC_ENERGY_T double
+#define XSEC_VALUE_T double
+#define XSEC_REAL_T double
+#define XSEC_LOG log
+#define XSEC_EXP exp
+#include "xsec_template.inc"
+// ================================================================================
+// ================================================================================
+// XSEC_MIXED_T DATA TYPE
+
+// The values are widened to double, so the interpolation weight keeps the
+// precision of the energies
+#define XSEC_NAME xsec_mixed
+#define XSEC_ENERGY_T double
+#define XSEC_VALUE_T float
+#define XSEC_REAL_T double
+#define XSEC_LOG log
+#define XSEC_EXP exp
+#include "xsec_template.inc"
+// ================================================================================
+// ================================================================================
+// eof